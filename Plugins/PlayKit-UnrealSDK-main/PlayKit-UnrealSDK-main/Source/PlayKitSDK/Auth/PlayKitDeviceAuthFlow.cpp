@@ -1,6 +1,7 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitDeviceAuthFlow.h"
+#include "PlayKitLog.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
@@ -82,7 +83,7 @@ void UPlayKitDeviceAuthFlow::StartAuthFlow(const FString& InGameId, const FStrin
 {
 	if (IsActive())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[DeviceAuth] Auth flow already in progress"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[DeviceAuth] Auth flow already in progress"));
 		return;
 	}
 
@@ -94,9 +95,9 @@ void UPlayKitDeviceAuthFlow::StartAuthFlow(const FString& InGameId, const FStrin
 	CodeVerifier = GenerateCodeVerifier();
 	CodeChallenge = GenerateCodeChallenge(CodeVerifier);
 
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Starting auth flow for GameId: %s"), *GameId);
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Code Verifier: %s"), *CodeVerifier);
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Code Challenge: %s"), *CodeChallenge);
+	UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Starting auth flow for GameId: %s"), *GameId);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Code Verifier: %s"), *CodeVerifier);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Code Challenge: %s"), *CodeChallenge);
 
 	// Get world reference for timers
 	if (GEngine && GEngine->GameViewport)
@@ -115,7 +116,7 @@ void UPlayKitDeviceAuthFlow::CancelAuthFlow()
 		return;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Auth flow cancelled by user"));
+	UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Auth flow cancelled by user"));
 	Cleanup();
 	SetStatus(EDeviceAuthStatus::Cancelled);
 }
@@ -182,7 +183,7 @@ void UPlayKitDeviceAuthFlow::RequestDeviceCode()
 	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
 	CurrentHttpRequest->SetContentAsString(JsonString);
 
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Requesting device code from: %s"), *Url);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Requesting device code from: %s"), *Url);
 
 	CurrentHttpRequest->OnProcessRequestComplete().BindUObject(
 		this, &UPlayKitDeviceAuthFlow::HandleDeviceCodeResponse);
@@ -198,7 +199,7 @@ void UPlayKitDeviceAuthFlow::HandleDeviceCodeResponse(FHttpRequestPtr Request, F
 	}
 
 	const int32 ResponseCode = Response->GetResponseCode();
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Device code response: HTTP %d"), ResponseCode);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Device code response: HTTP %d"), ResponseCode);
 
 	if (ResponseCode != 200)
 	{
@@ -228,7 +229,7 @@ void UPlayKitDeviceAuthFlow::HandleDeviceCodeResponse(FHttpRequestPtr Request, F
 		return;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Device code received. User code: %s, Auth URL: %s"), *UserCode, *AuthUrl);
+	UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Device code received. User code: %s, Auth URL: %s"), *UserCode, *AuthUrl);
 
 	// Notify that auth URL is ready
 	OnAuthUrlReady.Broadcast(AuthUrl, UserCode);
@@ -262,7 +263,7 @@ void UPlayKitDeviceAuthFlow::StartPolling()
 		ExpirationTimerHandle,
 		[this]()
 		{
-			UE_LOG(LogTemp, Warning, TEXT("[DeviceAuth] Device code expired"));
+			UE_LOG(LogPlayKit, Warning, TEXT("[DeviceAuth] Device code expired"));
 			Cleanup();
 			SetStatus(EDeviceAuthStatus::Expired);
 			OnAuthError.Broadcast(TEXT("EXPIRED"), TEXT("Device code expired. Please start again."));
@@ -283,7 +284,7 @@ void UPlayKitDeviceAuthFlow::StartPolling()
 		static_cast<float>(PollingInterval) // Initial delay
 	);
 
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Started polling every %d seconds, expires in %d seconds"), PollingInterval, ExpiresIn);
+	UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Started polling every %d seconds, expires in %d seconds"), PollingInterval, ExpiresIn);
 }
 
 void UPlayKitDeviceAuthFlow::PollForToken()
@@ -321,19 +322,19 @@ void UPlayKitDeviceAuthFlow::HandleTokenResponse(FHttpRequestPtr Request, FHttpR
 {
 	if (!bWasSuccessful || !Response.IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[DeviceAuth] Token poll failed - network error, will retry"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[DeviceAuth] Token poll failed - network error, will retry"));
 		return; // Continue polling
 	}
 
 	const int32 ResponseCode = Response->GetResponseCode();
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Token response: HTTP %d"), ResponseCode);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Token response: HTTP %d"), ResponseCode);
 
 	// Parse response
 	TSharedPtr<FJsonObject> JsonObject;
 	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
 	if (!FJsonSerializer::Deserialize(Reader, JsonObject))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[DeviceAuth] Failed to parse token response"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[DeviceAuth] Failed to parse token response"));
 		return; // Continue polling
 	}
 
@@ -349,7 +350,7 @@ void UPlayKitDeviceAuthFlow::HandleTokenResponse(FHttpRequestPtr Request, FHttpR
 			return;
 		}
 
-		UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Access token received, exchanging for player token"));
+		UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Access token received, exchanging for player token"));
 
 		// Exchange for player token
 		ExchangeForPlayerToken(AccessToken);
@@ -364,14 +365,14 @@ void UPlayKitDeviceAuthFlow::HandleTokenResponse(FHttpRequestPtr Request, FHttpR
 		if (Error == TEXT("authorization_pending"))
 		{
 			// User hasn't authorized yet - continue polling
-			UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Authorization pending, continuing to poll"));
+			UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Authorization pending, continuing to poll"));
 			return;
 		}
 		else if (Error == TEXT("slow_down"))
 		{
 			// Slow down polling
 			PollingInterval += 5;
-			UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Slowing down polling to %d seconds"), PollingInterval);
+			UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Slowing down polling to %d seconds"), PollingInterval);
 			return;
 		}
 		else if (Error == TEXT("expired_token"))
@@ -432,7 +433,7 @@ void UPlayKitDeviceAuthFlow::HandlePlayerTokenResponse(FHttpRequestPtr Request,
 	}
 
 	const int32 ResponseCode = Response->GetResponseCode();
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Player token response: HTTP %d"), ResponseCode);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[DeviceAuth] Player token response: HTTP %d"), ResponseCode);
 
 	if (ResponseCode != 200)
 	{
@@ -473,7 +474,7 @@ void UPlayKitDeviceAuthFlow::SetStatus(EDeviceAuthStatus NewStatus)
 
 void UPlayKitDeviceAuthFlow::CompleteWithError(const FString& ErrorCode, const FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Error, TEXT("[DeviceAuth] Error: %s - %s"), *ErrorCode, *ErrorMessage);
+	UE_LOG(LogPlayKit, Error, TEXT("[DeviceAuth] Error: %s - %s"), *ErrorCode, *ErrorMessage);
 	Cleanup();
 	SetStatus(EDeviceAuthStatus::Error);
 	OnAuthError.Broadcast(ErrorCode, ErrorMessage);
@@ -481,7 +482,7 @@ void UPlayKitDeviceAuthFlow::CompleteWithError(const FString& ErrorCode, const F
 
 void UPlayKitDeviceAuthFlow::CompleteWithSuccess(const FDeviceAuthResult& Result)
 {
-	UE_LOG(LogTemp, Log, TEXT("[DeviceAuth] Authorization successful! UserId: %s"), *Result.UserId);
+	UE_LOG(LogPlayKit, Log, TEXT("[DeviceAuth] Authorization successful! UserId: %s"), *Result.UserId);
 	Cleanup();
 	SetStatus(EDeviceAuthStatus::Success);
 	OnAuthSuccess.Broadcast(Result);
@@ -0,0 +1,931 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitBenchmarks.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "PlayKitLog.h"
+#include "Client/PlayKitChatClient.h"
+#include "Client/PlayKitImageClient.h"
+#include "NPC/PlayKitNPCClient.h"
+#include "NPC/PlayKitNPCActionsModule.h"
+#include "NPC/PlayKitMemoryIndex.h"
+#include "NPC/PlayKitPredictionTrailer.h"
+#include "Tool/PlayKitSSEDecoder.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTLS.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/App.h"
+#include "Misc/Base64.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+
+namespace
+{
+	const int32 ResultsVersion = 1;
+
+	/** Timed samples per case; the median is reported */
+	const int32 SampleCount = 7;
+
+	/** Target duration of one sample */
+	const double TargetSampleSeconds = 0.02;
+
+	const int64 MaxBatch = 1 << 20;
+
+	/** Results are summed in here so the optimizer cannot drop the work */
+	volatile int64 GBenchSink = 0;
+
+	/**
+	 * Allocator proxy that counts the allocations of one thread and forwards everything to the real allocator.
+	 * Installed into GMalloc once at startup (FPlayKitBenchmarks::InstallAllocationCounter) and never removed.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		void Begin(uint32 InThreadId)
+		{
+			Allocations = 0;
+			Bytes = 0;
+			ThreadId.store(InThreadId, std::memory_order_relaxed);
+			bCounting.store(true, std::memory_order_release);
+		}
+
+		void End()
+		{
+			bCounting.store(false, std::memory_order_release);
+		}
+
+		int64 GetAllocations() const { return Allocations; }
+		int64 GetBytes() const { return Bytes; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Note(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Note(Count);
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Note(Count);
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Note(Count);
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void Note(SIZE_T Count)
+		{
+			// Only the benchmark thread touches the counters
+			if (Count > 0 && bCounting.load(std::memory_order_acquire)
+				&& FPlatformTLS::GetCurrentThreadId() == ThreadId.load(std::memory_order_relaxed))
+			{
+				++Allocations;
+				Bytes += Count;
+			}
+		}
+
+		FMalloc* Inner;
+		std::atomic<uint32> ThreadId{ 0 };
+		std::atomic<bool> bCounting{ false };
+		int64 Allocations = 0;
+		int64 Bytes = 0;
+	};
+
+	/** The installed proxy, if allocations can be counted on this build */
+	FCountingMalloc* GAllocationCounter = nullptr;
+
+	/** Counts the calling thread's allocations for the rest of the scope, when a working counter is installed */
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter()
+			: Counter(GAllocationCounter)
+		{
+			if (Counter)
+			{
+				Counter->Begin(FPlatformTLS::GetCurrentThreadId());
+			}
+		}
+
+		~FScopedAllocationCounter()
+		{
+			if (Counter)
+			{
+				Counter->End();
+			}
+		}
+
+		bool IsActive() const { return Counter != nullptr; }
+		int64 GetAllocations() const { return Counter ? Counter->GetAllocations() : 0; }
+		int64 GetBytes() const { return Counter ? Counter->GetBytes() : 0; }
+
+	private:
+		FCountingMalloc* Counter = nullptr;
+	};
+
+	/** Deterministic filler text, so every run and every machine benchmarks the same bytes */
+	FString MakeText(int32 Words, int32 Seed)
+	{
+		static const TCHAR* const Vocabulary[] = {
+			TEXT("the"), TEXT("fox"), TEXT("quietly"), TEXT("wanders"), TEXT("past"), TEXT("a"), TEXT("lantern"),
+			TEXT("while"), TEXT("rain"), TEXT("taps"), TEXT("on"), TEXT("old"), TEXT("stone,"), TEXT("\"hello\""),
+			TEXT("she"), TEXT("said."), TEXT("Then"), TEXT("nothing"), TEXT("happened"), TEXT("for"), TEXT("hours.")
+		};
+
+		FString Text;
+		Text.Reserve(Words * 8);
+		for (int32 Index = 0; Index < Words; ++Index)
+		{
+			if (Index > 0)
+			{
+				Text.AppendChar(TEXT(' '));
+			}
+			Text += Vocabulary[(Index * 7 + Seed * 13) % UE_ARRAY_COUNT(Vocabulary)];
+		}
+		return Text;
+	}
+
+	void AppendUtf8(TArray<uint8>& Out, const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text, Text.Len());
+		Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	/** Silences LogPlayKit below warnings for the rest of the scope, for setup code that logs per item */
+	class FScopedQuietLog
+	{
+	public:
+		FScopedQuietLog()
+			: Previous(LogPlayKit.GetVerbosity())
+		{
+			LogPlayKit.SetVerbosity(ELogVerbosity::Warning);
+		}
+
+		~FScopedQuietLog()
+		{
+			LogPlayKit.SetVerbosity(Previous);
+		}
+
+	private:
+		ELogVerbosity::Type Previous;
+	};
+}
+
+struct FPlayKitBenchmarks::FCase
+{
+	FString Name;
+
+	/** One operation. Returns something derived from the result so it is not optimized away */
+	TFunction<int64()> Op;
+};
+
+//========== Cases ==========//
+
+void FPlayKitBenchmarks::AddSSECases(TArray<FCase>& Cases)
+{
+	for (const int32 Tokens : { 1000, 10000, 50000 })
+	{
+		// One text-delta event per token, in the UI message stream format
+		TSharedRef<TArray<uint8>> Stream = MakeShared<TArray<uint8>>();
+		for (int32 Index = 0; Index < Tokens; ++Index)
+		{
+			FPlayKitJsonWriter Json(96);
+			Json.BeginObject();
+			Json.WriteStringField("type", TEXT("text-delta"));
+			Json.WriteStringField("id", TEXT("0"));
+			Json.WriteStringField("delta", MakeText(1, Index) + TEXT(" "));
+			Json.EndObject();
+
+			AppendUtf8(*Stream, TEXT("data: "));
+			Stream->Append(Json.GetBuffer());
+			AppendUtf8(*Stream, TEXT("\n\n"));
+		}
+		AppendUtf8(*Stream, TEXT("data: [DONE]\n\n"));
+
+		// Replays the stream the way HTTP progress delivers it: a growing body, 1 KB more per tick,
+		// with events cut mid-line
+		Cases.Add({ FString::Printf(TEXT("SSE/Decode/%dTokens"), Tokens), [Stream]()
+		{
+			const int32 TickBytes = 1024;
+			FPlayKitSSEDecoder Decoder;
+			TArray<uint8> Body;
+			Body.Reserve(Stream->Num());
+			TArray<FPlayKitSSEEvent> Events;
+			FString Content;
+
+			for (int32 Offset = 0; Offset < Stream->Num(); Offset += TickBytes)
+			{
+				Body.Append(Stream->GetData() + Offset, FMath::Min(TickBytes, Stream->Num() - Offset));
+
+				Events.Reset();
+				Decoder.ConsumeResponse(Body, Events);
+				for (const FPlayKitSSEEvent& Event : Events)
+				{
+					if (Event.IsDone())
+					{
+						continue;
+					}
+
+					const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Event.Data);
+					if (Root.Find("type").StringEquals("text-delta"))
+					{
+						Content += Root.Find("delta").AsString();
+					}
+				}
+			}
+			return static_cast<int64>(Content.Len());
+		} });
+	}
+}
+
+void FPlayKitBenchmarks::AddChatBodyCases(TArray<FCase>& Cases)
+{
+	TSharedRef<TStrongObjectPtr<UPlayKitChatClient>> Client = MakeShared<TStrongObjectPtr<UPlayKitChatClient>>(NewObject<UPlayKitChatClient>(GetTransientPackage()));
+	(*Client)->SetModelName(TEXT("bench-model"));
+
+	for (const int32 Messages : { 10, 100, 500 })
+	{
+		TSharedRef<FPlayKitChatConfig> Config = MakeShared<FPlayKitChatConfig>();
+		Config->MaxTokens = 512;
+		for (int32 Index = 0; Index < Messages; ++Index)
+		{
+			FPlayKitChatMessage& Message = Config->Messages.AddDefaulted_GetRef();
+			Message.Role = Index == 0 ? TEXT("system") : (Index % 2) ? TEXT("user") : TEXT("assistant");
+			Message.Content = MakeText(Index == 0 ? 120 : 20 + Index % 60, Index);
+		}
+
+		Cases.Add({ FString::Printf(TEXT("Chat/BuildBody/%dMessages"), Messages), [Client, Config]()
+		{
+			return static_cast<int64>((*Client)->BuildChatBody(*Config, true).Num());
+		} });
+	}
+}
+
+void FPlayKitBenchmarks::AddActionCallCases(TArray<FCase>& Cases)
+{
+	TSharedRef<TStrongObjectPtr<UPlayKitNPCClient>> Client = MakeShared<TStrongObjectPtr<UPlayKitNPCClient>>(NewObject<UPlayKitNPCClient>(GetTransientPackage()));
+
+	for (const int32 Calls : { 4, 32, 128 })
+	{
+		// An assistant message as it appears in a chat completion, arguments encoded as a JSON string
+		FPlayKitJsonWriter Json(Calls * 256);
+		Json.BeginObject();
+		Json.WriteStringField("role", TEXT("assistant"));
+		Json.WriteKey("content");
+		Json.WriteNull();
+		Json.WriteKey("tool_calls");
+		Json.BeginArray();
+		for (int32 Index = 0; Index < Calls; ++Index)
+		{
+			FPlayKitJsonWriter Arguments(128);
+			Arguments.BeginObject();
+			Arguments.WriteStringField("target", MakeText(2, Index));
+			Arguments.WriteIntField("amount", Index * 3);
+			Arguments.WriteBoolField("urgent", Index % 2 == 0);
+			Arguments.WriteStringField("reason", MakeText(8, Index + 1));
+			Arguments.EndObject();
+
+			Json.BeginObject();
+			Json.WriteStringField("id", FString::Printf(TEXT("call_%08d"), Index));
+			Json.WriteStringField("type", TEXT("function"));
+			Json.WriteKey("function");
+			Json.BeginObject();
+			Json.WriteStringField("name", FString::Printf(TEXT("action_%d"), Index % 16));
+			Json.WriteStringField("arguments", Arguments.ToString());
+			Json.EndObject();
+			Json.EndObject();
+		}
+		Json.EndArray();
+		Json.EndObject();
+
+		TSharedRef<TArray<uint8>> Message = MakeShared<TArray<uint8>>(Json.Finish());
+
+		Cases.Add({ FString::Printf(TEXT("NPC/ParseActionCalls/%dCalls"), Calls), [Client, Message]()
+		{
+			TArray<FNPCActionCall> ActionCalls;
+			(*Client)->ParseActionCalls(FPlayKitJsonView::Parse(*Message), ActionCalls);
+			return static_cast<int64>(ActionCalls.Num());
+		} });
+	}
+}
+
+void FPlayKitBenchmarks::AddPredictionCases(TArray<FCase>& Cases)
+{
+	TSharedRef<TStrongObjectPtr<UPlayKitNPCClient>> Client = MakeShared<TStrongObjectPtr<UPlayKitNPCClient>>(NewObject<UPlayKitNPCClient>(GetTransientPackage()));
+
+	for (const int32 Predictions : { 3, 6 })
+	{
+		// Models like to wrap the array in prose
+		FString Response = TEXT("Here are some things the player might say next:\n[");
+		for (int32 Index = 0; Index < Predictions; ++Index)
+		{
+			Response += Index > 0 ? TEXT(", \"") : TEXT("\"");
+			Response += MakeText(12, Index).Replace(TEXT("\""), TEXT("\\\""));
+			Response += TEXT("\"");
+		}
+		Response += TEXT("]\nLet me know if you need more.");
+
+		Cases.Add({ FString::Printf(TEXT("NPC/ParsePredictions/%d"), Predictions), [Client, Response]()
+		{
+			return static_cast<int64>((*Client)->ParsePredictionsFromJson(Response).Num());
+		} });
+	}
+
+	// A streamed reply ending in a predictions trailer, a few characters per delta
+	FString Streamed = MakeText(60, 5) + TEXT("\n<predictions>[");
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		Streamed += Index > 0 ? TEXT(", \"") : TEXT("\"");
+		Streamed += MakeText(12, Index).Replace(TEXT("\""), TEXT("\\\""));
+		Streamed += TEXT("\"");
+	}
+	Streamed += TEXT("]");
+
+	TSharedRef<TArray<FString>> Deltas = MakeShared<TArray<FString>>();
+	for (int32 Pos = 0; Pos < Streamed.Len(); Pos += 6)
+	{
+		Deltas->Add(Streamed.Mid(Pos, 6));
+	}
+
+	Cases.Add({ TEXT("NPC/PredictionTrailer/3"), [Deltas]()
+	{
+		FPlayKitPredictionTrailer Trailer;
+		int64 Shown = 0;
+		for (const FString& Delta : *Deltas)
+		{
+			Shown += Trailer.Append(Delta).Len();
+		}
+		Shown += Trailer.Finish().Len();
+		return Shown + Trailer.GetPredictions().Num();
+	} });
+}
+
+void FPlayKitBenchmarks::AddImageCases(TArray<FCase>& Cases)
+{
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+
+	for (const int32 Size : { 256, 1024 })
+	{
+		// A gradient with some noise, so the PNG does not compress to almost nothing
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(Size * Size);
+		for (int32 Y = 0; Y < Size; ++Y)
+		{
+			for (int32 X = 0; X < Size; ++X)
+			{
+				const uint8 Noise = static_cast<uint8>((X * 31 + Y * 17) ^ (X * Y));
+				Pixels[Y * Size + X] = FColor(X * 255 / Size, Y * 255 / Size, Noise, 255);
+			}
+		}
+
+		TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		if (!Wrapper.IsValid() || !Wrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Size, Size, ERGBFormat::BGRA, 8))
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[Bench] Could not encode a %dx%d PNG, skipping image cases"), Size, Size);
+			continue;
+		}
+
+		const TArray64<uint8> Png = Wrapper->GetCompressed();
+		const FString Base64 = FBase64::Encode(Png.GetData(), Png.Num());
+
+		// Each op creates a transient texture; they are left to the garbage collector
+		Cases.Add({ FString::Printf(TEXT("Image/Base64ToTexture2D/%dx%d"), Size, Size), [Base64]()
+		{
+			UTexture2D* Texture = UPlayKitImageClient::Base64ToTexture2D(Base64);
+			return static_cast<int64>(Texture ? Texture->GetSizeX() : 0);
+		} });
+	}
+}
+
+void FPlayKitBenchmarks::AddActionSchemaCases(TArray<FCase>& Cases)
+{
+	for (const int32 Actions : { 50, 200, 500 })
+	{
+		TSharedRef<TStrongObjectPtr<UPlayKitNPCActionsModule>> Module = MakeShared<TStrongObjectPtr<UPlayKitNPCActionsModule>>(NewObject<UPlayKitNPCActionsModule>(GetTransientPackage()));
+
+		{
+			FScopedQuietLog QuietLog;
+			for (int32 Index = 0; Index < Actions; ++Index)
+			{
+				FNPCAction Action;
+				Action.SetName(FString::Printf(TEXT("action_%d"), Index))
+					.SetDescription(MakeText(16, Index))
+					.AddStringParam(TEXT("target"), MakeText(6, Index + 1))
+					.AddNumberParam(TEXT("amount"), MakeText(4, Index + 2), false)
+					.AddEnumParam(TEXT("mood"), MakeText(4, Index + 3), { TEXT("calm"), TEXT("angry"), TEXT("happy"), TEXT("sad") });
+				(*Module)->RegisterAction(Action, FOnActionExecute());
+			}
+		}
+
+		Cases.Add({ FString::Printf(TEXT("NPC/ActionsJsonSchema/%dActions"), Actions), [Module]()
+		{
+			return static_cast<int64>((*Module)->GetActionsAsJsonSchema().Len());
+		} });
+	}
+}
+
+void FPlayKitBenchmarks::AddActionArgsCases(TArray<FCase>& Cases)
+{
+	TSharedRef<TStrongObjectPtr<UPlayKitNPCActionsModule>> Module = MakeShared<TStrongObjectPtr<UPlayKitNPCActionsModule>>(NewObject<UPlayKitNPCActionsModule>(GetTransientPackage()));
+	{
+		FScopedQuietLog QuietLog;
+		FNPCAction Action;
+		Action.SetName(TEXT("give_treat"))
+			.AddStringParam(TEXT("target"), TEXT("Who gets the treat"))
+			.AddNumberParam(TEXT("amount"), TEXT("How many"))
+			.AddBoolParam(TEXT("urgent"), TEXT("Hurry"), false)
+			.AddEnumParam(TEXT("mood"), TEXT("Mood afterwards"), { TEXT("calm"), TEXT("angry"), TEXT("happy"), TEXT("sad") });
+		(*Module)->RegisterAction(Action, FOnActionExecute());
+	}
+
+	// As the NPC client hands them over: every argument as text
+	TSharedRef<FNPCActionCallArgs> Raw = MakeShared<FNPCActionCallArgs>();
+	Raw->ActionName = TEXT("give_treat");
+	Raw->CallId = TEXT("call_00000001");
+	Raw->RawParameters.Add(TEXT("target"), MakeText(2, 3));
+	Raw->RawParameters.Add(TEXT("amount"), TEXT("12.5"));
+	Raw->RawParameters.Add(TEXT("urgent"), TEXT("true"));
+	Raw->RawParameters.Add(TEXT("mood"), TEXT("Happy"));
+
+	TSharedRef<FNPCActionCallArgs> Prepared = MakeShared<FNPCActionCallArgs>(*Raw);
+	FString Error;
+	(*Module)->PrepareActionArgs(*Prepared, Error);
+
+	Cases.Add({ TEXT("NPC/PrepareActionArgs/4Params"), [Module, Raw]()
+	{
+		FNPCActionCallArgs Args = *Raw;
+		FString Error;
+		return static_cast<int64>((*Module)->PrepareActionArgs(Args, Error));
+	} });
+
+	// A handler reading its arguments every frame for a second at 60 fps
+	auto ReadFrames = [](const FNPCActionCallArgs& Args)
+	{
+		int64 Sum = 0;
+		for (int32 Frame = 0; Frame < 60; ++Frame)
+		{
+			Sum += Args.GetInt(TEXT("amount")) + static_cast<int64>(Args.GetNumber(TEXT("amount")))
+				+ (Args.GetBool(TEXT("urgent")) ? 1 : 0) + Args.GetString(TEXT("mood")).Len();
+		}
+		return Sum;
+	};
+
+	Cases.Add({ TEXT("NPC/ReadActionArgs/Raw/60Frames"), [Raw, ReadFrames]() { return ReadFrames(*Raw); } });
+	Cases.Add({ TEXT("NPC/ReadActionArgs/Typed/60Frames"), [Prepared, ReadFrames]() { return ReadFrames(*Prepared); } });
+}
+
+void FPlayKitBenchmarks::AddSaveCases(TArray<FCase>& Cases)
+{
+	// A room full of pets of a few species, each with a long-running conversation
+	const int32 Pets = 200;
+	const int32 Turns = 40;
+
+	TSharedRef<TArray<TStrongObjectPtr<UPlayKitNPCClient>>> Clients = MakeShared<TArray<TStrongObjectPtr<UPlayKitNPCClient>>>();
+	TSharedRef<TArray<UPlayKitNPCClient*>> NPCs = MakeShared<TArray<UPlayKitNPCClient*>>();
+	{
+		FScopedQuietLog QuietLog;
+		for (int32 Pet = 0; Pet < Pets; ++Pet)
+		{
+			UPlayKitNPCClient* NPC = NewObject<UPlayKitNPCClient>(GetTransientPackage());
+			NPC->SetCharacterDesign(MakeText(120, Pet % 4));
+			NPC->SetMemory(TEXT("Owner"), TEXT("The player"));
+			NPC->SetMemory(TEXT("Favorite food"), MakeText(3, Pet));
+			NPC->SetMemory(TEXT("Mood"), MakeText(6, Pet + 1));
+			for (int32 Turn = 0; Turn < Turns; ++Turn)
+			{
+				NPC->AppendChatMessage(TEXT("user"), MakeText(12, Pet + Turn));
+				NPC->AppendChatMessage(TEXT("assistant"), MakeText(30, Pet * 7 + Turn));
+			}
+			Clients->Emplace(NPC);
+			NPCs->Add(NPC);
+		}
+	}
+
+	TSharedRef<TArray<FString>> JsonSaves = MakeShared<TArray<FString>>();
+	for (UPlayKitNPCClient* NPC : *NPCs)
+	{
+		JsonSaves->Add(NPC->SaveHistory());
+	}
+	TSharedRef<TArray<uint8>> BinarySave = MakeShared<TArray<uint8>>(UPlayKitNPCClient::SaveHistories(*NPCs, false));
+	TSharedRef<TArray<uint8>> CompressedSave = MakeShared<TArray<uint8>>(UPlayKitNPCClient::SaveHistories(*NPCs, true));
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Save/Json/%dPets"), Pets), [Clients, NPCs]()
+	{
+		int64 Size = 0;
+		for (const UPlayKitNPCClient* NPC : *NPCs)
+		{
+			Size += NPC->SaveHistory().Len();
+		}
+		return Size;
+	} });
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Save/Binary/%dPets"), Pets), [Clients, NPCs]()
+	{
+		return static_cast<int64>(UPlayKitNPCClient::SaveHistories(*NPCs, false).Num());
+	} });
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Save/Compressed/%dPets"), Pets), [Clients, NPCs]()
+	{
+		return static_cast<int64>(UPlayKitNPCClient::SaveHistories(*NPCs, true).Num());
+	} });
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Load/Json/%dPets"), Pets), [Clients, NPCs, JsonSaves]()
+	{
+		int64 Loaded = 0;
+		for (int32 Index = 0; Index < NPCs->Num(); ++Index)
+		{
+			Loaded += (*NPCs)[Index]->LoadHistory((*JsonSaves)[Index]) ? 1 : 0;
+		}
+		return Loaded;
+	} });
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Load/Binary/%dPets"), Pets), [Clients, NPCs, BinarySave]()
+	{
+		return static_cast<int64>(UPlayKitNPCClient::LoadHistories(*NPCs, *BinarySave));
+	} });
+
+	Cases.Add({ FString::Printf(TEXT("NPC/Load/Compressed/%dPets"), Pets), [Clients, NPCs, CompressedSave]()
+	{
+		return static_cast<int64>(UPlayKitNPCClient::LoadHistories(*NPCs, *CompressedSave));
+	} });
+}
+
+void FPlayKitBenchmarks::AddMemoryCases(TArray<FCase>& Cases)
+{
+	// A long-lived pet: 200 memories, a few of them pinned
+	const int32 MemoryCount = 200;
+	TSharedRef<FPlayKitMemoryIndex> Index = MakeShared<FPlayKitMemoryIndex>();
+	for (int32 Memory = 0; Memory < MemoryCount; ++Memory)
+	{
+		const FString Name = FString::Printf(TEXT("Memory %d"), Memory);
+		Index->Set(Name, MakeText(8 + Memory % 24, Memory));
+		Index->SetPinned(Name, Memory % 50 == 0);
+	}
+
+	TSharedRef<FString> Message = MakeShared<FString>(MakeText(16, 7));
+	TSharedRef<TArray<FString>> Recent = MakeShared<TArray<FString>>();
+	for (int32 Turn = 0; Turn < 4; ++Turn)
+	{
+		Recent->Add(MakeText(30, Turn + 11));
+	}
+
+	Cases.Add({ FString::Printf(TEXT("NPC/SelectMemories/%d"), MemoryCount), [Index, Message, Recent]()
+	{
+		FPlayKitMemoryIndex::FQuery Query;
+		Query.AddText(*Message, 1.0f);
+		for (const FString& Text : *Recent)
+		{
+			Query.AddText(Text, 0.5f);
+		}
+
+		TArray<int32> Selected;
+		Index->Select(Query, 12, 600, Selected);
+		return static_cast<int64>(Selected.Num());
+	} });
+
+	TSharedRef<FString> Updated = MakeShared<FString>(MakeText(20, 3));
+	Cases.Add({ FString::Printf(TEXT("NPC/SetMemory/%d"), MemoryCount), [Index, Updated]()
+	{
+		Index->Set(TEXT("Memory 42"), *Updated);
+		return static_cast<int64>(Index->Num());
+	} });
+}
+
+//========== Running ==========//
+
+FPlayKitBenchmarks::FResult FPlayKitBenchmarks::Measure(const FCase& Case)
+{
+	FResult Result;
+	Result.Name = Case.Name;
+
+	auto TimeBatch = [&Case](int64 Batch)
+	{
+		const uint64 Start = FPlatformTime::Cycles64();
+		for (int64 Index = 0; Index < Batch; ++Index)
+		{
+			GBenchSink = GBenchSink + Case.Op();
+		}
+		return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start);
+	};
+
+	// Warm up caches and lazily created state
+	TimeBatch(1);
+
+	// Grow the batch until one sample is long enough to time reliably
+	int64 Batch = 1;
+	double Seconds = TimeBatch(Batch);
+	while (Seconds < TargetSampleSeconds && Batch < MaxBatch)
+	{
+		const double Scale = Seconds > 0.0 ? TargetSampleSeconds / Seconds : 10.0;
+		Batch = FMath::Min(MaxBatch, FMath::Max(Batch * 2, static_cast<int64>(Batch * Scale * 1.1)));
+		Seconds = TimeBatch(Batch);
+	}
+
+	TArray<double, TInlineAllocator<SampleCount>> Samples;
+	for (int32 Sample = 0; Sample < SampleCount; ++Sample)
+	{
+		Samples.Add(TimeBatch(Batch) / Batch);
+	}
+	Samples.Sort();
+	Result.NsPerOp = Samples[SampleCount / 2] * 1e9;
+	Result.Iterations = Batch * SampleCount;
+
+	// Counted in a separate run, so the counting itself stays out of the timings
+	{
+		const int64 CountedOps = FMath::Min<int64>(Batch, 64);
+		FScopedAllocationCounter Counter;
+		for (int64 Index = 0; Index < CountedOps; ++Index)
+		{
+			GBenchSink = GBenchSink + Case.Op();
+		}
+
+		if (Counter.IsActive())
+		{
+			Result.AllocsPerOp = static_cast<double>(Counter.GetAllocations()) / CountedOps;
+			Result.BytesPerOp = static_cast<double>(Counter.GetBytes()) / CountedOps;
+		}
+	}
+
+	return Result;
+}
+
+void FPlayKitBenchmarks::InstallAllocationCounter()
+{
+	if (GAllocationCounter || !FParse::Param(FCommandLine::Get(), TEXT("PlayKitBenchAllocs")))
+	{
+		return;
+	}
+
+	// Never removed or freed: other threads may be inside it at any time, and it only ever forwards
+	FCountingMalloc* Proxy = new FCountingMalloc(GMalloc);
+	GMalloc = Proxy;
+
+	// Some builds route FMemory straight to the platform allocator; then nothing reaches the proxy
+	Proxy->Begin(FPlatformTLS::GetCurrentThreadId());
+	void* Probe = FMemory::Malloc(64);
+	FMemory::Free(Probe);
+	Proxy->End();
+
+	if (Proxy->GetAllocations() > 0)
+	{
+		GAllocationCounter = Proxy;
+		UE_LOG(LogPlayKit, Log, TEXT("[Bench] Allocation counter installed"));
+	}
+	else
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[Bench] FMemory bypasses GMalloc on this build; allocations will not be counted"));
+	}
+}
+
+TArray<FPlayKitBenchmarks::FResult> FPlayKitBenchmarks::Run(const FString& Filter, FOutputDevice& Output)
+{
+	TArray<FCase> Cases;
+	AddSSECases(Cases);
+	AddChatBodyCases(Cases);
+	AddActionCallCases(Cases);
+	AddPredictionCases(Cases);
+	AddImageCases(Cases);
+	AddActionSchemaCases(Cases);
+	AddActionArgsCases(Cases);
+	AddSaveCases(Cases);
+	AddMemoryCases(Cases);
+
+	if (!GAllocationCounter)
+	{
+		Output.Logf(TEXT("[Bench] Allocations are not counted; start with -PlayKitBenchAllocs to count them"));
+	}
+
+	Output.Logf(TEXT("%-40s %12s %14s %12s %14s"), TEXT("Case"), TEXT("Iterations"), TEXT("ns/op"), TEXT("allocs/op"), TEXT("bytes/op"));
+
+	TArray<FResult> Results;
+	for (const FCase& Case : Cases)
+	{
+		if (!Filter.IsEmpty() && !Case.Name.Contains(Filter))
+		{
+			continue;
+		}
+
+		const FResult& Result = Results.Add_GetRef(Measure(Case));
+		if (Result.AllocsPerOp >= 0.0)
+		{
+			Output.Logf(TEXT("%-40s %12lld %14.1f %12.1f %14.1f"),
+				*Result.Name, Result.Iterations, Result.NsPerOp, Result.AllocsPerOp, Result.BytesPerOp);
+		}
+		else
+		{
+			Output.Logf(TEXT("%-40s %12lld %14.1f %12s %14s"),
+				*Result.Name, Result.Iterations, Result.NsPerOp, TEXT("n/a"), TEXT("n/a"));
+		}
+	}
+
+	if (Results.Num() == 0)
+	{
+		Output.Logf(TEXT("[Bench] No case matches '%s'"), *Filter);
+	}
+
+	return Results;
+}
+
+//========== Baseline ==========//
+
+bool FPlayKitBenchmarks::SaveResults(const TArray<FResult>& Results, const FString& Path)
+{
+	FPlayKitJsonWriter Json(Results.Num() * 128 + 64);
+	Json.BeginObject();
+	Json.WriteIntField("version", ResultsVersion);
+	Json.WriteStringField("configuration", LexToString(FApp::GetBuildConfiguration()));
+	Json.WriteStringField("platform", FPlatformProperties::IniPlatformName());
+	Json.WriteKey("results");
+	Json.BeginArray();
+	for (const FResult& Result : Results)
+	{
+		Json.BeginObject();
+		Json.WriteStringField("name", Result.Name);
+		Json.WriteIntField("iterations", Result.Iterations);
+		Json.WriteNumberField("nsPerOp", Result.NsPerOp);
+		Json.WriteNumberField("allocsPerOp", Result.AllocsPerOp);
+		Json.WriteNumberField("bytesPerOp", Result.BytesPerOp);
+		Json.EndObject();
+	}
+	Json.EndArray();
+	Json.EndObject();
+
+	return FFileHelper::SaveArrayToFile(Json.GetBuffer(), *Path);
+}
+
+int32 FPlayKitBenchmarks::CompareWithBaseline(const TArray<FResult>& Results, const FString& BaselinePath, double Tolerance, FOutputDevice& Output)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *BaselinePath))
+	{
+		Output.Logf(TEXT("[Bench] No baseline at %s; run 'playkit.bench save' to create one"), *BaselinePath);
+		return 0;
+	}
+
+	TMap<FString, FResult> Baseline;
+	FPlayKitJsonView::Parse(FileData).Find("results").ForEachElement([&Baseline](const FPlayKitJsonView& Item)
+	{
+		FResult Entry;
+		Entry.Name = Item.Find("name").AsString();
+		Entry.NsPerOp = Item.Find("nsPerOp").AsNumber();
+		Entry.AllocsPerOp = Item.Find("allocsPerOp").AsNumber(-1.0);
+		Baseline.Add(Entry.Name, Entry);
+		return true;
+	});
+
+	int32 Regressions = 0;
+	int32 UncountedAllocations = 0;
+	for (const FResult& Result : Results)
+	{
+		const FResult* Previous = Baseline.Find(Result.Name);
+		if (!Previous || Previous->NsPerOp <= 0.0)
+		{
+			continue;
+		}
+
+		if (Result.AllocsPerOp < 0.0 || Previous->AllocsPerOp < 0.0)
+		{
+			++UncountedAllocations;
+		}
+
+		const double Change = Result.NsPerOp / Previous->NsPerOp - 1.0;
+
+		// Allocation counts are deterministic, so any increase beyond rounding is real
+		const bool bMoreAllocations = Result.AllocsPerOp >= 0.0 && Previous->AllocsPerOp >= 0.0
+			&& Result.AllocsPerOp > Previous->AllocsPerOp + 0.5;
+
+		if (Change > Tolerance || bMoreAllocations)
+		{
+			++Regressions;
+			UE_LOG(LogPlayKit, Error, TEXT("[Bench] Regression in %s: %.1f -> %.1f ns/op (%+.1f%%), %.1f -> %.1f allocs/op"),
+				*Result.Name, Previous->NsPerOp, Result.NsPerOp, Change * 100.0, Previous->AllocsPerOp, Result.AllocsPerOp);
+		}
+		else
+		{
+			Output.Logf(TEXT("[Bench] %-40s %+6.1f%%"), *Result.Name, Change * 100.0);
+		}
+	}
+
+	if (UncountedAllocations > 0)
+	{
+		Output.Logf(TEXT("[Bench] Allocations not compared for %d case(s): not counted in this run or in the baseline"), UncountedAllocations);
+	}
+
+	Output.Logf(TEXT("[Bench] %d regression(s) against %s (tolerance %.0f%%)"), Regressions, *BaselinePath, Tolerance * 100.0);
+	return Regressions;
+}
+
+//========== Console ==========//
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GPlayKitBenchCommand(
+	TEXT("playkit.bench"),
+	TEXT("Run the PlayKit micro-benchmarks. Args: [filter=<substring>] [save] [baseline=<path>] [tolerance=<fraction>] [exit]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Output)
+		{
+			FString Filter;
+			FString BaselinePath = FPaths::ProjectSavedDir() / TEXT("PlayKit/Bench/Baseline.json");
+			double Tolerance = 0.15;
+			bool bSave = false;
+			bool bExit = false;
+
+			for (const FString& Arg : Args)
+			{
+				FString Key;
+				FString Value;
+				if (!Arg.Split(TEXT("="), &Key, &Value))
+				{
+					Key = Arg;
+				}
+
+				if (Key.Equals(TEXT("filter"), ESearchCase::IgnoreCase))
+				{
+					Filter = Value;
+				}
+				else if (Key.Equals(TEXT("baseline"), ESearchCase::IgnoreCase))
+				{
+					BaselinePath = FPaths::IsRelative(Value) ? FPaths::ProjectDir() / Value : Value;
+				}
+				else if (Key.Equals(TEXT("tolerance"), ESearchCase::IgnoreCase))
+				{
+					LexFromString(Tolerance, *Value);
+				}
+				else if (Key.Equals(TEXT("save"), ESearchCase::IgnoreCase))
+				{
+					bSave = true;
+				}
+				else if (Key.Equals(TEXT("exit"), ESearchCase::IgnoreCase))
+				{
+					bExit = true;
+				}
+				else
+				{
+					Output.Logf(TEXT("[Bench] Ignoring unknown argument '%s'"), *Arg);
+				}
+			}
+
+			const TArray<FPlayKitBenchmarks::FResult> Results = FPlayKitBenchmarks::Run(Filter, Output);
+
+			const FString LatestPath = FPaths::ProjectSavedDir() / TEXT("PlayKit/Bench/Latest.json");
+			FPlayKitBenchmarks::SaveResults(Results, LatestPath);
+
+			const int32 Regressions = FPlayKitBenchmarks::CompareWithBaseline(Results, BaselinePath, Tolerance, Output);
+
+			if (bSave)
+			{
+				if (FPlayKitBenchmarks::SaveResults(Results, BaselinePath))
+				{
+					Output.Logf(TEXT("[Bench] Saved baseline to %s"), *BaselinePath);
+				}
+				else
+				{
+					UE_LOG(LogPlayKit, Error, TEXT("[Bench] Failed to write baseline %s"), *BaselinePath);
+				}
+			}
+
+			if (bExit)
+			{
+				FPlatformMisc::RequestExitWithStatus(false, Regressions > 0 ? 1 : 0);
+			}
+		}));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,77 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Micro-benchmarks for the SDK's game-thread hot paths, run against synthetic data:
+ * SSE stream decoding, chat request bodies, tool-call and prediction parsing,
+ * base64 image decoding, action schema generation, NPC save/load and memory selection.
+ *
+ * Each case reports ns/op, allocations/op and bytes allocated/op, writes the results to
+ * Saved/PlayKit/Bench/Latest.json and compares them against a baseline file.
+ *
+ * Allocations are counted on the game thread only, and only when the process was started
+ * with -PlayKitBenchAllocs: that installs a counting GMalloc proxy once at startup, which is
+ * never removed. Without it, or on builds where FMemory bypasses GMalloc, allocations are
+ * reported as n/a and left out of the regression check.
+ *
+ * Console:
+ *   playkit.bench [filter=<substring>] [save] [baseline=<path>] [tolerance=<fraction>] [exit]
+ *
+ * - save: write the results as the new baseline
+ * - baseline: baseline file, relative to the project directory (default Saved/PlayKit/Bench/Baseline.json)
+ * - tolerance: allowed slowdown before a case counts as a regression (default 0.15)
+ * - exit: quit when done, with exit code 1 if anything regressed. For CI:
+ *   UnrealEditor-Cmd MyGame.uproject -game -nullrhi -unattended -PlayKitBenchAllocs -ExecCmds="playkit.bench baseline=Build/PlayKitBench.json exit"
+ *
+ * Not compiled into shipping builds.
+ */
+class PLAYKITSDK_API FPlayKitBenchmarks
+{
+public:
+	struct FResult
+	{
+		FString Name;
+		int64 Iterations = 0;
+		double NsPerOp = 0.0;
+
+		/** Negative if allocations could not be counted */
+		double AllocsPerOp = -1.0;
+		double BytesPerOp = -1.0;
+	};
+
+	/** Install the allocation counter if -PlayKitBenchAllocs is on the command line. Call once, at startup */
+	static void InstallAllocationCounter();
+
+	/** Run every case whose name contains Filter (all if empty) */
+	static TArray<FResult> Run(const FString& Filter, FOutputDevice& Output);
+
+	/**
+	 * Compare results against a baseline file and report regressions.
+	 * @return Number of regressed cases
+	 */
+	static int32 CompareWithBaseline(const TArray<FResult>& Results, const FString& BaselinePath, double Tolerance, FOutputDevice& Output);
+
+	static bool SaveResults(const TArray<FResult>& Results, const FString& Path);
+
+private:
+	struct FCase;
+
+	static void AddSSECases(TArray<FCase>& Cases);
+	static void AddChatBodyCases(TArray<FCase>& Cases);
+	static void AddActionCallCases(TArray<FCase>& Cases);
+	static void AddPredictionCases(TArray<FCase>& Cases);
+	static void AddImageCases(TArray<FCase>& Cases);
+	static void AddActionSchemaCases(TArray<FCase>& Cases);
+	static void AddActionArgsCases(TArray<FCase>& Cases);
+	static void AddSaveCases(TArray<FCase>& Cases);
+	static void AddMemoryCases(TArray<FCase>& Cases);
+
+	static FResult Measure(const FCase& Case);
+};
+
+#endif // !UE_BUILD_SHIPPING
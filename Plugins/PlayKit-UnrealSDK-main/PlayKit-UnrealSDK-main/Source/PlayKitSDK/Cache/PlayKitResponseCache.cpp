@@ -0,0 +1,261 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitResponseCache.h"
+#include "PlayKitLog.h"
+#include "PlayKitSettings.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Misc/Guid.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+
+namespace
+{
+	// Length-prefixed so that field boundaries can never be forged by the content itself
+	void AppendField(FString& Out, const FString& Value)
+	{
+		Out.AppendInt(Value.Len());
+		Out.AppendChar(TEXT(':'));
+		Out.Append(Value);
+		Out.AppendChar(TEXT('\n'));
+	}
+}
+
+void UPlayKitResponseCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UPlayKitSettings* Settings = UPlayKitSettings::Get();
+	MemoryCache.Empty(Settings ? FMath::Max(1, Settings->ResponseCacheMaxEntries) : 256);
+
+	UE_LOG(LogPlayKit, Log, TEXT("[ResponseCache] Initialized (max %d entries, disk %s)"),
+		MemoryCache.Max(), (Settings && Settings->bEnableDiskCache) ? TEXT("on") : TEXT("off"));
+}
+
+void UPlayKitResponseCache::Deinitialize()
+{
+	MemoryCache.Empty();
+	Super::Deinitialize();
+}
+
+UPlayKitResponseCache* UPlayKitResponseCache::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	UWorld* World = WorldContextObject->GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	UGameInstance* GameInstance = World->GetGameInstance();
+	if (!GameInstance)
+	{
+		return nullptr;
+	}
+
+	return GameInstance->GetSubsystem<UPlayKitResponseCache>();
+}
+
+//========== Keys ==========//
+
+FString UPlayKitResponseCache::MakeChatKey(const FString& Kind, const FString& Model, const FPlayKitChatConfig& Config, const FString& CanonicalSchema)
+{
+	FString Canonical;
+	Canonical.Reserve(256);
+
+	AppendField(Canonical, Kind);
+	AppendField(Canonical, Model);
+	AppendField(Canonical, FString::Printf(TEXT("%.4f"), Config.Temperature));
+	AppendField(Canonical, FString::FromInt(Config.MaxTokens));
+
+	for (const FPlayKitChatMessage& Message : Config.Messages)
+	{
+		AppendField(Canonical, Message.Role);
+		AppendField(Canonical, Message.Content);
+		AppendField(Canonical, Message.ToolCallId);
+	}
+
+	AppendField(Canonical, CanonicalSchema);
+
+	FTCHARToUTF8 Utf8(*Canonical, Canonical.Len());
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(Utf8.Get(), Utf8.Length(), Hash.Hash);
+	return Hash.ToString();
+}
+
+//========== Lookup ==========//
+
+bool UPlayKitResponseCache::Find(const FString& Key, FPlayKitCachedResponse& OutResponse)
+{
+	const int64 Now = FDateTime::UtcNow().ToUnixTimestamp();
+
+	if (const FPlayKitCachedResponse* Cached = MemoryCache.FindAndTouch(Key))
+	{
+		if (!Cached->IsExpired(Now))
+		{
+			OutResponse = *Cached;
+			HitCount++;
+			return true;
+		}
+		MemoryCache.Remove(Key);
+	}
+
+	if (!IsDiskTierEnabled())
+	{
+		MissCount++;
+	}
+	return false;
+}
+
+bool UPlayKitResponseCache::IsDiskTierEnabled() const
+{
+	const UPlayKitSettings* Settings = UPlayKitSettings::Get();
+	return Settings && Settings->bEnableDiskCache;
+}
+
+bool UPlayKitResponseCache::FindOnDisk(const FString& Key, FOnDiskLookup OnComplete)
+{
+	if (!IsDiskTierEnabled())
+	{
+		return false;
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+		[WeakThis = TWeakObjectPtr<UPlayKitResponseCache>(this), Key, Path = GetEntryPath(Key), OnComplete = MoveTemp(OnComplete)]() mutable
+		{
+			FPlayKitCachedResponse Response;
+			bool bFound = LoadFromDisk(Path, Response);
+			if (bFound && Response.IsExpired(FDateTime::UtcNow().ToUnixTimestamp()))
+			{
+				IFileManager::Get().Delete(*Path, false, false, true);
+				bFound = false;
+			}
+
+			AsyncTask(ENamedThreads::GameThread,
+				[WeakThis, Key = MoveTemp(Key), bFound, Response = MoveTemp(Response), OnComplete = MoveTemp(OnComplete)]()
+				{
+					if (UPlayKitResponseCache* Cache = WeakThis.Get())
+					{
+						if (bFound)
+						{
+							// Promote to the memory tier
+							Cache->MemoryCache.Add(Key, Response);
+							Cache->HitCount++;
+						}
+						else
+						{
+							Cache->MissCount++;
+						}
+					}
+					OnComplete(bFound, Response);
+				});
+		});
+	return true;
+}
+
+void UPlayKitResponseCache::Store(const FString& Key, const FString& Content, const FString& FinishReason)
+{
+	if (Key.IsEmpty())
+	{
+		return;
+	}
+
+	UPlayKitSettings* Settings = UPlayKitSettings::Get();
+
+	FPlayKitCachedResponse Entry;
+	Entry.Content = Content;
+	Entry.FinishReason = FinishReason;
+	if (Settings && Settings->ResponseCacheTTLSeconds > 0.0f)
+	{
+		Entry.ExpiresAt = FDateTime::UtcNow().ToUnixTimestamp() + static_cast<int64>(Settings->ResponseCacheTTLSeconds);
+	}
+
+	if (Settings && Settings->bEnableDiskCache)
+	{
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Path = GetEntryPath(Key), Entry]()
+		{
+			SaveToDisk(Path, Entry);
+		});
+	}
+
+	MemoryCache.Add(Key, MoveTemp(Entry));
+}
+
+void UPlayKitResponseCache::ClearCache(bool bIncludeDisk)
+{
+	MemoryCache.Empty(MemoryCache.Max());
+
+	if (bIncludeDisk)
+	{
+		IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[ResponseCache] Cleared%s"), bIncludeDisk ? TEXT(" (including disk)") : TEXT(""));
+}
+
+//========== Disk Tier ==========//
+
+FString UPlayKitResponseCache::GetCacheDirectory() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("PlayKit") / TEXT("Cache");
+}
+
+FString UPlayKitResponseCache::GetEntryPath(const FString& Key) const
+{
+	return GetCacheDirectory() / Key + TEXT(".json");
+}
+
+bool UPlayKitResponseCache::LoadFromDisk(const FString& Path, FPlayKitCachedResponse& OutResponse)
+{
+	FString FileContent;
+	if (!FFileHelper::LoadFileToString(FileContent, *Path))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContent);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		return false;
+	}
+
+	double ExpiresAt = 0.0;
+	JsonObject->TryGetStringField(TEXT("content"), OutResponse.Content);
+	JsonObject->TryGetStringField(TEXT("finishReason"), OutResponse.FinishReason);
+	JsonObject->TryGetNumberField(TEXT("expiresAt"), ExpiresAt);
+	OutResponse.ExpiresAt = static_cast<int64>(ExpiresAt);
+	return true;
+}
+
+void UPlayKitResponseCache::SaveToDisk(const FString& Path, const FPlayKitCachedResponse& Response)
+{
+	TSharedPtr<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("content"), Response.Content);
+	JsonObject->SetStringField(TEXT("finishReason"), Response.FinishReason);
+	JsonObject->SetNumberField(TEXT("expiresAt"), static_cast<double>(Response.ExpiresAt));
+
+	FString FileContent;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&FileContent);
+	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+
+	// Written aside and moved into place, so a concurrent read or write of the same entry never sees half a file
+	const FString TempPath = Path + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(FileContent, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+		|| !IFileManager::Get().Move(*Path, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		UE_LOG(LogPlayKit, Warning, TEXT("[ResponseCache] Failed to write cache entry %s"), *FPaths::GetBaseFilename(Path));
+	}
+}
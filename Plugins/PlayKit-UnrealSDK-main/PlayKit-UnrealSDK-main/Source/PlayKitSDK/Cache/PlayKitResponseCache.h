@@ -0,0 +1,117 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/LruCache.h"
+#include "PlayKitTypes.h"
+#include "PlayKitResponseCache.generated.h"
+
+/**
+ * A cached generation result
+ */
+struct PLAYKITSDK_API FPlayKitCachedResponse
+{
+	/** Generated text, or the JSON object for structured output */
+	FString Content;
+
+	FString FinishReason;
+
+	/** UTC Unix time after which the entry is stale (0 = never) */
+	int64 ExpiresAt = 0;
+
+	bool IsExpired(int64 Now) const { return ExpiresAt > 0 && Now >= ExpiresAt; }
+};
+
+/**
+ * PlayKit Response Cache
+ * Content-addressed cache for chat and structured generation results.
+ *
+ * Keys are a SHA-1 of the canonical request (kind, model, temperature, max tokens,
+ * messages and schema), so two requests share an entry exactly when the server
+ * would see the same input. Streaming and non-streaming requests share entries.
+ *
+ * Tiers:
+ * - In-memory LRU (Project Settings > PlayKit SDK > Response Cache > Max Memory Entries)
+ * - Optional on-disk tier under Saved/PlayKit/Cache, one small JSON file per entry.
+ *   It is read and written on worker threads, so a cold cache never blocks the game thread
+ *
+ * Caching is opt-in per component (UPlayKitChatClient::bUseResponseCache) and can be
+ * skipped for a single call with FPlayKitChatConfig::bBypassCache. Only cache requests
+ * whose answer should not change, e.g. fixed tutorial lines or temperature 0 generations.
+ */
+UCLASS()
+class PLAYKITSDK_API UPlayKitResponseCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Cache", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitResponseCache* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Build the cache key for a chat request.
+	 * @param Kind Request kind, e.g. "text" or "structured"
+	 * @param Model Model name
+	 * @param Config Messages, temperature and max tokens
+	 * @param CanonicalSchema Condensed schema JSON for structured output (empty for text)
+	 */
+	static FString MakeChatKey(const FString& Kind, const FString& Model, const FPlayKitChatConfig& Config, const FString& CanonicalSchema = FString());
+
+	/** Called on the game thread when a disk lookup finishes */
+	using FOnDiskLookup = TFunction<void(bool bFound, const FPlayKitCachedResponse& Response)>;
+
+	/**
+	 * Look up a fresh entry in the memory tier. Never touches the disk; on a miss, follow up
+	 * with FindOnDisk. A miss is counted once the last enabled tier has missed.
+	 */
+	bool Find(const FString& Key, FPlayKitCachedResponse& OutResponse);
+
+	/** Whether misses in memory should be looked up with FindOnDisk */
+	bool IsDiskTierEnabled() const;
+
+	/**
+	 * Look up an entry in the disk tier on a worker thread. OnComplete runs on the game thread;
+	 * a fresh entry is promoted to the memory tier first. Returns false without calling
+	 * OnComplete when the disk tier is off.
+	 */
+	bool FindOnDisk(const FString& Key, FOnDiskLookup OnComplete);
+
+	/** Store an entry. The expiry is set from the configured TTL; the disk copy is written on a worker thread */
+	void Store(const FString& Key, const FString& Content, const FString& FinishReason = FString());
+
+	/** Remove all entries */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Cache")
+	void ClearCache(bool bIncludeDisk = true);
+
+	/** Number of entries in the memory tier */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Cache")
+	int32 GetMemoryEntryCount() const { return MemoryCache.Num(); }
+
+	/** Lookups served from the cache since startup */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Cache")
+	int32 GetHitCount() const { return HitCount; }
+
+	/** Lookups that had to go to the server since startup */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Cache")
+	int32 GetMissCount() const { return MissCount; }
+
+private:
+	FString GetCacheDirectory() const;
+	FString GetEntryPath(const FString& Key) const;
+
+	// Worker-thread side of the disk tier; these touch no UObject
+	static bool LoadFromDisk(const FString& Path, FPlayKitCachedResponse& OutResponse);
+	static void SaveToDisk(const FString& Path, const FPlayKitCachedResponse& Response);
+
+private:
+	TLruCache<FString, FPlayKitCachedResponse> MemoryCache;
+
+	int32 HitCount = 0;
+	int32 MissCount = 0;
+};
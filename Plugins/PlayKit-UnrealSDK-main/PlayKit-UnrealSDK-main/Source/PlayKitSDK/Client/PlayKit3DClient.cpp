@@ -1,12 +1,13 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKit3DClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
-#include "Serialization/JsonReader.h"
-#include "Serialization/JsonSerializer.h"
-#include "Dom/JsonObject.h"
 #include "TimerManager.h"
 
 UPlayKit3DClient::UPlayKit3DClient()
@@ -32,7 +33,7 @@ void UPlayKit3DClient::BeginPlay()
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] 3DClient initialized with model: %s"), *ModelName);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] 3DClient initialized with model: %s"), *ModelName);
 }
 
 void UPlayKit3DClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -41,7 +42,7 @@ void UPlayKit3DClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	StopPolling();
 	if (CurrentRequest.IsValid())
 	{
-		CurrentRequest->CancelRequest();
+		UPlayKitRequestScheduler::Cancel(this, CurrentRequest);
 		CurrentRequest.Reset();
 	}
 
@@ -102,14 +103,14 @@ void UPlayKit3DClient::CancelTask()
 {
 	if (CurrentRequest.IsValid())
 	{
-		CurrentRequest->CancelRequest();
+		UPlayKitRequestScheduler::Cancel(this, CurrentRequest);
 		CurrentRequest.Reset();
 	}
 
 	StopPolling();
 	CleanupCurrentTask();
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] 3D generation task cancelled"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] 3D generation task cancelled"));
 }
 
 void UPlayKit3DClient::QueryTaskStatus(const FString& TaskId)
@@ -146,50 +147,47 @@ void UPlayKit3DClient::CreateTask(const FPlayKit3DConfig& Config)
 	bIsProcessing = true;
 
 	// Build request body
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), ModelName);
-	RequestBody->SetStringField(TEXT("prompt"), Config.Prompt);
+	FPlayKitJsonWriter Json(Config.Prompt.Len() + Config.NegativePrompt.Len() + 384);
+	Json.BeginObject();
+	Json.WriteStringField("model", ModelName);
+	Json.WriteStringField("prompt", Config.Prompt);
 
 	if (!Config.NegativePrompt.IsEmpty())
 	{
-		RequestBody->SetStringField(TEXT("negative_prompt"), Config.NegativePrompt);
+		Json.WriteStringField("negative_prompt", Config.NegativePrompt);
 	}
 
 	if (!Config.ModelVersion.IsEmpty())
 	{
-		RequestBody->SetStringField(TEXT("model_version"), Config.ModelVersion);
+		Json.WriteStringField("model_version", Config.ModelVersion);
 	}
 
-	RequestBody->SetBoolField(TEXT("texture"), Config.bTexture);
-	RequestBody->SetBoolField(TEXT("pbr"), Config.bPBR);
-	RequestBody->SetStringField(TEXT("texture_quality"), QualityToString(Config.TextureQuality));
-	RequestBody->SetStringField(TEXT("geometry_quality"), QualityToString(Config.GeometryQuality));
+	Json.WriteBoolField("texture", Config.bTexture);
+	Json.WriteBoolField("pbr", Config.bPBR);
+	Json.WriteStringField("texture_quality", QualityToString(Config.TextureQuality));
+	Json.WriteStringField("geometry_quality", QualityToString(Config.GeometryQuality));
 
 	if (Config.TextureSeed >= 0)
 	{
-		RequestBody->SetNumberField(TEXT("texture_seed"), Config.TextureSeed);
+		Json.WriteIntField("texture_seed", Config.TextureSeed);
 	}
 
 	if (Config.FaceLimit > 0)
 	{
-		RequestBody->SetNumberField(TEXT("face_limit"), Config.FaceLimit);
+		Json.WriteIntField("face_limit", Config.FaceLimit);
 	}
 
-	RequestBody->SetBoolField(TEXT("auto_size"), Config.bAutoSize);
-	RequestBody->SetBoolField(TEXT("quad"), Config.bQuad);
-	RequestBody->SetBoolField(TEXT("smart_low_poly"), Config.bSmartLowPoly);
-
-	// Serialize
-	FString RequestBodyStr;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyStr);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
+	Json.WriteBoolField("auto_size", Config.bAutoSize);
+	Json.WriteBoolField("quad", Config.bQuad);
+	Json.WriteBoolField("smart_low_poly", Config.bSmartLowPoly);
+	Json.EndObject();
 
 	CurrentRequest = CreateAuthenticatedRequest(Url);
-	CurrentRequest->SetContentAsString(RequestBodyStr);
+	CurrentRequest->SetContent(Json.Finish());
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKit3DClient::HandleCreateTaskResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Creating 3D generation task: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Creating 3D generation task: %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Bulk, EPlayKitEndpoint::Model3D, ModelName);
 }
 
 void UPlayKit3DClient::HandleCreateTaskResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -209,15 +207,16 @@ void UPlayKit3DClient::HandleCreateTaskResponse(FHttpRequestPtr Request, FHttpRe
 	if (ResponseCode != 201)
 	{
 		CleanupCurrentTask();
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] 3D create error %d: %s"), ResponseCode, *ResponseContent);
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] 3D create error %d: %s"), ResponseCode, *ResponseContent);
 		BroadcastError(FString::FromInt(ResponseCode), ResponseContent);
 		return;
 	}
 
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::3D::ParseCreateTask");
+
 	// Parse response
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
-	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Response->GetContent());
+	if (!Root.IsObject())
 	{
 		CleanupCurrentTask();
 		BroadcastError(TEXT("PARSE_ERROR"), TEXT("Failed to parse response"));
@@ -225,16 +224,16 @@ void UPlayKit3DClient::HandleCreateTaskResponse(FHttpRequestPtr Request, FHttpRe
 	}
 
 	// Extract task info
-	JsonObject->TryGetStringField(TEXT("task_id"), CurrentTaskId);
+	Root.Find("task_id").TryGetString(CurrentTaskId);
 
 	FString StatusStr;
-	if (JsonObject->TryGetStringField(TEXT("status"), StatusStr))
+	if (Root.Find("status").TryGetString(StatusStr))
 	{
 		CurrentStatus = ParseStatus(StatusStr);
 	}
 
-	JsonObject->TryGetNumberField(TEXT("progress"), CurrentProgress);
-	JsonObject->TryGetNumberField(TEXT("poll_interval"), PollIntervalSeconds);
+	CurrentProgress = Root.Find("progress").AsInt(CurrentProgress);
+	PollIntervalSeconds = Root.Find("poll_interval").AsInt(PollIntervalSeconds);
 
 	if (CurrentTaskId.IsEmpty())
 	{
@@ -243,7 +242,7 @@ void UPlayKit3DClient::HandleCreateTaskResponse(FHttpRequestPtr Request, FHttpRe
 		return;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] 3D task created: %s, status: %s, poll_interval: %d"),
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] 3D task created: %s, status: %s, poll_interval: %d"),
 		*CurrentTaskId, *StatusStr, PollIntervalSeconds);
 
 	// Broadcast initial progress
@@ -260,7 +259,7 @@ void UPlayKit3DClient::StartPolling(int32 IntervalSeconds)
 	UWorld* World = GetWorld();
 	if (!World)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Cannot start polling - World is null"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Cannot start polling - World is null"));
 		return;
 	}
 
@@ -276,7 +275,7 @@ void UPlayKit3DClient::StartPolling(int32 IntervalSeconds)
 		true  // Loop
 	);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Started polling task %s every %d seconds"),
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Started polling task %s every %d seconds"),
 		*CurrentTaskId, IntervalSeconds);
 }
 
@@ -287,7 +286,7 @@ void UPlayKit3DClient::StopPolling()
 	{
 		World->GetTimerManager().ClearTimer(PollTimerHandle);
 		PollTimerHandle.Invalidate();
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Stopped polling"));
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Stopped polling"));
 	}
 }
 
@@ -311,8 +310,8 @@ void UPlayKit3DClient::PollTaskStatus()
 	CurrentRequest->SetVerb(TEXT("GET"));  // Override to GET for polling
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKit3DClient::HandlePollResponse);
 
-	UE_LOG(LogTemp, Verbose, TEXT("[PlayKit] Polling task status: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Polling task status: %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Bulk, EPlayKitEndpoint::Model3D, ModelName);
 }
 
 void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -321,27 +320,27 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 
 	if (!bWasSuccessful || !Response.IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[PlayKit] Poll request failed, will retry on next interval"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[PlayKit] Poll request failed, will retry on next interval"));
 		return; // Don't stop polling on network errors
 	}
 
 	int32 ResponseCode = Response->GetResponseCode();
-	FString ResponseContent = Response->GetContentAsString();
 
 	if (ResponseCode != 200)
 	{
 		StopPolling();
 		CleanupCurrentTask();
-		BroadcastError(FString::FromInt(ResponseCode), ResponseContent);
+		BroadcastError(FString::FromInt(ResponseCode), Response->GetContentAsString());
 		return;
 	}
 
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::3D::ParsePoll");
+
 	// Parse response
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
-	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Response->GetContent());
+	if (!Root.IsObject())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[PlayKit] Failed to parse poll response"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[PlayKit] Failed to parse poll response"));
 		return;
 	}
 
@@ -351,16 +350,17 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 
 	// Parse task data
 	FString StatusStr;
-	if (JsonObject->TryGetStringField(TEXT("status"), StatusStr))
+	if (Root.Find("status").TryGetString(StatusStr))
 	{
 		CurrentStatus = ParseStatus(StatusStr);
 	}
 
-	JsonObject->TryGetNumberField(TEXT("progress"), CurrentProgress);
+	CurrentProgress = Root.Find("progress").AsInt(CurrentProgress);
 
-	int32 NewPollInterval = PollIntervalSeconds;
-	if (JsonObject->TryGetNumberField(TEXT("poll_interval"), NewPollInterval))
+	const FPlayKitJsonView PollInterval = Root.Find("poll_interval");
+	if (PollInterval.IsNumber())
 	{
+		const int32 NewPollInterval = PollInterval.AsInt();
 		if (NewPollInterval != PollIntervalSeconds)
 		{
 			PollIntervalSeconds = NewPollInterval;
@@ -372,7 +372,7 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 	// Broadcast status change if changed
 	if (CurrentStatus != OldStatus)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Task %s status changed: %d -> %d"),
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Task %s status changed: %d -> %d"),
 			*CurrentTaskId, (int32)OldStatus, (int32)CurrentStatus);
 		OnStatusChanged.Broadcast(CurrentTaskId, OldStatus, CurrentStatus);
 	}
@@ -380,7 +380,7 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 	// Broadcast progress if changed
 	if (CurrentProgress != OldProgress)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Task %s progress: %d%%"), *CurrentTaskId, CurrentProgress);
+		UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Task %s progress: %d%%"), *CurrentTaskId, CurrentProgress);
 		OnProgress.Broadcast(CurrentTaskId, CurrentProgress);
 	}
 
@@ -395,24 +395,24 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 		Result.Task.Status = CurrentStatus;
 		Result.Task.Progress = 100;
 
-		JsonObject->TryGetNumberField(TEXT("created_at"), Result.Task.CreatedAt);
-		JsonObject->TryGetNumberField(TEXT("completed_at"), Result.Task.CompletedAt);
+		Result.Task.CreatedAt = static_cast<int64>(Root.Find("created_at").AsNumber());
+		Result.Task.CompletedAt = static_cast<int64>(Root.Find("completed_at").AsNumber());
 
 		// Parse output
-		const TSharedPtr<FJsonObject>* OutputPtr;
-		if (JsonObject->TryGetObjectField(TEXT("output"), OutputPtr) && OutputPtr)
+		const FPlayKitJsonView Output = Root.Find("output");
+		if (Output.IsObject())
 		{
-			(*OutputPtr)->TryGetStringField(TEXT("model"), Result.Task.Output.ModelUrl);
-			(*OutputPtr)->TryGetStringField(TEXT("pbr_model"), Result.Task.Output.PBRModelUrl);
-			(*OutputPtr)->TryGetStringField(TEXT("rendered_image"), Result.Task.Output.RenderedImageUrl);
+			Output.Find("model").TryGetString(Result.Task.Output.ModelUrl);
+			Output.Find("pbr_model").TryGetString(Result.Task.Output.PBRModelUrl);
+			Output.Find("rendered_image").TryGetString(Result.Task.Output.RenderedImageUrl);
 			Result.Task.Output.GeneratedAt = FDateTime::UtcNow();
 
 			// Log warning about URL expiration
-			UE_LOG(LogTemp, Warning, TEXT("[PlayKit] Model URLs will expire in 5 minutes! Download immediately."));
-			UE_LOG(LogTemp, Log, TEXT("[PlayKit] Model URL: %s"), *Result.Task.Output.ModelUrl);
+			UE_LOG(LogPlayKit, Warning, TEXT("[PlayKit] Model URLs will expire in 5 minutes! Download immediately."));
+			UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Model URL: %s"), *Result.Task.Output.ModelUrl);
 			if (!Result.Task.Output.PBRModelUrl.IsEmpty())
 			{
-				UE_LOG(LogTemp, Log, TEXT("[PlayKit] PBR Model URL: %s"), *Result.Task.Output.PBRModelUrl);
+				UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] PBR Model URL: %s"), *Result.Task.Output.PBRModelUrl);
 			}
 		}
 
@@ -429,12 +429,9 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 		FString ErrorMessage = StatusStr;
 
 		// Try to extract detailed error
-		const TSharedPtr<FJsonObject>* ErrorPtr;
-		if (JsonObject->TryGetObjectField(TEXT("error"), ErrorPtr) && ErrorPtr)
-		{
-			(*ErrorPtr)->TryGetStringField(TEXT("code"), ErrorCode);
-			(*ErrorPtr)->TryGetStringField(TEXT("message"), ErrorMessage);
-		}
+		const FPlayKitJsonView Error = Root.Find("error");
+		Error.Find("code").TryGetString(ErrorCode);
+		Error.Find("message").TryGetString(ErrorMessage);
 
 		CleanupCurrentTask();
 		BroadcastError(ErrorCode, ErrorMessage);
@@ -446,7 +443,7 @@ void UPlayKit3DClient::HandlePollResponse(FHttpRequestPtr Request, FHttpResponse
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKit3DClient::CreateAuthenticatedRequest(const FString& Url)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -505,7 +502,7 @@ FString UPlayKit3DClient::QualityToString(EPlayKit3DQuality Quality) const
 
 void UPlayKit3DClient::BroadcastError(const FString& ErrorCode, const FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Error, TEXT("[PlayKit] 3D error [%s]: %s"), *ErrorCode, *ErrorMessage);
+	UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] 3D error [%s]: %s"), *ErrorCode, *ErrorMessage);
 	OnError.Broadcast(ErrorCode, ErrorMessage);
 }
 
@@ -1,11 +1,19 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitChatClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Cache/PlayKitResponseCache.h"
+#include "Metrics/PlayKitMetrics.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "Dom/JsonObject.h"
 
 UPlayKitChatClient::UPlayKitChatClient()
@@ -31,7 +39,7 @@ void UPlayKitChatClient::BeginPlay()
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] ChatClient component initialized with model: %s"), *ModelName);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] ChatClient component initialized with model: %s"), *ModelName);
 }
 
 void UPlayKitChatClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -52,7 +60,7 @@ FString UPlayKitChatClient::BuildRequestUrl() const
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitChatClient::CreateAuthenticatedRequest(const FString& Url)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -72,7 +80,21 @@ TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitChatClient::CreateAuthenti
 	return Request;
 }
 
-void UPlayKitChatClient::GenerateText(const FString& Prompt)
+int32 UPlayKitChatClient::AllocateRequestId()
+{
+	// Stay positive so 0 can mean "no request"
+	const int32 Id = NextRequestId;
+	NextRequestId = (NextRequestId == MAX_int32) ? 1 : NextRequestId + 1;
+	return Id;
+}
+
+TSharedPtr<UPlayKitChatClient::FChatRequestState> UPlayKitChatClient::FindRequestState(int32 RequestId) const
+{
+	const TSharedPtr<FChatRequestState>* Found = ActiveRequests.Find(RequestId);
+	return Found ? *Found : nullptr;
+}
+
+int32 UPlayKitChatClient::GenerateText(const FString& Prompt)
 {
 	FPlayKitChatConfig Config;
 
@@ -86,15 +108,15 @@ void UPlayKitChatClient::GenerateText(const FString& Prompt)
 	Config.Temperature = Temperature;
 	Config.MaxTokens = MaxTokens;
 
-	GenerateTextAdvanced(Config);
+	return GenerateTextAdvanced(Config);
 }
 
-void UPlayKitChatClient::GenerateTextAdvanced(const FPlayKitChatConfig& Config)
+int32 UPlayKitChatClient::GenerateTextAdvanced(const FPlayKitChatConfig& Config)
 {
-	SendChatRequest(Config, false);
+	return SendChatRequest(Config, false);
 }
 
-void UPlayKitChatClient::GenerateTextStream(const FString& Prompt)
+int32 UPlayKitChatClient::GenerateTextStream(const FString& Prompt)
 {
 	FPlayKitChatConfig Config;
 
@@ -108,126 +130,144 @@ void UPlayKitChatClient::GenerateTextStream(const FString& Prompt)
 	Config.Temperature = Temperature;
 	Config.MaxTokens = MaxTokens;
 
-	GenerateTextStreamAdvanced(Config);
+	return GenerateTextStreamAdvanced(Config);
 }
 
-void UPlayKitChatClient::GenerateTextStreamAdvanced(const FPlayKitChatConfig& Config)
+int32 UPlayKitChatClient::GenerateTextStreamAdvanced(const FPlayKitChatConfig& Config)
 {
-	SendChatRequest(Config, true);
+	return SendChatRequest(Config, true);
 }
 
-void UPlayKitChatClient::SendChatRequest(const FPlayKitChatConfig& Config, bool bStream)
+int32 UPlayKitChatClient::SendChatRequest(const FPlayKitChatConfig& Config, bool bStream)
 {
-	if (bIsProcessing)
-	{
-		BroadcastError(TEXT("REQUEST_IN_PROGRESS"), TEXT("A request is already in progress"));
-		return;
-	}
+	const int32 RequestId = AllocateRequestId();
 
 	FString Url = BuildRequestUrl();
 	if (Url.IsEmpty())
 	{
-		BroadcastError(TEXT("CONFIG_ERROR"), TEXT("Failed to build request URL"));
-		return;
+		BroadcastError(RequestId, TEXT("CONFIG_ERROR"), TEXT("Failed to build request URL"));
+		return RequestId;
 	}
 
-	bIsProcessing = true;
-	StreamBuffer.Empty();
-	AccumulatedContent.Empty();
-	LastProcessedOffset = 0;
+	const FString CacheKey = MakeCacheKey(TEXT("text"), Config);
+	if (TryServeFromCache(RequestId, CacheKey, bStream ? ECachedDelivery::Stream : ECachedDelivery::Text))
+	{
+		return RequestId;
+	}
 
-	// Build request body
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), ModelName);
-	RequestBody->SetNumberField(TEXT("temperature"), Config.Temperature);
-	RequestBody->SetBoolField(TEXT("stream"), bStream);
+	// Create and send request
+	TSharedPtr<FChatRequestState> State = MakeShared<FChatRequestState>();
+	State->CacheKey = CacheKey;
+	State->HttpRequest = CreateAuthenticatedRequest(Url);
+	State->HttpRequest->SetContent(BuildChatBody(Config, bStream));
 
-	if (Config.MaxTokens > 0)
+	if (bStream)
 	{
-		RequestBody->SetNumberField(TEXT("max_tokens"), Config.MaxTokens);
+		UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Using STREAMING mode"));
+		State->HttpRequest->OnRequestProgress64().BindUObject(this, &UPlayKitChatClient::HandleStreamProgress, RequestId);
+		State->HttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleStreamComplete, RequestId);
 	}
-
-	// Add messages
-	TArray<TSharedPtr<FJsonValue>> MessagesArray;
-	for (const FPlayKitChatMessage& Message : Config.Messages)
+	else
 	{
-		TSharedPtr<FJsonObject> MessageObj = MakeShared<FJsonObject>();
-		MessageObj->SetStringField(TEXT("role"), Message.Role);
-		MessageObj->SetStringField(TEXT("content"), Message.Content);
-		if (!Message.ToolCallId.IsEmpty())
-		{
-			MessageObj->SetStringField(TEXT("tool_call_id"), Message.ToolCallId);
-		}
-		MessagesArray.Add(MakeShared<FJsonValueObject>(MessageObj));
+		UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Using NON-STREAMING mode"));
+		State->HttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleChatResponse, RequestId);
 	}
-	RequestBody->SetArrayField(TEXT("messages"), MessagesArray);
 
-	// Serialize
-	FString RequestBodyStr;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyStr);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Sending chat request %d to: %s"), RequestId, *Url);
+	SubmitRequest(RequestId, State, bStream ? ECachedDelivery::Stream : ECachedDelivery::Text);
+	return RequestId;
+}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Request body: %s"), *RequestBodyStr.Left(500));
+TArray<uint8> UPlayKitChatClient::BuildChatBody(const FPlayKitChatConfig& Config, bool bStream) const
+{
+	PLAYKIT_SCOPE(STAT_PlayKit_BuildBody, "PlayKit::Chat::BuildBody");
 
-	// Create and send request
-	CurrentRequest = CreateAuthenticatedRequest(Url);
-	CurrentRequest->SetContentAsString(RequestBodyStr);
+	// Build request body straight into UTF-8
+	int32 BodySizeHint = 256;
+	for (const FPlayKitChatMessage& Message : Config.Messages)
+	{
+		BodySizeHint += Message.Content.Len() + 48;
+	}
 
-	if (bStream)
+	FPlayKitJsonWriter Json(BodySizeHint);
+	Json.BeginObject();
+	Json.WriteStringField("model", ModelName);
+	Json.WriteNumberField("temperature", Config.Temperature);
+	Json.WriteBoolField("stream", bStream);
+
+	if (Config.MaxTokens > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Using STREAMING mode"));
-		CurrentRequest->OnRequestProgress64().BindUObject(this, &UPlayKitChatClient::HandleStreamProgress);
-		CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleStreamComplete);
+		Json.WriteIntField("max_tokens", Config.MaxTokens);
 	}
-	else
+
+	Json.WriteKey("messages");
+	Json.BeginArray();
+	for (const FPlayKitChatMessage& Message : Config.Messages)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Using NON-STREAMING mode"));
-		CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleChatResponse);
+		Json.WriteMessage(Message.Role, Message.Content, Message.ToolCallId);
 	}
+	Json.EndArray();
+	Json.EndObject();
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Sending chat request to: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Request body: %s"), *Json.ToString());
+	return Json.Finish();
 }
 
-void UPlayKitChatClient::HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UPlayKitChatClient::HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId)
 {
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] HandleChatResponse called - bWasSuccessful: %d"), bWasSuccessful);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] HandleChatResponse called for request %d - bWasSuccessful: %d"), RequestId, bWasSuccessful);
 
-	bIsProcessing = false;
-	CurrentRequest.Reset();
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		// Cancelled
+		return;
+	}
 
 	if (!bWasSuccessful || !Response.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Response invalid or unsuccessful"));
-		BroadcastError(TEXT("NETWORK_ERROR"), TEXT("Network request failed"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Response invalid or unsuccessful"));
+		BroadcastError(RequestId, TEXT("NETWORK_ERROR"), TEXT("Network request failed"));
 		return;
 	}
 
 	int32 ResponseCode = Response->GetResponseCode();
-	FString ResponseContent = Response->GetContentAsString();
+	const TArray<uint8>& ResponseContent = Response->GetContent();
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Response code: %d, Content length: %d"), ResponseCode, ResponseContent.Len());
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Response: %s"), *ResponseContent.Left(500));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Response code: %d, Content length: %d"), ResponseCode, ResponseContent.Num());
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Response: %s"), *Response->GetContentAsString());
 
 	if (ResponseCode < 200 || ResponseCode >= 300)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Chat error %d: %s"), ResponseCode, *ResponseContent);
-		BroadcastError(FString::FromInt(ResponseCode), ResponseContent);
+		const FString ErrorContent = Response->GetContentAsString();
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Chat error %d: %s"), ResponseCode, *ErrorContent);
+		BroadcastError(RequestId, FString::FromInt(ResponseCode), ErrorContent);
 		return;
 	}
 
 	FPlayKitChatResponse ChatResponse = ParseChatResponse(ResponseContent);
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Parsed response - Success: %d, Content: %s"), ChatResponse.bSuccess, *ChatResponse.Content.Left(200));
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] OnChatResponse delegate bound: %s"), OnChatResponse.IsBound() ? TEXT("YES") : TEXT("NO"));
+	ChatResponse.RequestId = RequestId;
+	UPlayKitMetrics::NoteGeneratedTokens(this, State->HttpRequest, ChatResponse.CompletionTokens > 0
+		? ChatResponse.CompletionTokens : UPlayKitMetrics::EstimateTokenCount(ChatResponse.Content));
+
+	// Tool calls depend on game state, so only plain answers are cached
+	if (ChatResponse.bSuccess && ChatResponse.ToolCalls.Num() == 0 && !ChatResponse.Content.IsEmpty())
+	{
+		StoreInCache(State->CacheKey, ChatResponse.Content, ChatResponse.FinishReason);
+	}
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Parsed response - Success: %d, Content: %s"), ChatResponse.bSuccess, *ChatResponse.Content);
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
 	OnChatResponse.Broadcast(ChatResponse);
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] OnChatResponse.Broadcast completed"));
 }
 
-void UPlayKitChatClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived)
+void UPlayKitChatClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, int32 RequestId)
 {
-	UE_LOG(LogTemp, Verbose, TEXT("[PlayKit] Stream progress - Sent: %llu, Received: %llu"), BytesSent, BytesReceived);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Stream %d progress - Sent: %llu, Received: %llu"), RequestId, BytesSent, BytesReceived);
 
-	if (!Request.IsValid())
+	TSharedPtr<FChatRequestState> State = FindRequestState(RequestId);
+	if (!State.IsValid() || !Request.IsValid())
 	{
 		return;
 	}
@@ -238,222 +278,336 @@ void UPlayKitChatClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 By
 		return;
 	}
 
-	FString CurrentContent = Response->GetContentAsString();
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseStreamChunk, "PlayKit::Chat::StreamChunk");
+
+	// Decode only the bytes that arrived since the last tick
+	TArray<FPlayKitSSEEvent> Events;
+	State->StreamDecoder.ConsumeResponse(Response->GetContent(), Events);
 
-	// Process only new data
-	if (CurrentContent.Len() <= LastProcessedOffset)
+	for (const FPlayKitSSEEvent& Event : Events)
+	{
+		ProcessStreamEvent(*State, RequestId, Event);
+	}
+}
+
+void UPlayKitChatClient::ProcessStreamEvent(FChatRequestState& State, int32 RequestId, const FPlayKitSSEEvent& Event)
+{
+	if (Event.IsDone())
 	{
 		return;
 	}
 
-	FString NewData = CurrentContent.Mid(LastProcessedOffset);
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Stream new data: %s"), *NewData.Left(200));
-	LastProcessedOffset = CurrentContent.Len();
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Event.Data);
+	if (!Root.IsObject())
+	{
+		return;
+	}
 
-	// Parse SSE data
-	TArray<FString> Lines;
-	NewData.ParseIntoArrayLines(Lines);
+	FString Delta;
 
-	for (const FString& Line : Lines)
+	// Try UI Message Stream format first (type, delta)
+	const FPlayKitJsonView Type = Root.Find("type");
+	if (Type.IsString())
 	{
-		if (Line.StartsWith(TEXT("data: ")))
+		// Handle other types like "start", "finish" if needed
+		if (Type.StringEquals("text-delta"))
 		{
-			FString JsonStr = Line.Mid(6).TrimStartAndEnd();
+			Delta = Root.Find("delta").AsString();
+		}
+	}
+	else
+	{
+		// Fallback to legacy OpenAI format (choices, delta)
+		Delta = Root.Find("choices").At(0).Find("delta").Find("content").AsString();
+	}
 
-			if (JsonStr == TEXT("[DONE]"))
-			{
-				continue;
-			}
+	if (Delta.IsEmpty())
+	{
+		return;
+	}
 
-			TSharedPtr<FJsonObject> JsonObject;
-			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonStr);
-			if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
-			{
-				// Try UI Message Stream format first (type, delta)
-				FString Type;
-				if (JsonObject->TryGetStringField(TEXT("type"), Type))
-				{
-					if (Type == TEXT("text-delta"))
-					{
-						FString Delta;
-						if (JsonObject->TryGetStringField(TEXT("delta"), Delta) && !Delta.IsEmpty())
-						{
-							AccumulatedContent += Delta;
-							OnStreamChunk.Broadcast(Delta);
-						}
-					}
-					// Handle other types like "start", "finish" if needed
-					continue;
-				}
-
-				// Fallback to legacy OpenAI format (choices, delta)
-				const TArray<TSharedPtr<FJsonValue>>* Choices;
-				if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
-				{
-					TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-					const TSharedPtr<FJsonObject>* DeltaPtr;
-					if (Choice && Choice->TryGetObjectField(TEXT("delta"), DeltaPtr) && DeltaPtr)
-					{
-						FString Content;
-						if ((*DeltaPtr)->TryGetStringField(TEXT("content"), Content) && !Content.IsEmpty())
-						{
-							AccumulatedContent += Content;
-							OnStreamChunk.Broadcast(Content);
-						}
-					}
-				}
-			}
-		}
+	if (!State.bFirstTokenNoted)
+	{
+		State.bFirstTokenNoted = true;
+		UPlayKitMetrics::NoteFirstToken(this, State.HttpRequest);
+	}
+
+	if (State.PartialObject.IsValid())
+	{
+		ProcessStructuredDelta(*State.PartialObject, RequestId, Delta);
+		return;
+	}
+
+	State.AccumulatedContent += Delta;
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
+	OnStreamChunk.Broadcast(Delta);
+	OnRequestStreamChunk.Broadcast(RequestId, Delta);
+}
+
+void UPlayKitChatClient::ProcessStructuredDelta(FPlayKitPartialJson& PartialObject, int32 RequestId, FStringView Delta)
+{
+	PartialObject.Append(Delta);
+
+	TArray<FPlayKitPartialJsonField> Fields;
+	PartialObject.ConsumeCompletedFields(Fields);
+	if (Fields.Num() == 0)
+	{
+		return;
+	}
+
+	// One snapshot per delta; it already includes every field completed in it
+	const FString Snapshot = PartialObject.GetRepairedJson();
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
+	for (const FPlayKitPartialJsonField& Field : Fields)
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Structured request %d field complete: %s"), RequestId, *Field.Key);
+		OnStructuredPartial.Broadcast(RequestId, Field.Key, Field.GetValueString(), Snapshot);
+	}
+}
+
+void UPlayKitChatClient::FinishStructuredStream(FChatRequestState& State, int32 RequestId)
+{
+	if (!State.PartialObject->IsComplete())
+	{
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Structured stream %d ended before the object was complete"), RequestId);
+		BroadcastStructuredResult(RequestId, false, TEXT("{\"error\": \"Incomplete structured stream\"}"));
+		return;
 	}
+
+	const FString ResultStr = State.PartialObject->GetCompletedJson();
+	UPlayKitMetrics::NoteGeneratedTokens(this, State.HttpRequest, UPlayKitMetrics::EstimateTokenCount(ResultStr));
+	StoreInCache(State.CacheKey, ResultStr);
+	BroadcastStructuredResult(RequestId, true, ResultStr);
 }
 
-void UPlayKitChatClient::HandleStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UPlayKitChatClient::HandleStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId)
 {
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] HandleStreamComplete called - bWasSuccessful: %d"), bWasSuccessful);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] HandleStreamComplete called for request %d - bWasSuccessful: %d"), RequestId, bWasSuccessful);
 
-	bIsProcessing = false;
-	CurrentRequest.Reset();
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		// Cancelled
+		return;
+	}
+
+	const bool bStructured = State->PartialObject.IsValid();
 
 	if (!bWasSuccessful)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Stream request failed"));
-		BroadcastError(TEXT("NETWORK_ERROR"), TEXT("Stream request failed"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Stream request failed"));
+		if (bStructured)
+		{
+			BroadcastStructuredResult(RequestId, false, TEXT("{\"error\": \"Network request failed\"}"));
+		}
+		else
+		{
+			BroadcastError(RequestId, TEXT("NETWORK_ERROR"), TEXT("Stream request failed"));
+		}
 		return;
 	}
 
 	if (Response.IsValid())
 	{
 		int32 ResponseCode = Response->GetResponseCode();
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Stream complete - Response code: %d"), ResponseCode);
+		UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Stream complete - Response code: %d"), ResponseCode);
 		if (ResponseCode < 200 || ResponseCode >= 300)
 		{
-			UE_LOG(LogTemp, Error, TEXT("[PlayKit] Stream error: %s"), *Response->GetContentAsString());
-			BroadcastError(FString::FromInt(ResponseCode), Response->GetContentAsString());
+			UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Stream error: %s"), *Response->GetContentAsString());
+			if (bStructured)
+			{
+				BroadcastStructuredResult(RequestId, false, Response->GetContentAsString());
+			}
+			else
+			{
+				BroadcastError(RequestId, FString::FromInt(ResponseCode), Response->GetContentAsString());
+			}
 			return;
 		}
-	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Stream complete - Accumulated content length: %d"), AccumulatedContent.Len());
-	OnStreamComplete.Broadcast(AccumulatedContent);
-}
+		// Drain bytes that arrived after the last progress tick, plus any unterminated final event
+		PLAYKIT_SCOPE(STAT_PlayKit_ParseStreamChunk, "PlayKit::Chat::StreamChunk");
+		TArray<FPlayKitSSEEvent> Events;
+		State->StreamDecoder.ConsumeResponse(Response->GetContent(), Events);
+		State->StreamDecoder.Finish(Events);
+		for (const FPlayKitSSEEvent& Event : Events)
+		{
+			ProcessStreamEvent(*State, RequestId, Event);
+		}
+	}
 
-void UPlayKitChatClient::GenerateStructured(const FString& Prompt, const FString& SchemaJson)
-{
-	if (bIsProcessing)
+	if (bStructured)
 	{
-		OnStructuredResponse.Broadcast(false, TEXT("{\"error\": \"Request already in progress\"}"));
+		FinishStructuredStream(*State, RequestId);
 		return;
 	}
 
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Stream %d complete - Accumulated content length: %d"), RequestId, State->AccumulatedContent.Len());
+	UPlayKitMetrics::NoteGeneratedTokens(this, State->HttpRequest, UPlayKitMetrics::EstimateTokenCount(State->AccumulatedContent));
+	if (!State->AccumulatedContent.IsEmpty())
+	{
+		StoreInCache(State->CacheKey, State->AccumulatedContent);
+	}
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
+	OnStreamComplete.Broadcast(State->AccumulatedContent);
+	OnRequestStreamComplete.Broadcast(RequestId, State->AccumulatedContent);
+}
+
+int32 UPlayKitChatClient::GenerateStructured(const FString& Prompt, const FString& SchemaJson, bool bBypassCache)
+{
+	return SendStructuredRequest(Prompt, SchemaJson, bBypassCache, false);
+}
+
+int32 UPlayKitChatClient::GenerateStructuredStream(const FString& Prompt, const FString& SchemaJson, bool bBypassCache)
+{
+	return SendStructuredRequest(Prompt, SchemaJson, bBypassCache, true);
+}
+
+int32 UPlayKitChatClient::SendStructuredRequest(const FString& Prompt, const FString& SchemaJson, bool bBypassCache, bool bStream)
+{
+	const int32 RequestId = AllocateRequestId();
+
 	// Use the same /v2/chat endpoint with schema parameters
 	FString Url = BuildRequestUrl();
 	if (Url.IsEmpty())
 	{
-		OnStructuredResponse.Broadcast(false, TEXT("{\"error\": \"Failed to build request URL\"}"));
-		return;
+		BroadcastStructuredResult(RequestId, false, TEXT("{\"error\": \"Failed to build request URL\"}"));
+		return RequestId;
 	}
 
-	bIsProcessing = true;
+	// Validate the schema and condense it; the condensed form is both sent and used as the cache key
+	TSharedPtr<FJsonObject> SchemaObject;
+	TSharedRef<TJsonReader<>> SchemaReader = TJsonReaderFactory<>::Create(SchemaJson);
+	if (!FJsonSerializer::Deserialize(SchemaReader, SchemaObject) || !SchemaObject.IsValid())
+	{
+		BroadcastStructuredResult(RequestId, false, TEXT("{\"error\": \"Invalid schema JSON\"}"));
+		return RequestId;
+	}
 
-	// Build messages array
-	TArray<TSharedPtr<FJsonValue>> MessagesArray;
+	FString CanonicalSchema;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> SchemaWriter =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&CanonicalSchema);
+	FJsonSerializer::Serialize(SchemaObject.ToSharedRef(), SchemaWriter);
 
-	if (!SystemPrompt.IsEmpty())
+	FString CacheKey;
+	if (bUseResponseCache && !bBypassCache)
 	{
-		TSharedPtr<FJsonObject> SystemMsg = MakeShared<FJsonObject>();
-		SystemMsg->SetStringField(TEXT("role"), TEXT("system"));
-		SystemMsg->SetStringField(TEXT("content"), SystemPrompt);
-		MessagesArray.Add(MakeShared<FJsonValueObject>(SystemMsg));
-	}
+		FPlayKitChatConfig KeyConfig;
+		if (!SystemPrompt.IsEmpty())
+		{
+			KeyConfig.Messages.Add(FPlayKitChatMessage(TEXT("system"), SystemPrompt));
+		}
+		KeyConfig.Messages.Add(FPlayKitChatMessage(TEXT("user"), Prompt));
+		KeyConfig.Temperature = Temperature;
 
-	TSharedPtr<FJsonObject> UserMsg = MakeShared<FJsonObject>();
-	UserMsg->SetStringField(TEXT("role"), TEXT("user"));
-	UserMsg->SetStringField(TEXT("content"), Prompt);
-	MessagesArray.Add(MakeShared<FJsonValueObject>(UserMsg));
+		// Streamed and whole requests share entries: the cached value is the final object either way
+		CacheKey = MakeCacheKey(TEXT("structured"), KeyConfig, CanonicalSchema);
+		if (TryServeFromCache(RequestId, CacheKey, bStream ? ECachedDelivery::StructuredStream : ECachedDelivery::Structured))
+		{
+			return RequestId;
+		}
+	}
 
 	// Build request body using v2 chat format with schema
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), ModelName);
-	RequestBody->SetArrayField(TEXT("messages"), MessagesArray);
-	RequestBody->SetBoolField(TEXT("stream"), false);
-	RequestBody->SetNumberField(TEXT("temperature"), Temperature);
-	RequestBody->SetStringField(TEXT("output"), TEXT("object"));
-	RequestBody->SetStringField(TEXT("schemaName"), TEXT("response"));
-	RequestBody->SetStringField(TEXT("schemaDescription"), TEXT(""));
-
-	// Parse schema JSON
-	TSharedPtr<FJsonObject> SchemaObject;
-	TSharedRef<TJsonReader<>> SchemaReader = TJsonReaderFactory<>::Create(SchemaJson);
-	if (FJsonSerializer::Deserialize(SchemaReader, SchemaObject) && SchemaObject.IsValid())
+	TArray<uint8> Body;
+	{
+		PLAYKIT_SCOPE(STAT_PlayKit_BuildBody, "PlayKit::Chat::BuildBody");
+
+		FPlayKitJsonWriter Json(SystemPrompt.Len() + Prompt.Len() + CanonicalSchema.Len() + 256);
+		Json.BeginObject();
+		Json.WriteStringField("model", ModelName);
+
+		Json.WriteKey("messages");
+		Json.BeginArray();
+		if (!SystemPrompt.IsEmpty())
+		{
+			Json.WriteMessage(TEXT("system"), SystemPrompt);
+		}
+		Json.WriteMessage(TEXT("user"), Prompt);
+		Json.EndArray();
+
+		Json.WriteBoolField("stream", bStream);
+		Json.WriteNumberField("temperature", Temperature);
+		Json.WriteStringField("output", TEXT("object"));
+		Json.WriteStringField("schemaName", TEXT("response"));
+		Json.WriteStringField("schemaDescription", TEXT(""));
+		Json.WriteKey("schema");
+		Json.WriteRawValue(CanonicalSchema);
+		Json.EndObject();
+		Body = Json.Finish();
+	}
+
+	TSharedPtr<FChatRequestState> State = MakeShared<FChatRequestState>();
+	State->CacheKey = CacheKey;
+	State->HttpRequest = CreateAuthenticatedRequest(Url);
+	State->HttpRequest->SetContent(MoveTemp(Body));
+
+	if (bStream)
 	{
-		RequestBody->SetObjectField(TEXT("schema"), SchemaObject);
+		State->PartialObject = MakeUnique<FPlayKitPartialJson>();
+		State->HttpRequest->OnRequestProgress64().BindUObject(this, &UPlayKitChatClient::HandleStreamProgress, RequestId);
+		State->HttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleStreamComplete, RequestId);
 	}
 	else
 	{
-		bIsProcessing = false;
-		OnStructuredResponse.Broadcast(false, TEXT("{\"error\": \"Invalid schema JSON\"}"));
-		return;
+		State->HttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleStructuredResponse, RequestId);
 	}
 
-	// Serialize
-	FString RequestBodyStr;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyStr);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
-
-	CurrentRequest = CreateAuthenticatedRequest(Url);
-	CurrentRequest->SetContentAsString(RequestBodyStr);
-	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleStructuredResponse);
-
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Sending structured request to: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Sending %s structured request %d to: %s"), bStream ? TEXT("streaming") : TEXT("non-streaming"), RequestId, *Url);
+	SubmitRequest(RequestId, State, bStream ? ECachedDelivery::StructuredStream : ECachedDelivery::Structured);
+	return RequestId;
 }
 
-void UPlayKitChatClient::HandleStructuredResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UPlayKitChatClient::HandleStructuredResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId)
 {
-	bIsProcessing = false;
-	CurrentRequest.Reset();
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		// Cancelled
+		return;
+	}
 
 	if (!bWasSuccessful || !Response.IsValid())
 	{
-		OnStructuredResponse.Broadcast(false, TEXT("{\"error\": \"Network request failed\"}"));
+		BroadcastStructuredResult(RequestId, false, TEXT("{\"error\": \"Network request failed\"}"));
 		return;
 	}
 
 	int32 ResponseCode = Response->GetResponseCode();
-	FString ResponseContent = Response->GetContentAsString();
 
 	if (ResponseCode < 200 || ResponseCode >= 300)
 	{
-		OnStructuredResponse.Broadcast(false, ResponseContent);
+		BroadcastStructuredResult(RequestId, false, Response->GetContentAsString());
 		return;
 	}
 
-	// Parse response to extract the object
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
-	if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::Chat::ParseStructured");
+
+	// Extract the object as-is, without rebuilding it
+	const FPlayKitJsonView Object = FPlayKitJsonView::Parse(Response->GetContent()).Find("object");
+	if (Object.IsObject())
 	{
-		const TSharedPtr<FJsonObject>* ObjectResultPtr;
-		if (JsonObject->TryGetObjectField(TEXT("object"), ObjectResultPtr) && ObjectResultPtr)
-		{
-			FString ResultStr;
-			TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultStr);
-			FJsonSerializer::Serialize((*ObjectResultPtr).ToSharedRef(), Writer);
-			OnStructuredResponse.Broadcast(true, ResultStr);
-			return;
-		}
+		const FString ResultStr = Object.GetRawJson();
+		UPlayKitMetrics::NoteGeneratedTokens(this, State->HttpRequest, UPlayKitMetrics::EstimateTokenCount(ResultStr));
+		StoreInCache(State->CacheKey, ResultStr);
+		BroadcastStructuredResult(RequestId, true, ResultStr);
+		return;
 	}
 
-	OnStructuredResponse.Broadcast(true, ResponseContent);
+	BroadcastStructuredResult(RequestId, true, Response->GetContentAsString());
 }
 
-FPlayKitChatResponse UPlayKitChatClient::ParseChatResponse(const FString& ResponseContent)
+FPlayKitChatResponse UPlayKitChatClient::ParseChatResponse(const TArray<uint8>& ResponseContent)
 {
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::Chat::ParseResponse");
+
 	FPlayKitChatResponse Result;
 
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
-	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(ResponseContent);
+	if (!Root.IsObject())
 	{
 		Result.bSuccess = false;
 		Result.ErrorMessage = TEXT("Failed to parse response JSON");
@@ -463,54 +617,38 @@ FPlayKitChatResponse UPlayKitChatClient::ParseChatResponse(const FString& Respon
 	Result.bSuccess = true;
 
 	// Parse choices
-	const TArray<TSharedPtr<FJsonValue>>* Choices;
-	if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
+	const FPlayKitJsonView Choice = Root.Find("choices").At(0);
+	if (Choice.IsObject())
 	{
-		TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-		if (Choice)
-		{
-			Choice->TryGetStringField(TEXT("finish_reason"), Result.FinishReason);
+		Choice.Find("finish_reason").TryGetString(Result.FinishReason);
 
-			const TSharedPtr<FJsonObject>* MessagePtr;
-			if (Choice->TryGetObjectField(TEXT("message"), MessagePtr) && MessagePtr)
+		const FPlayKitJsonView Message = Choice.Find("message");
+		Message.Find("content").TryGetString(Result.Content);
+
+		// Parse tool calls
+		Message.Find("tool_calls").ForEachElement([&Result](const FPlayKitJsonView& ToolCallValue)
+		{
+			if (ToolCallValue.IsObject())
 			{
-				(*MessagePtr)->TryGetStringField(TEXT("content"), Result.Content);
-
-				// Parse tool calls
-				const TArray<TSharedPtr<FJsonValue>>* ToolCalls;
-				if ((*MessagePtr)->TryGetArrayField(TEXT("tool_calls"), ToolCalls))
-				{
-					for (const TSharedPtr<FJsonValue>& ToolCallValue : *ToolCalls)
-					{
-						TSharedPtr<FJsonObject> ToolCallObj = ToolCallValue->AsObject();
-						if (ToolCallObj)
-						{
-							FPlayKitToolCall ToolCall;
-							ToolCallObj->TryGetStringField(TEXT("id"), ToolCall.Id);
-							ToolCallObj->TryGetStringField(TEXT("type"), ToolCall.Type);
-
-							const TSharedPtr<FJsonObject>* FunctionPtr;
-							if (ToolCallObj->TryGetObjectField(TEXT("function"), FunctionPtr) && FunctionPtr)
-							{
-								(*FunctionPtr)->TryGetStringField(TEXT("name"), ToolCall.FunctionName);
-								(*FunctionPtr)->TryGetStringField(TEXT("arguments"), ToolCall.FunctionArguments);
-							}
-
-							Result.ToolCalls.Add(ToolCall);
-						}
-					}
-				}
+				FPlayKitToolCall& ToolCall = Result.ToolCalls.AddDefaulted_GetRef();
+				ToolCallValue.Find("id").TryGetString(ToolCall.Id);
+				ToolCallValue.Find("type").TryGetString(ToolCall.Type);
+
+				const FPlayKitJsonView Function = ToolCallValue.Find("function");
+				Function.Find("name").TryGetString(ToolCall.FunctionName);
+				Function.Find("arguments").TryGetString(ToolCall.FunctionArguments);
 			}
-		}
+			return true;
+		});
 	}
 
 	// Parse usage
-	const TSharedPtr<FJsonObject>* UsagePtr;
-	if (JsonObject->TryGetObjectField(TEXT("usage"), UsagePtr) && UsagePtr)
+	const FPlayKitJsonView Usage = Root.Find("usage");
+	if (Usage.IsObject())
 	{
-		(*UsagePtr)->TryGetNumberField(TEXT("prompt_tokens"), Result.PromptTokens);
-		(*UsagePtr)->TryGetNumberField(TEXT("completion_tokens"), Result.CompletionTokens);
-		(*UsagePtr)->TryGetNumberField(TEXT("total_tokens"), Result.TotalTokens);
+		Result.PromptTokens = Usage.Find("prompt_tokens").AsInt();
+		Result.CompletionTokens = Usage.Find("completion_tokens").AsInt();
+		Result.TotalTokens = Usage.Find("total_tokens").AsInt();
 	}
 
 	return Result;
@@ -518,22 +656,381 @@ FPlayKitChatResponse UPlayKitChatClient::ParseChatResponse(const FString& Respon
 
 void UPlayKitChatClient::CancelRequest()
 {
-	if (CurrentRequest.IsValid())
+	// Drop batches first so their items do not start replacements as they are cancelled
+	ActiveBatches.Empty();
+
+	TArray<int32> RequestIds;
+	ActiveRequests.GetKeys(RequestIds);
+	for (int32 RequestId : RequestIds)
 	{
-		CurrentRequest->CancelRequest();
-		CurrentRequest.Reset();
+		CancelRequestById(RequestId);
 	}
-	bIsProcessing = false;
 }
 
-void UPlayKitChatClient::BroadcastError(const FString& ErrorCode, const FString& ErrorMessage)
+void UPlayKitChatClient::CancelRequestById(int32 RequestId)
 {
-	UE_LOG(LogTemp, Error, TEXT("[PlayKit] Chat error [%s]: %s"), *ErrorCode, *ErrorMessage);
+	if (ActiveBatches.Contains(RequestId))
+	{
+		CancelBatch(RequestId);
+		return;
+	}
+
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		return;
+	}
+
+	// A request still waiting on the disk cache was never handed to the scheduler
+	if (State->HttpRequest.IsValid() && !State->bAwaitingCache)
+	{
+		State->HttpRequest->OnRequestProgress64().Unbind();
+		State->HttpRequest->OnProcessRequestComplete().Unbind();
+		UPlayKitRequestScheduler::Cancel(this, State->HttpRequest);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Chat request %d cancelled"), RequestId);
+}
+
+void UPlayKitChatClient::BroadcastError(int32 RequestId, const FString& ErrorCode, const FString& ErrorMessage)
+{
+	UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Chat error [%s] on request %d: %s"), *ErrorCode, RequestId, *ErrorMessage);
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
 	OnError.Broadcast(ErrorCode, ErrorMessage);
+	OnRequestError.Broadcast(RequestId, ErrorCode, ErrorMessage);
 
 	// Also broadcast a failed response
 	FPlayKitChatResponse FailedResponse;
 	FailedResponse.bSuccess = false;
+	FailedResponse.RequestId = RequestId;
 	FailedResponse.ErrorMessage = ErrorMessage;
 	OnChatResponse.Broadcast(FailedResponse);
 }
+
+void UPlayKitChatClient::BroadcastStructuredResult(int32 RequestId, bool bSuccess, const FString& JsonResult)
+{
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
+	OnStructuredResponse.Broadcast(bSuccess, JsonResult);
+	OnStructuredRequestResponse.Broadcast(RequestId, bSuccess, JsonResult);
+}
+
+//========== Batch Generation ==========//
+
+int32 UPlayKitChatClient::GenerateTextBatch(const TArray<FPlayKitChatConfig>& Configs, int32 MaxConcurrency)
+{
+	const int32 BatchId = AllocateRequestId();
+
+	TSharedPtr<FChatBatchState> Batch = MakeShared<FChatBatchState>();
+	Batch->Configs = Configs;
+	Batch->Responses.SetNum(Configs.Num());
+
+	if (MaxConcurrency <= 0)
+	{
+		UPlayKitSettings* Settings = UPlayKitSettings::Get();
+		MaxConcurrency = Settings ? Settings->MaxConcurrentChatRequests : 4;
+	}
+	Batch->MaxConcurrency = FMath::Max(1, MaxConcurrency);
+
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Starting batch %d: %d items, %d at a time"), BatchId, Configs.Num(), Batch->MaxConcurrency);
+
+	if (Configs.Num() == 0)
+	{
+		FPlayKitChatBatchResult Result;
+		Result.BatchId = BatchId;
+		OnBatchComplete.Broadcast(Result);
+		return BatchId;
+	}
+
+	if (BuildRequestUrl().IsEmpty())
+	{
+		// Not an item failure: the batch never started, so report it like any other request
+		BroadcastError(BatchId, TEXT("CONFIG_ERROR"), TEXT("Failed to build request URL"));
+
+		FPlayKitChatBatchResult Result;
+		Result.BatchId = BatchId;
+		Result.Responses = MoveTemp(Batch->Responses);
+		for (FPlayKitChatResponse& ItemResponse : Result.Responses)
+		{
+			ItemResponse.ErrorMessage = TEXT("Failed to build request URL");
+		}
+		Result.FailedCount = Result.Responses.Num();
+		OnBatchComplete.Broadcast(Result);
+		return BatchId;
+	}
+
+	ActiveBatches.Add(BatchId, Batch);
+	PumpBatch(BatchId);
+	return BatchId;
+}
+
+void UPlayKitChatClient::PumpBatch(int32 BatchId)
+{
+	TSharedPtr<FChatBatchState> Batch = ActiveBatches.FindRef(BatchId);
+	if (!Batch.IsValid())
+	{
+		return;
+	}
+
+	const FString Url = BuildRequestUrl();
+	while (Batch->InFlightRequestIds.Num() < Batch->MaxConcurrency && Batch->NextIndex < Batch->Configs.Num())
+	{
+		StartBatchItem(*Batch, BatchId, Batch->NextIndex++, Url);
+	}
+}
+
+void UPlayKitChatClient::StartBatchItem(FChatBatchState& Batch, int32 BatchId, int32 Index, const FString& Url)
+{
+	const FPlayKitChatConfig& Config = Batch.Configs[Index];
+	const int32 RequestId = AllocateRequestId();
+	Batch.InFlightRequestIds.Add(RequestId);
+
+	// Cache hits are delivered on the next tick, so nothing here completes the item in place
+	const FString CacheKey = MakeCacheKey(TEXT("text"), Config);
+	if (TSharedPtr<FChatRequestState> CachedState = TryServeFromCache(RequestId, CacheKey, ECachedDelivery::BatchItem))
+	{
+		CachedState->BatchId = BatchId;
+		CachedState->BatchIndex = Index;
+		return;
+	}
+
+	TSharedPtr<FChatRequestState> State = MakeShared<FChatRequestState>();
+	State->CacheKey = CacheKey;
+	State->BatchId = BatchId;
+	State->BatchIndex = Index;
+	State->HttpRequest = CreateAuthenticatedRequest(Url);
+	State->HttpRequest->SetContent(BuildChatBody(Config, false));
+	State->HttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitChatClient::HandleBatchItemResponse, RequestId);
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Batch %d item %d sent as request %d"), BatchId, Index, RequestId);
+	SubmitRequest(RequestId, State, ECachedDelivery::BatchItem);
+}
+
+void UPlayKitChatClient::HandleBatchItemResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId)
+{
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		// Cancelled
+		return;
+	}
+
+	FPlayKitChatResponse ChatResponse;
+	if (!bWasSuccessful || !Response.IsValid())
+	{
+		ChatResponse.ErrorMessage = TEXT("Network request failed");
+	}
+	else if (Response->GetResponseCode() < 200 || Response->GetResponseCode() >= 300)
+	{
+		ChatResponse.ErrorMessage = FString::Printf(TEXT("HTTP %d: %s"), Response->GetResponseCode(), *Response->GetContentAsString());
+	}
+	else
+	{
+		ChatResponse = ParseChatResponse(Response->GetContent());
+		UPlayKitMetrics::NoteGeneratedTokens(this, State->HttpRequest, ChatResponse.CompletionTokens > 0
+			? ChatResponse.CompletionTokens : UPlayKitMetrics::EstimateTokenCount(ChatResponse.Content));
+		if (ChatResponse.bSuccess && ChatResponse.ToolCalls.Num() == 0 && !ChatResponse.Content.IsEmpty())
+		{
+			StoreInCache(State->CacheKey, ChatResponse.Content, ChatResponse.FinishReason);
+		}
+	}
+
+	if (!ChatResponse.bSuccess)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[PlayKit] Batch %d item %d failed: %s"), State->BatchId, State->BatchIndex, *ChatResponse.ErrorMessage);
+	}
+
+	CompleteBatchItem(State->BatchId, State->BatchIndex, RequestId, MoveTemp(ChatResponse));
+}
+
+void UPlayKitChatClient::CompleteBatchItem(int32 BatchId, int32 Index, int32 RequestId, FPlayKitChatResponse&& Response)
+{
+	TSharedPtr<FChatBatchState> Batch = ActiveBatches.FindRef(BatchId);
+	if (!Batch.IsValid())
+	{
+		return;
+	}
+
+	Response.RequestId = RequestId;
+	Batch->Responses[Index] = MoveTemp(Response);
+	Batch->InFlightRequestIds.RemoveSingleSwap(RequestId);
+	Batch->CompletedCount++;
+
+	if (Batch->CompletedCount < Batch->Configs.Num())
+	{
+		PumpBatch(BatchId);
+		return;
+	}
+
+	ActiveBatches.Remove(BatchId);
+
+	FPlayKitChatBatchResult Result;
+	Result.BatchId = BatchId;
+	Result.Responses = MoveTemp(Batch->Responses);
+	for (const FPlayKitChatResponse& ItemResponse : Result.Responses)
+	{
+		if (ItemResponse.bSuccess)
+		{
+			Result.SucceededCount++;
+		}
+		else
+		{
+			Result.FailedCount++;
+		}
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Batch %d complete: %d succeeded, %d failed"), BatchId, Result.SucceededCount, Result.FailedCount);
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::Chat::Broadcast");
+	OnBatchComplete.Broadcast(Result);
+}
+
+void UPlayKitChatClient::CancelBatch(int32 BatchId)
+{
+	TSharedPtr<FChatBatchState> Batch;
+	if (!ActiveBatches.RemoveAndCopyValue(BatchId, Batch) || !Batch.IsValid())
+	{
+		return;
+	}
+
+	for (int32 RequestId : Batch->InFlightRequestIds)
+	{
+		CancelRequestById(RequestId);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Batch %d cancelled"), BatchId);
+}
+
+//========== Response Cache ==========//
+
+FString UPlayKitChatClient::MakeCacheKey(const FString& Kind, const FPlayKitChatConfig& Config, const FString& CanonicalSchema) const
+{
+	if (!bUseResponseCache || Config.bBypassCache)
+	{
+		return FString();
+	}
+	return UPlayKitResponseCache::MakeChatKey(Kind, ModelName, Config, CanonicalSchema);
+}
+
+TSharedPtr<UPlayKitChatClient::FChatRequestState> UPlayKitChatClient::TryServeFromCache(int32 RequestId, const FString& CacheKey, ECachedDelivery Delivery)
+{
+	if (CacheKey.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	UPlayKitResponseCache* Cache = UPlayKitResponseCache::Get(this);
+	UWorld* World = GetWorld();
+	FPlayKitCachedResponse Cached;
+	if (!Cache || !World || !Cache->Find(CacheKey, Cached))
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Request %d served from response cache"), RequestId);
+
+	// Deliver on the next tick so callers get the request ID before any event fires,
+	// and so the request can still be cancelled like a network one
+	TSharedPtr<FChatRequestState> State = MakeShared<FChatRequestState>();
+	ActiveRequests.Add(RequestId, State);
+	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(
+		this, &UPlayKitChatClient::DeliverCachedResponse, RequestId, Delivery, Cached.Content, Cached.FinishReason));
+	return State;
+}
+
+void UPlayKitChatClient::SubmitRequest(int32 RequestId, const TSharedPtr<FChatRequestState>& State, ECachedDelivery Delivery)
+{
+	ActiveRequests.Add(RequestId, State);
+
+	// The memory tier has already missed; the disk tier is read off the game thread before sending
+	UPlayKitResponseCache* Cache = State->CacheKey.IsEmpty() ? nullptr : UPlayKitResponseCache::Get(this);
+	State->bAwaitingCache = Cache && Cache->FindOnDisk(State->CacheKey,
+		[WeakThis = TWeakObjectPtr<UPlayKitChatClient>(this), RequestId, Delivery](bool bFound, const FPlayKitCachedResponse& Cached)
+		{
+			UPlayKitChatClient* This = WeakThis.Get();
+			const TSharedPtr<FChatRequestState> PendingState = This ? This->FindRequestState(RequestId) : nullptr;
+			if (!PendingState.IsValid() || !PendingState->bAwaitingCache)
+			{
+				// Cancelled while the disk was read
+				return;
+			}
+
+			PendingState->bAwaitingCache = false;
+			if (bFound)
+			{
+				UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Request %d served from disk cache"), RequestId);
+				This->DeliverCachedResponse(RequestId, Delivery, Cached.Content, Cached.FinishReason);
+				return;
+			}
+
+			UPlayKitRequestScheduler::Submit(This, PendingState->HttpRequest.ToSharedRef(), This->RequestPriority, EPlayKitEndpoint::Chat, This->ModelName);
+		});
+
+	if (!State->bAwaitingCache)
+	{
+		UPlayKitRequestScheduler::Submit(this, State->HttpRequest.ToSharedRef(), RequestPriority, EPlayKitEndpoint::Chat, ModelName);
+	}
+}
+
+void UPlayKitChatClient::DeliverCachedResponse(int32 RequestId, ECachedDelivery Delivery, const FString& Content, const FString& FinishReason)
+{
+	TSharedPtr<FChatRequestState> State;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, State) || !State.IsValid())
+	{
+		// Cancelled
+		return;
+	}
+
+	switch (Delivery)
+	{
+	case ECachedDelivery::Text:
+		{
+			FPlayKitChatResponse ChatResponse;
+			ChatResponse.bSuccess = true;
+			ChatResponse.RequestId = RequestId;
+			ChatResponse.Content = Content;
+			ChatResponse.FinishReason = FinishReason;
+			OnChatResponse.Broadcast(ChatResponse);
+			break;
+		}
+	case ECachedDelivery::Stream:
+		OnStreamChunk.Broadcast(Content);
+		OnRequestStreamChunk.Broadcast(RequestId, Content);
+		OnStreamComplete.Broadcast(Content);
+		OnRequestStreamComplete.Broadcast(RequestId, Content);
+		break;
+	case ECachedDelivery::Structured:
+		BroadcastStructuredResult(RequestId, true, Content);
+		break;
+	case ECachedDelivery::StructuredStream:
+		{
+			// Replay the stored object through the parser so field events still fire
+			FPlayKitPartialJson PartialObject;
+			ProcessStructuredDelta(PartialObject, RequestId, Content);
+			BroadcastStructuredResult(RequestId, true, Content);
+			break;
+		}
+	case ECachedDelivery::BatchItem:
+		{
+			FPlayKitChatResponse ChatResponse;
+			ChatResponse.bSuccess = true;
+			ChatResponse.Content = Content;
+			ChatResponse.FinishReason = FinishReason;
+			CompleteBatchItem(State->BatchId, State->BatchIndex, RequestId, MoveTemp(ChatResponse));
+			break;
+		}
+	}
+}
+
+void UPlayKitChatClient::StoreInCache(const FString& CacheKey, const FString& Content, const FString& FinishReason)
+{
+	if (CacheKey.IsEmpty())
+	{
+		return;
+	}
+
+	if (UPlayKitResponseCache* Cache = UPlayKitResponseCache::Get(this))
+	{
+		Cache->Store(CacheKey, Content, FinishReason);
+	}
+}
@@ -6,6 +6,9 @@
 #include "Components/ActorComponent.h"
 #include "Interfaces/IHttpRequest.h"
 #include "PlayKitTypes.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Tool/PlayKitSSEDecoder.h"
+#include "Tool/PlayKitPartialJson.h"
 #include "PlayKitChatClient.generated.h"
 
 /**
@@ -15,20 +18,29 @@
  * Features:
  * - Text generation (non-streaming)
  * - Streaming text generation
- * - Structured output generation
+ * - Structured output generation (whole or streamed field by field)
+ * - Batch generation of many independent prompts
  * - Tool calling support
+ * - Multiple concurrent requests per component
  *
  * Usage:
  * 1. Add this component to any Actor in the editor
  * 2. Configure properties in the Details panel (ModelName, Temperature, etc.)
  * 3. Bind to events using the "+" button (OnChatResponse, OnStreamChunk, etc.)
  * 4. Call GenerateText() or GenerateTextStream() to start generation
+ *
+ * Every Generate call returns a request ID. Several requests can run at the same
+ * time; use the ID-carrying events (OnRequestStreamChunk, OnRequestError, ...)
+ * or FPlayKitChatResponse::RequestId to tell them apart.
  */
 UCLASS(ClassGroup=(PlayKit), meta=(BlueprintSpawnableComponent))
 class PLAYKITSDK_API UPlayKitChatClient : public UActorComponent
 {
 	GENERATED_BODY()
 
+	// Benchmarks the private body building and parsing paths
+	friend class FPlayKitBenchmarks;
+
 public:
 	UPlayKitChatClient();
 
@@ -55,6 +67,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Chat", meta=(MultiLine=true))
 	FString SystemPrompt;
 
+	/** Scheduling priority for requests from this component. Use Background for non-urgent generations */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Chat")
+	EPlayKitRequestPriority RequestPriority = EPlayKitRequestPriority::Interactive;
+
+	/**
+	 * Serve repeated identical requests from UPlayKitResponseCache instead of the server.
+	 * Only enable for prompts whose answer should not change (see UPlayKitResponseCache).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Chat|Cache")
+	bool bUseResponseCache = false;
+
 	//========== Events (Click "+" to bind in Blueprint) ==========//
 
 	/** Fired when chat response is received (non-streaming) */
@@ -79,11 +102,54 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Structured")
 	FOnStructuredResponse OnStructuredResponse;
 
+	/**
+	 * Delegate for a top-level field completed during GenerateStructuredStream.
+	 * FieldValue is the decoded string for string fields and raw JSON otherwise;
+	 * PartialJson is the object so far, closed up into valid JSON.
+	 */
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnStructuredPartial, int32, RequestId, const FString&, FieldName, const FString&, FieldValue, const FString&, PartialJson);
+
+	/** Fired as each top-level field of a streamed structured object completes */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Structured")
+	FOnStructuredPartial OnStructuredPartial;
+
+	//========== Request Events (carry the request ID) ==========//
+
+	/** Fired for each chunk in streaming mode, with the request ID */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Requests")
+	FOnChatRequestStreamChunk OnRequestStreamChunk;
+
+	/** Fired when a streaming request completes, with the request ID */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Requests")
+	FOnChatRequestStreamComplete OnRequestStreamComplete;
+
+	/** Fired on error, with the request ID */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Requests")
+	FOnChatRequestError OnRequestError;
+
+	/** Delegate for structured output response with the request ID */
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnStructuredRequestResponse, int32, RequestId, bool, bSuccess, const FString&, JsonResult);
+
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Requests")
+	FOnStructuredRequestResponse OnStructuredRequestResponse;
+
+	/** Fired once when every item of a GenerateTextBatch call has finished */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|Chat|Batch")
+	FOnChatBatchComplete OnBatchComplete;
+
 	//========== Status ==========//
 
-	/** Check if a request is currently in progress */
+	/** Check if any request is currently in progress */
 	UFUNCTION(BlueprintPure, Category="PlayKit|Chat")
-	bool IsProcessing() const { return bIsProcessing; }
+	bool IsProcessing() const { return ActiveRequests.Num() > 0; }
+
+	/** Check if a specific request is still in progress */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Chat|Requests")
+	bool IsRequestActive(int32 RequestId) const { return ActiveRequests.Contains(RequestId); }
+
+	/** Get the number of requests currently in progress */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Chat|Requests")
+	int32 GetActiveRequestCount() const { return ActiveRequests.Num(); }
 
 	//========== Configuration Methods ==========//
 
@@ -101,31 +167,50 @@ public:
 	 * Generate text from a simple prompt (non-streaming).
 	 * Uses the component's configured ModelName and Temperature.
 	 * @param Prompt The user's message
+	 * @return Request ID
 	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat", meta=(DisplayName="Generate Text"))
-	void GenerateText(const FString& Prompt);
+	int32 GenerateText(const FString& Prompt);
 
 	/**
 	 * Generate text with full configuration (non-streaming).
 	 * @param Config Chat configuration with messages and settings
+	 * @return Request ID
 	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat", meta=(DisplayName="Generate Text (Advanced)"))
-	void GenerateTextAdvanced(const FPlayKitChatConfig& Config);
+	int32 GenerateTextAdvanced(const FPlayKitChatConfig& Config);
 
 	/**
 	 * Generate text with streaming response.
 	 * Each chunk fires OnStreamChunk, completion fires OnStreamComplete.
 	 * @param Prompt The user's message
+	 * @return Request ID
 	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat", meta=(DisplayName="Generate Text Stream"))
-	void GenerateTextStream(const FString& Prompt);
+	int32 GenerateTextStream(const FString& Prompt);
 
 	/**
 	 * Generate text with streaming and full configuration.
 	 * @param Config Chat configuration with messages and settings
+	 * @return Request ID
 	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat", meta=(DisplayName="Generate Text Stream (Advanced)"))
-	void GenerateTextStreamAdvanced(const FPlayKitChatConfig& Config);
+	int32 GenerateTextStreamAdvanced(const FPlayKitChatConfig& Config);
+
+	//========== Batch Generation ==========//
+
+	/**
+	 * Generate text for many independent configs (non-streaming).
+	 * At most MaxConcurrency items are in flight at once; the rest wait their turn.
+	 * Items do not fire the per-request events. OnBatchComplete fires once with
+	 * one response per config, in input order, including per-item failures.
+	 * If the request URL cannot be built, OnError also fires with the batch ID.
+	 * @param Configs One chat configuration per generation
+	 * @param MaxConcurrency Items in flight at once (0 = MaxConcurrentChatRequests from settings)
+	 * @return Batch ID, which can be passed to CancelRequestById
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat|Batch", meta=(DisplayName="Generate Text Batch"))
+	int32 GenerateTextBatch(const TArray<FPlayKitChatConfig>& Configs, int32 MaxConcurrency = 0);
 
 	//========== Structured Output ==========//
 
@@ -134,36 +219,119 @@ public:
 	 * The response will be a valid JSON object matching your schema.
 	 * @param Prompt The generation prompt
 	 * @param SchemaJson JSON schema defining the output structure
+	 * @param bBypassCache Skip the response cache for this call
+	 * @return Request ID
 	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat|Structured", meta=(DisplayName="Generate Structured"))
-	void GenerateStructured(const FString& Prompt, const FString& SchemaJson);
+	int32 GenerateStructured(const FString& Prompt, const FString& SchemaJson, bool bBypassCache = false);
+
+	/**
+	 * Generate a structured JSON object, streaming it as it is produced.
+	 * OnStructuredPartial fires as each top-level field completes, so early fields
+	 * (e.g. the line of dialogue) can be shown while later ones are still generating.
+	 * OnStructuredResponse fires with the whole object at the end.
+	 * @param Prompt The generation prompt
+	 * @param SchemaJson JSON schema defining the output structure
+	 * @param bBypassCache Skip the response cache for this call
+	 * @return Request ID
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat|Structured", meta=(DisplayName="Generate Structured Stream"))
+	int32 GenerateStructuredStream(const FString& Prompt, const FString& SchemaJson, bool bBypassCache = false);
 
 	//========== Cancel ==========//
 
-	/** Cancel any in-progress request */
+	/** Cancel all in-progress requests */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat")
 	void CancelRequest();
 
+	/** Cancel a single in-progress request, or a whole batch by its batch ID */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Chat|Requests")
+	void CancelRequestById(int32 RequestId);
+
 private:
-	void SendChatRequest(const FPlayKitChatConfig& Config, bool bStream);
-	void HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
-	void HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived);
-	void HandleStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
-	void HandleStructuredResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	/** Per-request state, so several generations can run on one component */
+	struct FChatRequestState
+	{
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
+		FPlayKitSSEDecoder StreamDecoder;
+		FString AccumulatedContent;
+
+		// Response cache key, empty when the result should not be cached
+		FString CacheKey;
+
+		// Set for streamed structured output; deltas are JSON text rather than chat text
+		TUniquePtr<FPlayKitPartialJson> PartialObject;
+
+		// The first streamed token has been reported to UPlayKitMetrics
+		bool bFirstTokenNoted = false;
+
+		// Built but not yet submitted: the disk cache is being read first
+		bool bAwaitingCache = false;
+
+		// Set for batch items: results go to the batch instead of the request events
+		int32 BatchId = 0;
+		int32 BatchIndex = INDEX_NONE;
+	};
+
+	/** A GenerateTextBatch call in progress */
+	struct FChatBatchState
+	{
+		TArray<FPlayKitChatConfig> Configs;
+		TArray<FPlayKitChatResponse> Responses;
+		TArray<int32, TInlineAllocator<8>> InFlightRequestIds;
+		int32 NextIndex = 0;
+		int32 CompletedCount = 0;
+		int32 MaxConcurrency = 1;
+	};
+
+	enum class ECachedDelivery : uint8
+	{
+		Text,
+		Stream,
+		Structured,
+		StructuredStream,
+		BatchItem
+	};
+
+	int32 SendChatRequest(const FPlayKitChatConfig& Config, bool bStream);
+	TArray<uint8> BuildChatBody(const FPlayKitChatConfig& Config, bool bStream) const;
+	int32 SendStructuredRequest(const FString& Prompt, const FString& SchemaJson, bool bBypassCache, bool bStream);
+	void HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId);
+	void HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, int32 RequestId);
+	void ProcessStreamEvent(FChatRequestState& State, int32 RequestId, const FPlayKitSSEEvent& Event);
+	void HandleStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId);
+	void HandleStructuredResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId);
+	void ProcessStructuredDelta(FPlayKitPartialJson& PartialObject, int32 RequestId, FStringView Delta);
+	void FinishStructuredStream(FChatRequestState& State, int32 RequestId);
+
+	// Batch helpers
+	void PumpBatch(int32 BatchId);
+	void StartBatchItem(FChatBatchState& Batch, int32 BatchId, int32 Index, const FString& Url);
+	void HandleBatchItemResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 RequestId);
+	void CompleteBatchItem(int32 BatchId, int32 Index, int32 RequestId, FPlayKitChatResponse&& Response);
+	void CancelBatch(int32 BatchId);
 
 	FString BuildRequestUrl() const;
 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateAuthenticatedRequest(const FString& Url);
-	FPlayKitChatResponse ParseChatResponse(const FString& ResponseContent);
-	void BroadcastError(const FString& ErrorCode, const FString& ErrorMessage);
+	FPlayKitChatResponse ParseChatResponse(const TArray<uint8>& ResponseContent);
+	void BroadcastError(int32 RequestId, const FString& ErrorCode, const FString& ErrorMessage);
+	void BroadcastStructuredResult(int32 RequestId, bool bSuccess, const FString& JsonResult);
 
-private:
-	bool bIsProcessing = false;
+	// Response cache helpers
+	FString MakeCacheKey(const FString& Kind, const FPlayKitChatConfig& Config, const FString& CanonicalSchema = FString()) const;
+	TSharedPtr<FChatRequestState> TryServeFromCache(int32 RequestId, const FString& CacheKey, ECachedDelivery Delivery);
+	void SubmitRequest(int32 RequestId, const TSharedPtr<FChatRequestState>& State, ECachedDelivery Delivery);
+	void DeliverCachedResponse(int32 RequestId, ECachedDelivery Delivery, const FString& Content, const FString& FinishReason);
+	void StoreInCache(const FString& CacheKey, const FString& Content, const FString& FinishReason = FString());
 
-	// Streaming state
-	FString StreamBuffer;
-	FString AccumulatedContent;
-	int32 LastProcessedOffset = 0;
+	int32 AllocateRequestId();
+	TSharedPtr<FChatRequestState> FindRequestState(int32 RequestId) const;
+
+private:
+	// In-flight requests keyed by request ID
+	TMap<int32, TSharedPtr<FChatRequestState>> ActiveRequests;
 
-	// Current request
-	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> CurrentRequest;
+	// Batches in progress keyed by batch ID (allocated from the same counter as request IDs)
+	TMap<int32, TSharedPtr<FChatBatchState>> ActiveBatches;
+	int32 NextRequestId = 1;
 };
@@ -1,8 +1,11 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitImageClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
@@ -33,7 +36,7 @@ void UPlayKitImageClient::BeginPlay()
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] ImageClient component initialized with model: %s"), *ModelName);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] ImageClient component initialized with model: %s"), *ModelName);
 }
 
 void UPlayKitImageClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -44,7 +47,7 @@ void UPlayKitImageClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitImageClient::CreateAuthenticatedRequest(const FString& Url)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -114,34 +117,31 @@ void UPlayKitImageClient::SendImageRequest(const FString& Prompt, const FPlayKit
 	LastPrompt = Prompt;
 
 	// Build request body
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), ModelName);
-	RequestBody->SetStringField(TEXT("prompt"), Prompt);
-	RequestBody->SetNumberField(TEXT("n"), FMath::Clamp(Options.Count, 1, 10));
-	RequestBody->SetStringField(TEXT("size"), Options.Size);
-	RequestBody->SetStringField(TEXT("response_format"), TEXT("b64_json"));
+	FPlayKitJsonWriter Json(Prompt.Len() + 192);
+	Json.BeginObject();
+	Json.WriteStringField("model", ModelName);
+	Json.WriteStringField("prompt", Prompt);
+	Json.WriteIntField("n", FMath::Clamp(Options.Count, 1, 10));
+	Json.WriteStringField("size", Options.Size);
+	Json.WriteStringField("response_format", TEXT("b64_json"));
 
 	if (Options.Seed >= 0)
 	{
-		RequestBody->SetNumberField(TEXT("seed"), Options.Seed);
+		Json.WriteIntField("seed", Options.Seed);
 	}
 	
 	if (Options.bTransparent)
 	{
-		RequestBody->SetBoolField(TEXT("transparent"), true);
+		Json.WriteBoolField("transparent", true);
 	}
-
-	// Serialize
-	FString RequestBodyStr;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyStr);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
+	Json.EndObject();
 
 	CurrentRequest = CreateAuthenticatedRequest(Url);
-	CurrentRequest->SetContentAsString(RequestBodyStr);
+	CurrentRequest->SetContent(Json.Finish());
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitImageClient::HandleImageResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Sending image request to: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Sending image request to: %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Bulk, EPlayKitEndpoint::Image, ModelName);
 }
 
 void UPlayKitImageClient::HandleImageResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -160,11 +160,13 @@ void UPlayKitImageClient::HandleImageResponse(FHttpRequestPtr Request, FHttpResp
 
 	if (ResponseCode < 200 || ResponseCode >= 300)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Image error %d: %s"), ResponseCode, *ResponseContent);
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Image error %d: %s"), ResponseCode, *ResponseContent);
 		BroadcastError(FString::FromInt(ResponseCode), ResponseContent);
 		return;
 	}
 
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::Image::ParseResponse");
+
 	// Parse response
 	TSharedPtr<FJsonObject> JsonObject;
 	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
@@ -201,7 +203,7 @@ void UPlayKitImageClient::HandleImageResponse(FHttpRequestPtr Request, FHttpResp
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Generated %d images"), Results.Num());
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Generated %d images"), Results.Num());
 
 	// Broadcast results
 	if (Results.Num() == 1)
@@ -215,14 +217,14 @@ UTexture2D* UPlayKitImageClient::Base64ToTexture2D(const FString& Base64Data)
 {
 	if (Base64Data.IsEmpty())
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Base64 data is empty"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Base64 data is empty"));
 		return nullptr;
 	}
 
 	TArray<uint8> DecodedData;
 	if (!FBase64::Decode(Base64Data, DecodedData))
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Failed to decode base64 data"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Failed to decode base64 data"));
 		return nullptr;
 	}
 
@@ -231,7 +233,7 @@ UTexture2D* UPlayKitImageClient::Base64ToTexture2D(const FString& Base64Data)
 
 	if (!Texture)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Failed to create texture from image data"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Failed to create texture from image data"));
 	}
 
 	return Texture;
@@ -241,7 +243,7 @@ void UPlayKitImageClient::CancelRequest()
 {
 	if (CurrentRequest.IsValid())
 	{
-		CurrentRequest->CancelRequest();
+		UPlayKitRequestScheduler::Cancel(this, CurrentRequest);
 		CurrentRequest.Reset();
 	}
 	bIsProcessing = false;
@@ -249,7 +251,7 @@ void UPlayKitImageClient::CancelRequest()
 
 void UPlayKitImageClient::BroadcastError(const FString& ErrorCode, const FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Error, TEXT("[PlayKit] Image error [%s]: %s"), *ErrorCode, *ErrorMessage);
+	UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Image error [%s]: %s"), *ErrorCode, *ErrorMessage);
 	OnError.Broadcast(ErrorCode, ErrorMessage);
 
 	// Also broadcast a failed image result
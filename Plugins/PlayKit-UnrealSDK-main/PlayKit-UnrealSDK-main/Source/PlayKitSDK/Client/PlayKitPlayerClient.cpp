@@ -1,8 +1,10 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitPlayerClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
@@ -16,7 +18,7 @@ UPlayKitPlayerClient::UPlayKitPlayerClient()
 void UPlayKitPlayerClient::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] PlayerClient subsystem initialized"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] PlayerClient subsystem initialized"));
 }
 
 void UPlayKitPlayerClient::Deinitialize()
@@ -24,11 +26,11 @@ void UPlayKitPlayerClient::Deinitialize()
 	// Cancel any pending requests
 	if (CurrentRequest.IsValid())
 	{
-		CurrentRequest->CancelRequest();
+		UPlayKitRequestScheduler::Cancel(this, CurrentRequest);
 		CurrentRequest.Reset();
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] PlayerClient subsystem deinitialized"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] PlayerClient subsystem deinitialized"));
 	Super::Deinitialize();
 }
 
@@ -66,7 +68,7 @@ bool UPlayKitPlayerClient::HasValidToken() const
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitPlayerClient::CreateAuthenticatedRequest(const FString& Url, const FString& Verb)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(Verb);
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -102,8 +104,8 @@ void UPlayKitPlayerClient::GetPlayerInfo()
 	CurrentRequest = CreateAuthenticatedRequest(Url);
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitPlayerClient::HandlePlayerInfoResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Getting player info from: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Getting player info from: %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Player);
 }
 
 void UPlayKitPlayerClient::HandlePlayerInfoResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -137,7 +139,7 @@ void UPlayKitPlayerClient::HandlePlayerInfoResponse(FHttpRequestPtr Request, FHt
 	JsonObject->TryGetNumberField(TEXT("credits"), CachedPlayerInfo.Credits);
 	JsonObject->TryGetStringField(TEXT("nickname"), CachedPlayerInfo.Nickname);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Player info: %s, Credits: %.2f"), *CachedPlayerInfo.UserId, CachedPlayerInfo.Credits);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Player info: %s, Credits: %.2f"), *CachedPlayerInfo.UserId, CachedPlayerInfo.Credits);
 	OnPlayerInfoUpdated.Broadcast(CachedPlayerInfo);
 }
 
@@ -176,8 +178,8 @@ void UPlayKitPlayerClient::SetNickname(const FString& Nickname)
 	CurrentRequest->SetContentAsString(RequestBodyStr);
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitPlayerClient::HandleSetNicknameResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Setting nickname: %s"), *TrimmedNickname);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Setting nickname: %s"), *TrimmedNickname);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Player);
 }
 
 void UPlayKitPlayerClient::HandleSetNicknameResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -216,7 +218,7 @@ void UPlayKitPlayerClient::HandleSetNicknameResponse(FHttpRequestPtr Request, FH
 		JsonObject->TryGetStringField(TEXT("nickname"), NewNickname);
 		CachedPlayerInfo.Nickname = NewNickname;
 
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Nickname set: %s"), *NewNickname);
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Nickname set: %s"), *NewNickname);
 		OnPlayerInfoUpdated.Broadcast(CachedPlayerInfo);
 	}
 	else
@@ -250,8 +252,8 @@ void UPlayKitPlayerClient::RefreshDailyCredits()
 	CurrentRequest->SetContentAsString(TEXT("{}"));
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitPlayerClient::HandleDailyCreditsResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Refreshing daily credits"));
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Refreshing daily credits"));
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Player);
 }
 
 void UPlayKitPlayerClient::HandleDailyCreditsResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -295,7 +297,7 @@ void UPlayKitPlayerClient::HandleDailyCreditsResponse(FHttpRequestPtr Request, F
 		OnPlayerInfoUpdated.Broadcast(CachedPlayerInfo);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Daily credits: %s"), *Result.Message);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Daily credits: %s"), *Result.Message);
 	OnDailyCreditsRefreshed.Broadcast(Result);
 }
 
@@ -318,7 +320,7 @@ void UPlayKitPlayerClient::ExchangeJWT(const FString& JWT)
 
 	FString Url = FString::Printf(TEXT("%s/api/external/exchange-jwt"), *Settings->GetBaseUrl());
 
-	CurrentRequest = FHttpModule::Get().CreateRequest();
+	CurrentRequest = UPlayKitTransport::CreateRequest(this);
 	CurrentRequest->SetURL(Url);
 	CurrentRequest->SetVerb(TEXT("POST"));
 	CurrentRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -326,8 +328,8 @@ void UPlayKitPlayerClient::ExchangeJWT(const FString& JWT)
 	CurrentRequest->SetContentAsString(TEXT("{}"));
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitPlayerClient::HandleJWTExchangeResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Exchanging JWT for player token"));
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Exchanging JWT for player token"));
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Player);
 }
 
 void UPlayKitPlayerClient::HandleJWTExchangeResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -372,7 +374,7 @@ void UPlayKitPlayerClient::HandleJWTExchangeResponse(FHttpRequestPtr Request, FH
 			Settings->SetPlayerToken(PlayerToken);
 		}
 
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Player token received"));
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Player token received"));
 		OnPlayerTokenReceived.Broadcast(PlayerToken);
 
 		// Automatically fetch player info
@@ -390,7 +392,7 @@ void UPlayKitPlayerClient::SetPlayerToken(const FString& Token)
 	if (Settings)
 	{
 		Settings->SetPlayerToken(Token);
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] Player token set manually"));
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Player token set manually"));
 
 		// Automatically fetch player info
 		GetPlayerInfo();
@@ -406,11 +408,11 @@ void UPlayKitPlayerClient::ClearPlayerToken()
 	}
 
 	CachedPlayerInfo = FPlayKitPlayerInfo();
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Player token cleared"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] Player token cleared"));
 }
 
 void UPlayKitPlayerClient::BroadcastError(const FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Error, TEXT("[PlayKit] Player error: %s"), *ErrorMessage);
+	UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Player error: %s"), *ErrorMessage);
 	OnError.Broadcast(ErrorMessage);
 }
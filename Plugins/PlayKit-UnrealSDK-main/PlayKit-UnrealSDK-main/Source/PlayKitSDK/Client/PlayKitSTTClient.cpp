@@ -1,8 +1,10 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitSTTClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
@@ -32,7 +34,7 @@ void UPlayKitSTTClient::BeginPlay()
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] STTClient component initialized with model: %s"), *ModelName);
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] STTClient component initialized with model: %s"), *ModelName);
 }
 
 void UPlayKitSTTClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -43,7 +45,7 @@ void UPlayKitSTTClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitSTTClient::CreateAuthenticatedRequest(const FString& Url)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
 
@@ -181,8 +183,8 @@ void UPlayKitSTTClient::SendTranscriptionRequest(const TArray<uint8>& AudioData,
 	CurrentRequest->SetContent(RequestBody);
 	CurrentRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitSTTClient::HandleTranscriptionResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Sending transcription request to: %s"), *Url);
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Sending transcription request to: %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Transcription, ModelName);
 }
 
 void UPlayKitSTTClient::HandleTranscriptionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -201,11 +203,13 @@ void UPlayKitSTTClient::HandleTranscriptionResponse(FHttpRequestPtr Request, FHt
 
 	if (ResponseCode < 200 || ResponseCode >= 300)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] STT error %d: %s"), ResponseCode, *ResponseContent);
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] STT error %d: %s"), ResponseCode, *ResponseContent);
 		BroadcastError(FString::FromInt(ResponseCode), ResponseContent);
 		return;
 	}
 
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::STT::ParseResponse");
+
 	// Parse response
 	TSharedPtr<FJsonObject> JsonObject;
 	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
@@ -240,7 +244,7 @@ void UPlayKitSTTClient::HandleTranscriptionResponse(FHttpRequestPtr Request, FHt
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKit] Transcription complete: %s"), *Result.Text.Left(100));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[PlayKit] Transcription complete: %s"), *Result.Text);
 	OnTranscriptionComplete.Broadcast(Result);
 }
 
@@ -248,7 +252,7 @@ void UPlayKitSTTClient::CancelRequest()
 {
 	if (CurrentRequest.IsValid())
 	{
-		CurrentRequest->CancelRequest();
+		UPlayKitRequestScheduler::Cancel(this, CurrentRequest);
 		CurrentRequest.Reset();
 	}
 	bIsProcessing = false;
@@ -256,7 +260,7 @@ void UPlayKitSTTClient::CancelRequest()
 
 void UPlayKitSTTClient::BroadcastError(const FString& ErrorCode, const FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Error, TEXT("[PlayKit] STT error [%s]: %s"), *ErrorCode, *ErrorMessage);
+	UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] STT error [%s]: %s"), *ErrorCode, *ErrorMessage);
 	OnError.Broadcast(ErrorCode, ErrorMessage);
 
 	// Also broadcast a failed result
@@ -1,7 +1,10 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitSTTComponent.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Transport/PlayKitTransport.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
@@ -37,13 +40,13 @@ UPlayKitSTTComponent::UPlayKitSTTComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	CaptureComponent = CreateDefaultSubobject<UAudioCaptureComponent>(TEXT("AudioCaptureComponent"));
-	UE_LOG(LogTemp, Log, TEXT("[STT] Constructor: AudioCaptureComponent created"));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] Constructor: AudioCaptureComponent created"));
 	if (CaptureComponent)
 	{
 		CaptureComponent->bAutoActivate = false;
-		UE_LOG(LogTemp, Log, TEXT("[STT] AudioCaptureComponent auto-activate disabled"));
+		UE_LOG(LogPlayKit, Verbose, TEXT("[STT] AudioCaptureComponent auto-activate disabled"));
 		CaptureComponent->SoundSubmix = RecordingSubmix;
-		UE_LOG(LogTemp, Log, TEXT("[STT] AudioCaptureComponent submix set: %s"), RecordingSubmix ? *RecordingSubmix->GetName() : TEXT("null"));
+		UE_LOG(LogPlayKit, Verbose, TEXT("[STT] AudioCaptureComponent submix set: %s"), RecordingSubmix ? *RecordingSubmix->GetName() : TEXT("null"));
 	}
 }
 
@@ -65,48 +68,48 @@ void UPlayKitSTTComponent::BeginPlay()
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[STT] BeginPlay - Model: %s"), *ModelName);
+	UE_LOG(LogPlayKit, Log, TEXT("[STT] BeginPlay - Model: %s"), *ModelName);
 }
 
 void UPlayKitSTTComponent::StartRecording()
 {
 	if (GetWorld())
 	{
-		UE_LOG(LogTemp, Log, TEXT("[STT] StartRecording: World=%s"), *GetWorld()->GetName());
+		UE_LOG(LogPlayKit, Verbose, TEXT("[STT] StartRecording: World=%s"), *GetWorld()->GetName());
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[STT] StartRecording: World is null"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[STT] StartRecording: World is null"));
 	}
 	if (!RecordingSubmix)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[STT] StartRecording: RecordingSubmix is not set"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[STT] StartRecording: RecordingSubmix is not set"));
 		OnPlayKitTranscriptionError.Broadcast(TEXT("Recording submix not configured"), TEXT("SUBMIX_NOT_SET"));
 	}
 	if (CaptureComponent)
 	{
 		CaptureComponent->SoundSubmix = RecordingSubmix;
 		CaptureComponent->Activate(true);
-		UE_LOG(LogTemp, Log, TEXT("[STT] AudioCaptureComponent activated: %s"), CaptureComponent->IsActive() ? TEXT("true") : TEXT("false"));
+		UE_LOG(LogPlayKit, Verbose, TEXT("[STT] AudioCaptureComponent activated: %s"), CaptureComponent->IsActive() ? TEXT("true") : TEXT("false"));
 	}
 	UAudioMixerBlueprintLibrary::StartRecordingOutput(this, 600.0f, RecordingSubmix);
-	UE_LOG(LogTemp, Log, TEXT("[STT] StartRecordingOutput invoked"));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] StartRecordingOutput invoked"));
 }
 
 void UPlayKitSTTComponent::StopRecording()
 {
-	UE_LOG(LogTemp, Log, TEXT("[STT] StopRecording called"));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] StopRecording called"));
 	FString SaveDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("CaptureSound"));
 	SaveDir = FPaths::ConvertRelativePathToFull(SaveDir);
 	const bool bDirOk = IFileManager::Get().MakeDirectory(*SaveDir, true);
-	UE_LOG(LogTemp, Log, TEXT("[STT] Ensure SaveDir: %s (created=%s)"), *SaveDir, bDirOk ? TEXT("true") : TEXT("false"));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] Ensure SaveDir: %s (created=%s)"), *SaveDir, bDirOk ? TEXT("true") : TEXT("false"));
 	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
 	const FString FileNameNoExt = FString::Printf(TEXT("capture_%s"), *Timestamp);
 
 	if (CaptureComponent)
 	{
 		CaptureComponent->Deactivate();
-		UE_LOG(LogTemp, Log, TEXT("[STT] AudioCaptureComponent deactivated: %s"), CaptureComponent->IsActive() ? TEXT("true") : TEXT("false"));
+		UE_LOG(LogPlayKit, Verbose, TEXT("[STT] AudioCaptureComponent deactivated: %s"), CaptureComponent->IsActive() ? TEXT("true") : TEXT("false"));
 	}
 
 	UAudioMixerBlueprintLibrary::StopRecordingOutput(this, EAudioRecordingExportType::WavFile, FileNameNoExt, SaveDir, RecordingSubmix);
@@ -120,15 +123,15 @@ void UPlayKitSTTComponent::StopRecording()
 			bFileExists = IFileManager::Get().FileExists(*LastSavedFilePath);
 		}
 	}
-	UE_LOG(LogTemp, Log, TEXT("[STT] Recording saved: %s (exists=%s)"), *LastSavedFilePath, bFileExists ? TEXT("true") : TEXT("false"));
+	UE_LOG(LogPlayKit, Log, TEXT("[STT] Recording saved: %s (exists=%s)"), *LastSavedFilePath, bFileExists ? TEXT("true") : TEXT("false"));
 }
 
 void UPlayKitSTTComponent::StartTranscription(const FPlayKitTranscriptionRequest& Request)
 {
-	UE_LOG(LogTemp, Log, TEXT("[STT] StartTranscription called, LastSavedFilePath=%s"), *LastSavedFilePath);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] StartTranscription called, LastSavedFilePath=%s"), *LastSavedFilePath);
 	if (LastSavedFilePath.IsEmpty() || !IFileManager::Get().FileExists(*LastSavedFilePath))
 	{
-		UE_LOG(LogTemp, Error, TEXT("[STT] StartTranscription aborted: recording file not ready"));
+		UE_LOG(LogPlayKit, Error, TEXT("[STT] StartTranscription aborted: recording file not ready"));
 		OnPlayKitTranscriptionError.Broadcast(TEXT("Recording file not ready"), TEXT("FILE_NOT_READY"));
 		return;
 	}
@@ -147,14 +150,14 @@ void UPlayKitSTTComponent::UploadRecordingJson(const FPlayKitTranscriptionReques
 	if (LastSavedFilePath.IsEmpty())
 	{
 		OnPlayKitTranscriptionError.Broadcast(TEXT("No recording file"), TEXT("NO_FILE"));
-		UE_LOG(LogTemp, Error, TEXT("[STT] UploadRecordingJson: LastSavedFilePath is empty"));
+		UE_LOG(LogPlayKit, Error, TEXT("[STT] UploadRecordingJson: LastSavedFilePath is empty"));
 		return;
 	}
 	TArray<uint8> FileData;
 	if (!FFileHelper::LoadFileToArray(FileData, *LastSavedFilePath))
 	{
 		OnPlayKitTranscriptionError.Broadcast(TEXT("Load file failed"), TEXT("LOAD_FAILED"));
-		UE_LOG(LogTemp, Error, TEXT("[STT] UploadRecordingJson: Load file failed: %s"), *LastSavedFilePath);
+		UE_LOG(LogPlayKit, Error, TEXT("[STT] UploadRecordingJson: Load file failed: %s"), *LastSavedFilePath);
 		return;
 	}
 	// Use Request.model if provided, otherwise use component's ModelName
@@ -168,27 +171,27 @@ void UPlayKitSTTComponent::UploadRecordingJson(const FPlayKitTranscriptionReques
 	JsonObject->SetStringField(TEXT("language"), Lang);
 	JsonObject->SetStringField(TEXT("prompt"), Prompt);
 	const FString JsonString = UPlayKitTool::JsonObjectToString(JsonObject);
-	UE_LOG(LogTemp, Log, TEXT("[STT] Request JSON:\n%s"), *UPlayKitTool::JsonObjectToString(JsonObject, true));
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] Request JSON:\n%s"), *UPlayKitTool::JsonObjectToString(JsonObject, true));
 
 	// Get auth token automatically (same as other clients)
 	const FString AuthToken = GetAuthToken();
 	if (AuthToken.IsEmpty())
 	{
 		OnPlayKitTranscriptionError.Broadcast(TEXT("Not authenticated"), TEXT("NOT_AUTHENTICATED"));
-		UE_LOG(LogTemp, Error, TEXT("[STT] UploadRecordingJson: No auth token available"));
+		UE_LOG(LogPlayKit, Error, TEXT("[STT] UploadRecordingJson: No auth token available"));
 		return;
 	}
 
 	const FString Url = GetTranscriptionUrl();
-	CurrentHttpRequest = FHttpModule::Get().CreateRequest();
+	CurrentHttpRequest = UPlayKitTransport::CreateRequest(this);
 	CurrentHttpRequest->SetURL(Url);
 	CurrentHttpRequest->SetVerb(TEXT("POST"));
 	CurrentHttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
 	CurrentHttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *AuthToken));
 	CurrentHttpRequest->SetContentAsString(JsonString);
 	CurrentHttpRequest->OnProcessRequestComplete().BindUObject(this, &UPlayKitSTTComponent::HandleTranscriptionResponse);
-	UE_LOG(LogTemp, Log, TEXT("[STT] UploadRecordingJson: Request sent to %s"), *Url);
-	CurrentHttpRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] UploadRecordingJson: Request sent to %s"), *Url);
+	UPlayKitRequestScheduler::Submit(this, CurrentHttpRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Transcription, Model);
 }
 
 void UPlayKitSTTComponent::HandleTranscriptionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -196,12 +199,12 @@ void UPlayKitSTTComponent::HandleTranscriptionResponse(FHttpRequestPtr Request,
 	if(!Response.IsValid() || !Request.IsValid())
 	{
 		OnPlayKitTranscriptionError.Broadcast(TEXT("Request failed"), TEXT("REQUEST_FAILED"));
-		UE_LOG(LogTemp, Error, TEXT("[STT] HandleTranscriptionResponse: Invalid response/request"));
+		UE_LOG(LogPlayKit, Error, TEXT("[STT] HandleTranscriptionResponse: Invalid response/request"));
 		return;
 	}
 
 	const int Code = Response->GetResponseCode();
-	UE_LOG(LogTemp, Log, TEXT("[STT] HandleTranscriptionResponse: HTTP %d"), Code);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] HandleTranscriptionResponse: HTTP %d"), Code);
 	if(Code != 200)
 	{
 		if (Code == 400)
@@ -243,23 +246,23 @@ void UPlayKitSTTComponent::HandleTranscriptionResponse(FHttpRequestPtr Request,
 					ErrMsg = UPlayKitTool::JsonObjectToString(ErrObj, true);
 				}
 				OnPlayKitTranscriptionError.Broadcast(ErrMsg, ErrCode);
-				UE_LOG(LogTemp, Error, TEXT("[STT] HTTP 400 Error: %s (%s)"), *ErrMsg, *ErrCode);
+				UE_LOG(LogPlayKit, Error, TEXT("[STT] HTTP 400 Error: %s (%s)"), *ErrMsg, *ErrCode);
 			}
 			else
 			{
 				OnPlayKitTranscriptionError.Broadcast(TEXT("Bad Request"), TEXT("HTTP_400"));
-				UE_LOG(LogTemp, Error, TEXT("[STT] HTTP 400: Bad Request, body parse failed"));
+				UE_LOG(LogPlayKit, Error, TEXT("[STT] HTTP 400: Bad Request, body parse failed"));
 			}
 		}
 		else
 		{
 			OnPlayKitTranscriptionError.Broadcast(FString::Printf(TEXT("HTTP %d: %s"), Code, *Response->GetContentAsString()), TEXT("HTTP_ERROR"));
-			UE_LOG(LogTemp, Error, TEXT("[STT] HTTP Error %d: %s"), Code, *Response->GetContentAsString());
+			UE_LOG(LogPlayKit, Error, TEXT("[STT] HTTP Error %d: %s"), Code, *Response->GetContentAsString());
 		}
 		return;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[STT] Response JSON: %s"), *Response->GetContentAsString());
+	UE_LOG(LogPlayKit, Verbose, TEXT("[STT] Response JSON: %s"), *Response->GetContentAsString());
 	TSharedPtr<FJsonObject> JsonObject;
 	UPlayKitTool::StringToJsonObject(Response->GetContentAsString(), JsonObject, true);
 
@@ -269,5 +272,5 @@ void UPlayKitSTTComponent::HandleTranscriptionResponse(FHttpRequestPtr Request,
 	Transcription.durationInSeconds = static_cast<float>(JsonObject->GetNumberField(TEXT("durationInSeconds")));
 
 	OnPlayKitTranscriptionResponded.Broadcast(Transcription);
-	UE_LOG(LogTemp, Log, TEXT("[STT] Transcription success: text=\"%s\", language=%s, duration=%.2fs"), *Transcription.text, *Transcription.language, Transcription.durationInSeconds);
+	UE_LOG(LogPlayKit, Log, TEXT("[STT] Transcription success: text=\"%s\", language=%s, duration=%.2fs"), *Transcription.text, *Transcription.language, Transcription.durationInSeconds);
 }
@@ -1,7 +1,12 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitAIContextManager.h"
+#include "PlayKitLog.h"
 #include "PlayKitSDK/NPC/PlayKitNPCClient.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Interfaces/IHttpResponse.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
@@ -9,12 +14,19 @@
 void UPlayKitAIContextManager::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Initialized"));
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Initialized"));
 }
 
 void UPlayKitAIContextManager::Deinitialize()
 {
 	DisableAutoCompact();
+
+	for (const auto& Pair : PendingCompactions)
+	{
+		UPlayKitRequestScheduler::Cancel(this, Pair.Value.Request);
+	}
+	PendingCompactions.Empty();
+
 	NPCStates.Empty();
 	Super::Deinitialize();
 }
@@ -47,14 +59,14 @@ void UPlayKitAIContextManager::SetPlayerDescription(const FString& Description)
 {
 	PlayerDescription = Description;
 	OnPlayerDescriptionChanged.Broadcast(Description);
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Player description set"));
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Player description set"));
 }
 
 void UPlayKitAIContextManager::ClearPlayerDescription()
 {
 	PlayerDescription.Empty();
 	OnPlayerDescriptionChanged.Broadcast(FString());
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Player description cleared"));
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Player description cleared"));
 }
 
 //========== NPC Tracking ==========//
@@ -72,7 +84,7 @@ void UPlayKitAIContextManager::RegisterNPC(UPlayKitNPCClient* NPC)
 	State.MessageCount = NPC->GetHistoryLength();
 	NPCStates.Add(NPC, State);
 
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Registered NPC: %s"), *NPC->GetName());
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Registered NPC: %s"), *NPC->GetName());
 }
 
 void UPlayKitAIContextManager::UnregisterNPC(UPlayKitNPCClient* NPC)
@@ -82,8 +94,9 @@ void UPlayKitAIContextManager::UnregisterNPC(UPlayKitNPCClient* NPC)
 		return;
 	}
 
+	CancelCompaction(NPC);
 	NPCStates.Remove(NPC);
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Unregistered NPC: %s"), *NPC->GetName());
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Unregistered NPC: %s"), *NPC->GetName());
 }
 
 void UPlayKitAIContextManager::RecordConversation(UPlayKitNPCClient* NPC)
@@ -150,7 +163,7 @@ void UPlayKitAIContextManager::EnableAutoCompact(float TimeoutSeconds, int32 Min
 		);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Auto compact enabled: timeout=%.0fs, minMessages=%d"),
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Auto compact enabled: timeout=%.0fs, minMessages=%d"),
 		TimeoutSeconds, MinMessages);
 }
 
@@ -164,13 +177,13 @@ void UPlayKitAIContextManager::DisableAutoCompact()
 		World->GetTimerManager().ClearTimer(AutoCompactTimerHandle);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Auto compact disabled"));
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Auto compact disabled"));
 }
 
 bool UPlayKitAIContextManager::IsEligibleForCompaction(UPlayKitNPCClient* NPC) const
 {
 	const FNPCConversationState* State = NPCStates.Find(NPC);
-	if (!State || !State->NPC.IsValid())
+	if (!State || !State->NPC.IsValid() || IsCompacting(NPC))
 	{
 		return false;
 	}
@@ -193,27 +206,152 @@ bool UPlayKitAIContextManager::IsEligibleForCompaction(UPlayKitNPCClient* NPC) c
 
 void UPlayKitAIContextManager::CompactConversation(UPlayKitNPCClient* NPC)
 {
+	if (!NPC || PendingCompactions.Contains(NPC))
+	{
+		return;
+	}
+
+	FNPCConversationState* State = NPCStates.Find(NPC);
+	if (State)
+	{
+		State->bEligibleForCompaction = false;
+	}
+
+	// An earlier summary on its own is not worth summarizing again
+	const int32 MessageCount = NPC->GetCompactableMessageCount(CompactKeepRecentTurns);
+	const FPlayKitNPCHistory& History = NPC->GetHistoryView();
+	const int32 PreviousSummaries = (MessageCount > 0 && History.GetRole(0) == ENPCMessageRole::System
+		&& !UPlayKitNPCClient::IsActionRecord(History[0])) ? 1 : 0;
+	if (MessageCount - PreviousSummaries < 2)
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[AIContextManager] Nothing to compact for NPC: %s"), *NPC->GetName());
+		return;
+	}
+
+	if (NPC->GetAuthToken().IsEmpty())
+	{
+		OnCompactionFailed.Broadcast(NPC, TEXT("No auth token available"));
+		return;
+	}
+
+	// Transcript of the turns being replaced, starting with the summary of anything older
+	FString Transcript;
+	for (int32 Index = 0; Index < MessageCount; ++Index)
+	{
+		const FPlayKitNPCMessageView Msg = History[Index];
+		const TCHAR* Speaker = TEXT("Note");
+		switch (Msg.Role)
+		{
+		case ENPCMessageRole::User:      Speaker = TEXT("Player"); break;
+		case ENPCMessageRole::Assistant: Speaker = TEXT("Character"); break;
+		case ENPCMessageRole::Tool:      Speaker = TEXT("Action result"); break;
+		case ENPCMessageRole::System:
+			Speaker = (Index < PreviousSummaries) ? TEXT("Earlier summary")
+				: UPlayKitNPCClient::IsActionRecord(Msg) ? TEXT("Character's actions")
+				: TEXT("Note");
+			break;
+		}
+		Transcript += FString::Printf(TEXT("%s: %s\n"), Speaker, *Msg.GetContent());
+	}
+
+	const FString Instructions = FString::Printf(
+		TEXT("You maintain the long-term memory of a game character. Summarize the conversation below between the player and the character ")
+		TEXT("in at most %d words, written in the third person. Keep names, facts the player revealed, promises, preferences, ")
+		TEXT("unresolved questions and how the character feels about the player. Fold any earlier summary in. Output only the summary."),
+		CompactSummaryMaxTokens * 3 / 4);
+
+	FPlayKitJsonWriter Json(Transcript.Len() + Instructions.Len() + 256);
+	Json.BeginObject();
+	Json.WriteStringField("model", FastModel);
+	Json.WriteKey("messages");
+	Json.BeginArray();
+	Json.WriteMessage(TEXT("system"), Instructions);
+	Json.WriteMessage(TEXT("user"), Transcript);
+	Json.EndArray();
+	Json.WriteNumberField("temperature", 0.3f);
+	Json.WriteIntField("max_tokens", CompactSummaryMaxTokens);
+	Json.WriteBoolField("stream", false);
+	Json.EndObject();
+
+	const FString Url = FString::Printf(TEXT("%s/ai/%s/v2/chat"), *NPC->GetBaseUrl(), *NPC->GetGameId());
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = NPC->CreateAuthenticatedRequest(Url);
+	Request->SetContent(Json.Finish());
+	Request->OnProcessRequestComplete().BindUObject(
+		this, &UPlayKitAIContextManager::HandleCompactionResponse, TWeakObjectPtr<UPlayKitNPCClient>(NPC));
+
+	FPendingCompaction& Pending = PendingCompactions.Add(NPC);
+	Pending.Request = Request;
+	Pending.MessageCount = MessageCount;
+	Pending.HistoryRevision = NPC->GetHistoryRevision();
+
+	UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Compacting %d messages for NPC: %s"), MessageCount, *NPC->GetName());
+	UPlayKitRequestScheduler::Submit(this, Request, EPlayKitRequestPriority::Background, EPlayKitEndpoint::Chat, FastModel);
+}
+
+void UPlayKitAIContextManager::HandleCompactionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TWeakObjectPtr<UPlayKitNPCClient> WeakNPC)
+{
+	FPendingCompaction Pending;
+	if (!PendingCompactions.RemoveAndCopyValue(WeakNPC, Pending) || Pending.Request != Request)
+	{
+		// Cancelled
+		return;
+	}
+
+	UPlayKitNPCClient* NPC = WeakNPC.Get();
 	if (!NPC)
 	{
 		return;
 	}
 
-	// For now, this is a placeholder. In a full implementation,
-	// this would call an AI service to summarize the conversation
-	// and replace the history with a compressed version.
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		const FString Error = Response.IsValid()
+			? FString::Printf(TEXT("Summary request failed with HTTP %d"), Response->GetResponseCode())
+			: FString(TEXT("Summary request failed"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[AIContextManager] %s for NPC: %s"), *Error, *NPC->GetName());
+		OnCompactionFailed.Broadcast(NPC, Error);
+		return;
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Compacting conversation for NPC: %s"), *NPC->GetName());
+	FString Summary;
+	{
+		PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::Context::ParseSummary");
+		FPlayKitJsonView::Parse(Response->GetContent()).Find("choices").At(0).Find("message").Find("content").TryGetString(Summary);
+		Summary.TrimStartAndEndInline();
+	}
 
-	// Mark as compacted
-	FNPCConversationState* State = NPCStates.Find(NPC);
-	if (State)
+	if (Summary.IsEmpty())
+	{
+		OnCompactionFailed.Broadcast(NPC, TEXT("Summary response was empty"));
+		return;
+	}
+
+	// Turns the NPC added meanwhile come after the replaced range and survive; any other edit voids the summary
+	if (!NPC->ReplaceWithSummary(Pending.MessageCount, Pending.HistoryRevision, TEXT("[Summary of earlier conversation]\n") + Summary))
 	{
+		UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] History of NPC %s changed during compaction, summary discarded"), *NPC->GetName());
+		OnCompactionFailed.Broadcast(NPC, TEXT("History changed during compaction"));
+		return;
+	}
+
+	if (FNPCConversationState* State = NPCStates.Find(NPC))
+	{
+		State->MessageCount = NPC->GetHistoryLength();
 		State->bEligibleForCompaction = false;
 	}
 
 	OnNPCCompacted.Broadcast(NPC);
 }
 
+void UPlayKitAIContextManager::CancelCompaction(UPlayKitNPCClient* NPC)
+{
+	FPendingCompaction Pending;
+	if (PendingCompactions.RemoveAndCopyValue(NPC, Pending))
+	{
+		UPlayKitRequestScheduler::Cancel(this, Pending.Request);
+	}
+}
+
 int32 UPlayKitAIContextManager::CompactAllEligible()
 {
 	int32 CompactedCount = 0;
@@ -231,7 +369,10 @@ int32 UPlayKitAIContextManager::CompactAllEligible()
 	for (UPlayKitNPCClient* NPC : EligibleNPCs)
 	{
 		CompactConversation(NPC);
-		CompactedCount++;
+		if (IsCompacting(NPC))
+		{
+			CompactedCount++;
+		}
 	}
 
 	return CompactedCount;
@@ -255,6 +396,6 @@ void UPlayKitAIContextManager::CheckAutoCompaction()
 
 	if (Compacted > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[AIContextManager] Auto compacted %d NPC conversations"), Compacted);
+		UE_LOG(LogPlayKit, Log, TEXT("[AIContextManager] Auto compaction started for %d NPC conversations"), Compacted);
 	}
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/IHttpRequest.h"
 #include "PlayKitAIContextManager.generated.h"
 
 class UPlayKitNPCClient;
@@ -103,11 +104,20 @@ public:
 	UFUNCTION(BlueprintPure, Category="PlayKit|Context")
 	bool IsEligibleForCompaction(UPlayKitNPCClient* NPC) const;
 
-	/** Manually compact an NPC's conversation */
+	/**
+	 * Summarize an NPC's older turns in the background and replace them with the summary.
+	 * The most recent CompactKeepRecentTurns turns stay verbatim, and the NPC can keep talking meanwhile:
+	 * turns added while the summary is generated are kept. If the older history is edited in the
+	 * meantime (cleared, reverted, loaded), the summary is discarded and OnCompactionFailed fires.
+	 */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Context")
 	void CompactConversation(UPlayKitNPCClient* NPC);
 
-	/** Compact all eligible NPCs */
+	/** Check if a compaction is in progress for an NPC */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Context")
+	bool IsCompacting(UPlayKitNPCClient* NPC) const { return PendingCompactions.Contains(NPC); }
+
+	/** Start compaction for all eligible NPCs. Returns how many were started */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|Context")
 	int32 CompactAllEligible();
 
@@ -141,8 +151,29 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Context")
 	int32 AutoCompactMinMessages = 10;
 
+	/** Most recent turns kept word for word when compacting */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Context", meta=(ClampMin="0"))
+	int32 CompactKeepRecentTurns = 4;
+
+	/** Length limit for a compaction summary */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|Context", meta=(ClampMin="32"))
+	int32 CompactSummaryMaxTokens = 400;
+
 private:
+	struct FPendingCompaction
+	{
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+
+		/** Leading messages the summary replaces */
+		int32 MessageCount = 0;
+
+		/** History revision the summary was made from */
+		uint32 HistoryRevision = 0;
+	};
+
 	void CheckAutoCompaction();
+	void HandleCompactionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TWeakObjectPtr<UPlayKitNPCClient> WeakNPC);
+	void CancelCompaction(UPlayKitNPCClient* NPC);
 
 private:
 	FString PlayerDescription;
@@ -152,4 +183,6 @@ private:
 
 	bool bAutoCompactEnabled = false;
 	FTimerHandle AutoCompactTimerHandle;
+
+	TMap<TWeakObjectPtr<UPlayKitNPCClient>, FPendingCompaction> PendingCompactions;
 };
@@ -0,0 +1,317 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitNPCLODManager.h"
+#include "PlayKitLog.h"
+#include "Context/PlayKitAIContextManager.h"
+#include "NPC/PlayKitNPCClient.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+
+UPlayKitNPCLODManager::UPlayKitNPCLODManager()
+{
+	// Focus keeps the NPC's own settings
+	NearSettings.MaxTokens = 200;
+	NearSettings.MaxContextTokens = 2048;
+	NearSettings.MinRequestInterval = 8.0f;
+	NearSettings.bAllowPredictions = false;
+
+	FarSettings.bUseFastModel = true;
+	FarSettings.MaxTokens = 80;
+	FarSettings.MaxContextTokens = 512;
+	FarSettings.MinRequestInterval = 30.0f;
+	FarSettings.bAllowPredictions = false;
+
+	DormantSettings.bAllowRequests = false;
+	DormantSettings.bUseFastModel = true;
+	DormantSettings.bAllowPredictions = false;
+}
+
+void UPlayKitNPCLODManager::Deinitialize()
+{
+	Disable();
+	Super::Deinitialize();
+}
+
+UPlayKitNPCLODManager* UPlayKitNPCLODManager::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UGameInstance* GameInstance = Cast<UGameInstance>(WorldContextObject);
+	if (!GameInstance)
+	{
+		if (const UGameInstanceSubsystem* Subsystem = Cast<UGameInstanceSubsystem>(WorldContextObject))
+		{
+			GameInstance = Subsystem->GetGameInstance();
+		}
+		else if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			GameInstance = World->GetGameInstance();
+		}
+	}
+
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitNPCLODManager>() : nullptr;
+}
+
+//========== Control ==========//
+
+void UPlayKitNPCLODManager::Enable(float UpdateInterval)
+{
+	bEnabled = true;
+
+	UWorld* World = GetWorld();
+	if (World)
+	{
+		World->GetTimerManager().SetTimer(
+			UpdateTimerHandle,
+			this,
+			&UPlayKitNPCLODManager::UpdateTiers,
+			FMath::Max(UpdateInterval, 0.05f),
+			true
+		);
+	}
+
+	UpdateTiers();
+	UE_LOG(LogPlayKit, Log, TEXT("[NPCLOD] Enabled: update every %.2fs"), UpdateInterval);
+}
+
+void UPlayKitNPCLODManager::Disable()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+	bEnabled = false;
+
+	UWorld* World = GetWorld();
+	if (World)
+	{
+		World->GetTimerManager().ClearTimer(UpdateTimerHandle);
+	}
+
+	for (const auto& Pair : States)
+	{
+		if (UPlayKitNPCClient* NPC = Pair.Key.Get())
+		{
+			NPC->ClearLOD();
+		}
+	}
+	States.Empty();
+	FMemory::Memzero(TierCounts);
+
+	UE_LOG(LogPlayKit, Log, TEXT("[NPCLOD] Disabled"));
+}
+
+void UPlayKitNPCLODManager::UpdateTiers()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	PLAYKIT_SCOPE(STAT_PlayKit_LODUpdate, "PlayKit::NPCLOD::Update");
+
+	UPlayKitAIContextManager* ContextManager = GetGameInstance()->GetSubsystem<UPlayKitAIContextManager>();
+	if (!ContextManager)
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	const bool bHasView = GetViewLocation(ViewLocation);
+	const FDateTime Now = FDateTime::UtcNow();
+
+	struct FCandidate
+	{
+		UPlayKitNPCClient* NPC;
+		double DistanceSquared;
+		bool bNear;
+	};
+	TArray<FCandidate, TInlineAllocator<128>> Candidates;
+
+	TMap<TWeakObjectPtr<UPlayKitNPCClient>, FNPCLODState> NextStates;
+	FMemory::Memzero(TierCounts);
+
+	auto SetTier = [this](UPlayKitNPCClient* NPC, FNPCLODState& State, EPlayKitNPCLODTier Tier)
+	{
+		State.Tier = Tier;
+		NPC->ApplyLOD(Tier, GetTierSettings(Tier));
+		++TierCounts[static_cast<int32>(Tier)];
+	};
+
+	for (UPlayKitNPCClient* NPC : ContextManager->GetRegisteredNPCs())
+	{
+		FNPCLODState State;
+		if (const FNPCLODState* Existing = States.Find(NPC))
+		{
+			State = *Existing;
+		}
+		else
+		{
+			State.SeenAt = Now;
+		}
+		FNPCLODState& NextState = NextStates.Add(NPC, State);
+
+		// Interactions are timed by the context manager; its registration time does not count
+		const FNPCConversationState Conversation = ContextManager->GetNPCState(NPC);
+		if (Conversation.LastInteractionTime > NextState.SeenAt
+			&& (Now - Conversation.LastInteractionTime).GetTotalSeconds() < RecentInteractionSeconds)
+		{
+			SetTier(NPC, NextState, EPlayKitNPCLODTier::Focus);
+			continue;
+		}
+
+		const AActor* Owner = NPC->GetOwner();
+		if (!bHasView || !Owner)
+		{
+			SetTier(NPC, NextState, EPlayKitNPCLODTier::Dormant);
+			continue;
+		}
+
+		const double DistanceSquared = FVector::DistSquared(Owner->GetActorLocation(), ViewLocation);
+		if (DistanceSquared > FMath::Square(FarDistance))
+		{
+			SetTier(NPC, NextState, EPlayKitNPCLODTier::Dormant);
+			continue;
+		}
+
+		const bool bNear = DistanceSquared <= FMath::Square(NearDistance) && Owner->WasRecentlyRendered(VisibilityTolerance);
+		Candidates.Add({ NPC, DistanceSquared, bNear });
+	}
+
+	// Closest first: near candidates over the cap drop to Far, and Far over its cap to Dormant
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+	int32 NearCount = 0;
+	int32 FarCount = 0;
+	for (const FCandidate& Candidate : Candidates)
+	{
+		EPlayKitNPCLODTier Tier = EPlayKitNPCLODTier::Dormant;
+		if (Candidate.bNear && NearCount < MaxNearNPCs)
+		{
+			Tier = EPlayKitNPCLODTier::Near;
+			++NearCount;
+		}
+		else if (FarCount < MaxFarNPCs)
+		{
+			Tier = EPlayKitNPCLODTier::Far;
+			++FarCount;
+		}
+		SetTier(Candidate.NPC, NextStates.FindChecked(Candidate.NPC), Tier);
+	}
+
+	// NPCs that were unregistered get their own settings back
+	for (const auto& Pair : States)
+	{
+		UPlayKitNPCClient* NPC = Pair.Key.Get();
+		if (NPC && !NextStates.Contains(Pair.Key))
+		{
+			NPC->ClearLOD();
+		}
+	}
+	States = MoveTemp(NextStates);
+}
+
+void UPlayKitNPCLODManager::NotifyInteraction(UPlayKitNPCClient* NPC)
+{
+	if (!NPC)
+	{
+		return;
+	}
+
+	if (UPlayKitAIContextManager* ContextManager = GetGameInstance()->GetSubsystem<UPlayKitAIContextManager>())
+	{
+		ContextManager->RecordConversation(NPC);
+	}
+
+	if (bEnabled)
+	{
+		// Seen before the interaction, so the next update keeps it at Focus
+		FNPCLODState& State = States.FindOrAdd(NPC);
+		State.SeenAt = FDateTime::MinValue();
+		if (State.Tier != EPlayKitNPCLODTier::Focus)
+		{
+			--TierCounts[static_cast<int32>(State.Tier)];
+			++TierCounts[static_cast<int32>(EPlayKitNPCLODTier::Focus)];
+		}
+		State.Tier = EPlayKitNPCLODTier::Focus;
+		NPC->ApplyLOD(EPlayKitNPCLODTier::Focus, FocusSettings);
+	}
+}
+
+bool UPlayKitNPCLODManager::GetViewLocation(FVector& OutLocation) const
+{
+	const APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController(GetWorld());
+	if (!PlayerController)
+	{
+		return false;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+	return true;
+}
+
+//========== Queries ==========//
+
+EPlayKitNPCLODTier UPlayKitNPCLODManager::GetTier(UPlayKitNPCClient* NPC) const
+{
+	const FNPCLODState* State = States.Find(NPC);
+	return State ? State->Tier : EPlayKitNPCLODTier::Focus;
+}
+
+int32 UPlayKitNPCLODManager::GetTierCount(EPlayKitNPCLODTier Tier) const
+{
+	const int32 Index = static_cast<int32>(Tier);
+	return Index < static_cast<int32>(UE_ARRAY_COUNT(TierCounts)) ? TierCounts[Index] : 0;
+}
+
+FPlayKitNPCLODSettings UPlayKitNPCLODManager::GetTierSettings(EPlayKitNPCLODTier Tier) const
+{
+	switch (Tier)
+	{
+	case EPlayKitNPCLODTier::Near:		return NearSettings;
+	case EPlayKitNPCLODTier::Far:		return FarSettings;
+	case EPlayKitNPCLODTier::Dormant:	return DormantSettings;
+	default:							return FocusSettings;
+	}
+}
+
+void UPlayKitNPCLODManager::DumpTiers(FOutputDevice& Output) const
+{
+	for (const auto& Pair : States)
+	{
+		if (const UPlayKitNPCClient* NPC = Pair.Key.Get())
+		{
+			Output.Logf(TEXT("[NPCLOD] %-40s %s"), *GetNameSafe(NPC->GetOwner()), *UEnum::GetDisplayValueAsText(Pair.Value.Tier).ToString());
+		}
+	}
+
+	Output.Logf(TEXT("[NPCLOD] %s: %d focus, %d near, %d far, %d dormant"), bEnabled ? TEXT("Enabled") : TEXT("Disabled"),
+		TierCounts[0], TierCounts[1], TierCounts[2], TierCounts[3]);
+}
+
+//========== Console ==========//
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GPlayKitNPCLODCommand(
+	TEXT("playkit.npclod"),
+	TEXT("Print the LOD tier of each NPC."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Output)
+		{
+			if (const UPlayKitNPCLODManager* Manager = UPlayKitNPCLODManager::Get(World))
+			{
+				Manager->DumpTiers(Output);
+			}
+			else
+			{
+				Output.Logf(TEXT("[NPCLOD] No game instance"));
+			}
+		}));
@@ -0,0 +1,149 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/TimerHandle.h"
+#include "NPC/PlayKitNPCLOD.h"
+#include "PlayKitNPCLODManager.generated.h"
+
+class UPlayKitNPCClient;
+
+/**
+ * PlayKit NPC LOD Manager
+ * Scales NPC request load with what the player can perceive instead of with the number of NPCs.
+ *
+ * Every UpdateInterval, each NPC registered with UPlayKitAIContextManager gets a tier:
+ * - Focus:   the player interacted with it in the last RecentInteractionSeconds (NotifyInteraction,
+ *            or UPlayKitAIContextManager::RecordConversation)
+ * - Near:    within NearDistance of the player's view point and recently rendered; the closest
+ *            MaxNearNPCs only
+ * - Far:     within FarDistance, or near but off screen or over the Near cap; the closest MaxFarNPCs only
+ * - Dormant: everything else
+ * The tier's settings (model, max tokens, history window, request interval) are applied to the NPC,
+ * so however many NPCs there are, at most MaxNearNPCs + MaxFarNPCs send ambient requests, each
+ * no more often than its tier allows.
+ *
+ * Talk and TalkStream count as an interaction, so the player's own messages always go out at Focus;
+ * the tiers limit everything else the NPC sends (predictions, speculative replies, ambient requests).
+ *
+ * Usage:
+ * UPlayKitNPCLODManager::Get(this)->Enable();
+ * ...
+ * if (NPC->CanSendRequest()) { SendAmbientRequest(NPC); }
+ */
+UCLASS(BlueprintType)
+class PLAYKITSDK_API UPlayKitNPCLODManager : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPlayKitNPCLODManager();
+
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|LOD", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitNPCLODManager* Get(const UObject* WorldContextObject);
+
+	//========== Control ==========//
+
+	/** Start assigning tiers, every UpdateInterval seconds */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|LOD")
+	void Enable(float UpdateInterval = 0.5f);
+
+	/** Stop assigning tiers and lift every NPC's limits */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|LOD")
+	void Disable();
+
+	UFUNCTION(BlueprintPure, Category="PlayKit|LOD")
+	bool IsEnabled() const { return bEnabled; }
+
+	/** Assign tiers now instead of at the next update */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|LOD")
+	void UpdateTiers();
+
+	/**
+	 * The player started talking to an NPC: record it with the context manager and move the NPC
+	 * to Focus at once, so the player's own message is never throttled. Talk and TalkStream call it
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|LOD")
+	void NotifyInteraction(UPlayKitNPCClient* NPC);
+
+	//========== Queries ==========//
+
+	/** Tier of an NPC; Focus if it has none */
+	UFUNCTION(BlueprintPure, Category="PlayKit|LOD")
+	EPlayKitNPCLODTier GetTier(UPlayKitNPCClient* NPC) const;
+
+	/** Number of NPCs at a tier after the last update */
+	UFUNCTION(BlueprintPure, Category="PlayKit|LOD")
+	int32 GetTierCount(EPlayKitNPCLODTier Tier) const;
+
+	/** Settings applied at a tier */
+	UFUNCTION(BlueprintPure, Category="PlayKit|LOD")
+	FPlayKitNPCLODSettings GetTierSettings(EPlayKitNPCLODTier Tier) const;
+
+	/** Print each NPC's tier */
+	void DumpTiers(FOutputDevice& Output) const;
+
+public:
+	//========== Tier Settings ==========//
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD|Tiers")
+	FPlayKitNPCLODSettings FocusSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD|Tiers")
+	FPlayKitNPCLODSettings NearSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD|Tiers")
+	FPlayKitNPCLODSettings FarSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD|Tiers")
+	FPlayKitNPCLODSettings DormantSettings;
+
+	//========== Tier Selection ==========//
+
+	/** Distance from the player's view point within which a rendered NPC is Near */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0.0", Units="cm"))
+	float NearDistance = 1500.0f;
+
+	/** Distance from the player's view point beyond which an NPC is Dormant */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0.0", Units="cm"))
+	float FarDistance = 4000.0f;
+
+	/** Most Near NPCs; the rest of the candidates are Far */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0"))
+	int32 MaxNearNPCs = 6;
+
+	/** Most Far NPCs; the rest are Dormant */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0"))
+	int32 MaxFarNPCs = 12;
+
+	/** How long an NPC stays at Focus after the player last talked to it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0.0", Units="s"))
+	float RecentInteractionSeconds = 30.0f;
+
+	/** How long after its last frame on screen an NPC still counts as visible */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0.0", Units="s"))
+	float VisibilityTolerance = 0.5f;
+
+private:
+	struct FNPCLODState
+	{
+		EPlayKitNPCLODTier Tier = EPlayKitNPCLODTier::Focus;
+
+		/** When the manager first saw the NPC; registering it is not an interaction */
+		FDateTime SeenAt;
+	};
+
+	bool GetViewLocation(FVector& OutLocation) const;
+
+private:
+	bool bEnabled = false;
+	FTimerHandle UpdateTimerHandle;
+
+	TMap<TWeakObjectPtr<UPlayKitNPCClient>, FNPCLODState> States;
+	int32 TierCounts[4] = {};
+};
@@ -0,0 +1,357 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitMetrics.h"
+#include "PlayKitLog.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+
+namespace
+{
+	constexpr int32 SubBucketBits = 5;
+	constexpr int32 SubBucketCount = 1 << SubBucketBits;
+}
+
+//========== Histogram ==========//
+
+FPlayKitHistogram::FPlayKitHistogram(double InResolution)
+	: Resolution(FMath::Max(InResolution, UE_DOUBLE_SMALL_NUMBER))
+{
+}
+
+void FPlayKitHistogram::Record(double Value)
+{
+	if (!FMath::IsFinite(Value) || Value < 0.0)
+	{
+		return;
+	}
+
+	const uint64 Scaled = static_cast<uint64>(FMath::Min(Value / Resolution + 0.5, static_cast<double>(MAX_int64)));
+	const int32 Index = GetBucketIndex(Scaled);
+	if (Index >= Buckets.Num())
+	{
+		Buckets.SetNumZeroed(Index + 1);
+	}
+	Buckets[Index]++;
+
+	Min = Count > 0 ? FMath::Min(Min, Value) : Value;
+	Max = Count > 0 ? FMath::Max(Max, Value) : Value;
+	Sum += Value;
+	Count++;
+}
+
+void FPlayKitHistogram::Reset()
+{
+	Buckets.Reset();
+	Count = 0;
+	Sum = Min = Max = 0.0;
+}
+
+double FPlayKitHistogram::GetPercentile(double Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const int64 Target = FMath::Max<int64>(1, FMath::CeilToInt64(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count));
+	int64 Seen = 0;
+	for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+	{
+		Seen += Buckets[Index];
+		if (Seen >= Target)
+		{
+			// The bucket midpoint can fall outside the observed range at the extremes
+			return FMath::Clamp(GetBucketMidpoint(Index) * Resolution, Min, Max);
+		}
+	}
+	return Max;
+}
+
+int32 FPlayKitHistogram::GetBucketIndex(uint64 Scaled)
+{
+	if (Scaled < SubBucketCount)
+	{
+		return static_cast<int32>(Scaled);
+	}
+
+	const int32 Exponent = static_cast<int32>(FMath::FloorLog2_64(Scaled));
+	const int32 Shift = Exponent - SubBucketBits;
+	const int32 SubBucket = static_cast<int32>(Scaled >> Shift) - SubBucketCount;
+	return SubBucketCount + Shift * SubBucketCount + SubBucket;
+}
+
+uint64 FPlayKitHistogram::GetBucketMidpoint(int32 Index)
+{
+	if (Index < SubBucketCount)
+	{
+		return static_cast<uint64>(Index);
+	}
+
+	const int32 Shift = (Index - SubBucketCount) / SubBucketCount;
+	const int32 SubBucket = (Index - SubBucketCount) % SubBucketCount;
+	const uint64 Lower = static_cast<uint64>(SubBucketCount + SubBucket) << Shift;
+	return Lower + ((uint64(1) << Shift) >> 1);
+}
+
+//========== Subsystem ==========//
+
+void UPlayKitMetrics::Deinitialize()
+{
+	Traces.Empty();
+	Series.Empty();
+	Super::Deinitialize();
+}
+
+UPlayKitMetrics* UPlayKitMetrics::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UGameInstance* GameInstance = Cast<UGameInstance>(WorldContextObject);
+	if (!GameInstance)
+	{
+		if (const UGameInstanceSubsystem* Subsystem = Cast<UGameInstanceSubsystem>(WorldContextObject))
+		{
+			GameInstance = Subsystem->GetGameInstance();
+		}
+		else if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			GameInstance = World->GetGameInstance();
+		}
+	}
+
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitMetrics>() : nullptr;
+}
+
+//========== Client Hooks ==========//
+
+void UPlayKitMetrics::NoteFirstToken(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	UPlayKitMetrics* Metrics = Get(Owner);
+	FRequestTrace* Trace = (Metrics && Request.IsValid()) ? Metrics->Traces.Find(Request.Get()) : nullptr;
+	if (Trace && Trace->FirstTokenAt == 0.0)
+	{
+		Trace->FirstTokenAt = FPlatformTime::Seconds();
+	}
+}
+
+void UPlayKitMetrics::NoteGeneratedTokens(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request, int32 Tokens)
+{
+	UPlayKitMetrics* Metrics = Get(Owner);
+	FRequestTrace* Trace = (Metrics && Request.IsValid()) ? Metrics->Traces.Find(Request.Get()) : nullptr;
+	if (Trace)
+	{
+		Trace->GeneratedTokens = FMath::Max(0, Tokens);
+	}
+}
+
+//========== Scheduler Hooks ==========//
+
+void UPlayKitMetrics::BeginTrace(const IHttpRequest* Request, EPlayKitEndpoint Endpoint, const FString& Model)
+{
+	FRequestTrace& Trace = Traces.Add(Request);
+	Trace.Endpoint = Endpoint;
+	Trace.Model = Model;
+	Trace.QueuedAt = FPlatformTime::Seconds();
+}
+
+void UPlayKitMetrics::MarkSent(const IHttpRequest* Request)
+{
+	if (FRequestTrace* Trace = Traces.Find(Request))
+	{
+		Trace->SentAt = FPlatformTime::Seconds();
+	}
+}
+
+void UPlayKitMetrics::MarkFirstByte(const IHttpRequest* Request)
+{
+	FRequestTrace* Trace = Traces.Find(Request);
+	if (Trace && Trace->FirstByteAt == 0.0)
+	{
+		Trace->FirstByteAt = FPlatformTime::Seconds();
+	}
+}
+
+void UPlayKitMetrics::EndTrace(const IHttpRequest* Request, const FHttpResponsePtr& Response, bool bWasSuccessful)
+{
+	FRequestTrace Trace;
+	if (!Traces.RemoveAndCopyValue(Request, Trace) || Trace.SentAt == 0.0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const bool bSucceeded = bWasSuccessful && Response.IsValid()
+		&& Response->GetResponseCode() >= 200 && Response->GetResponseCode() < 300;
+
+	FSeries& Entry = Series.FindOrAdd(FSeriesKey(Trace.Endpoint, Trace.Model));
+	Entry.RequestCount++;
+	Entry.QueueTimeMs.Record((Trace.SentAt - Trace.QueuedAt) * 1000.0);
+	Entry.TotalTimeMs.Record((Now - Trace.QueuedAt) * 1000.0);
+	Entry.BytesSent.Record(Request->GetContentLength());
+
+	if (Response.IsValid())
+	{
+		Entry.BytesReceived.Record(Response->GetContent().Num());
+	}
+
+	if (!bSucceeded)
+	{
+		Entry.ErrorCount++;
+		return;
+	}
+
+	// Small responses can complete without a progress tick; the body then arrived at completion
+	const double FirstByteAt = Trace.FirstByteAt > 0.0 ? Trace.FirstByteAt : Now;
+	Entry.TimeToFirstByteMs.Record((FirstByteAt - Trace.SentAt) * 1000.0);
+
+	// Without a streamed token the whole reply becomes visible at once
+	const bool bStreamed = Trace.FirstTokenAt > 0.0;
+	const double FirstTokenAt = bStreamed ? Trace.FirstTokenAt : Now;
+	Entry.TimeToFirstTokenMs.Record((FirstTokenAt - Trace.QueuedAt) * 1000.0);
+
+	if (Trace.GeneratedTokens > 0)
+	{
+		const double GenerationSeconds = bStreamed ? Now - Trace.FirstTokenAt : Now - Trace.SentAt;
+		if (GenerationSeconds > UE_DOUBLE_KINDA_SMALL_NUMBER)
+		{
+			Entry.TokensPerSecond.Record(Trace.GeneratedTokens / GenerationSeconds);
+		}
+	}
+}
+
+void UPlayKitMetrics::DiscardTrace(const IHttpRequest* Request)
+{
+	Traces.Remove(Request);
+}
+
+//========== Queries ==========//
+
+bool UPlayKitMetrics::GetStats(EPlayKitEndpoint Endpoint, const FString& Model, FPlayKitEndpointStats& OutStats) const
+{
+	const FSeriesKey Key(Endpoint, Model);
+	const FSeries* Found = Series.Find(Key);
+	if (!Found)
+	{
+		return false;
+	}
+
+	OutStats = MakeStats(Key, *Found);
+	return true;
+}
+
+TArray<FPlayKitEndpointStats> UPlayKitMetrics::GetAllStats() const
+{
+	TArray<FPlayKitEndpointStats> Result;
+	Result.Reserve(Series.Num());
+	for (const TPair<FSeriesKey, FSeries>& Pair : Series)
+	{
+		Result.Add(MakeStats(Pair.Key, Pair.Value));
+	}
+
+	Result.Sort([](const FPlayKitEndpointStats& A, const FPlayKitEndpointStats& B)
+	{
+		return A.Endpoint != B.Endpoint ? A.Endpoint < B.Endpoint : A.Model < B.Model;
+	});
+	return Result;
+}
+
+void UPlayKitMetrics::ResetStats()
+{
+	Series.Empty();
+	UE_LOG(LogPlayKit, Log, TEXT("[Metrics] Stats reset"));
+}
+
+void UPlayKitMetrics::DumpStats(FOutputDevice* Output) const
+{
+	FOutputDevice& Out = Output ? *Output : *GLog;
+
+	const TArray<FPlayKitEndpointStats> AllStats = GetAllStats();
+	if (AllStats.Num() == 0)
+	{
+		Out.Logf(TEXT("[Metrics] No requests recorded"));
+		return;
+	}
+
+	auto Row = [&Out](const TCHAR* Label, const FPlayKitMetricSummary& Summary, const TCHAR* Unit)
+	{
+		if (Summary.Count > 0)
+		{
+			Out.Logf(TEXT("    %-8s p50 %9.1f  p95 %9.1f  p99 %9.1f  max %9.1f  mean %9.1f %s  (n=%d)"),
+				Label, Summary.P50, Summary.P95, Summary.P99, Summary.Max, Summary.Mean, Unit, Summary.Count);
+		}
+	};
+
+	for (const FPlayKitEndpointStats& Stats : AllStats)
+	{
+		Out.Logf(TEXT("[Metrics] %s / %s: %d requests, %d errors"),
+			*UEnum::GetDisplayValueAsText(Stats.Endpoint).ToString(),
+			Stats.Model.IsEmpty() ? TEXT("-") : *Stats.Model,
+			Stats.RequestCount, Stats.ErrorCount);
+		Row(TEXT("queue"), Stats.QueueTimeMs, TEXT("ms"));
+		Row(TEXT("ttfb"), Stats.TimeToFirstByteMs, TEXT("ms"));
+		Row(TEXT("ttft"), Stats.TimeToFirstTokenMs, TEXT("ms"));
+		Row(TEXT("total"), Stats.TotalTimeMs, TEXT("ms"));
+		Row(TEXT("tok/s"), Stats.TokensPerSecond, TEXT(""));
+		Row(TEXT("sent"), Stats.BytesSent, TEXT("B"));
+		Row(TEXT("recv"), Stats.BytesReceived, TEXT("B"));
+	}
+}
+
+FPlayKitMetricSummary UPlayKitMetrics::Summarize(const FPlayKitHistogram& Histogram)
+{
+	FPlayKitMetricSummary Summary;
+	Summary.Count = static_cast<int32>(FMath::Min<int64>(Histogram.GetCount(), MAX_int32));
+	Summary.Min = Histogram.GetMin();
+	Summary.Mean = Histogram.GetMean();
+	Summary.P50 = Histogram.GetPercentile(50.0);
+	Summary.P95 = Histogram.GetPercentile(95.0);
+	Summary.P99 = Histogram.GetPercentile(99.0);
+	Summary.Max = Histogram.GetMax();
+	return Summary;
+}
+
+FPlayKitEndpointStats UPlayKitMetrics::MakeStats(const FSeriesKey& Key, const FSeries& Entry)
+{
+	FPlayKitEndpointStats Stats;
+	Stats.Endpoint = Key.Key;
+	Stats.Model = Key.Value;
+	Stats.RequestCount = Entry.RequestCount;
+	Stats.ErrorCount = Entry.ErrorCount;
+	Stats.QueueTimeMs = Summarize(Entry.QueueTimeMs);
+	Stats.TimeToFirstByteMs = Summarize(Entry.TimeToFirstByteMs);
+	Stats.TimeToFirstTokenMs = Summarize(Entry.TimeToFirstTokenMs);
+	Stats.TotalTimeMs = Summarize(Entry.TotalTimeMs);
+	Stats.TokensPerSecond = Summarize(Entry.TokensPerSecond);
+	Stats.BytesSent = Summarize(Entry.BytesSent);
+	Stats.BytesReceived = Summarize(Entry.BytesReceived);
+	return Stats;
+}
+
+//========== Console ==========//
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GPlayKitStatsCommand(
+	TEXT("playkit.stats"),
+	TEXT("Print PlayKit request latency and throughput per endpoint and model. 'playkit.stats reset' clears them."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Output)
+		{
+			UPlayKitMetrics* Metrics = UPlayKitMetrics::Get(World);
+			if (!Metrics)
+			{
+				Output.Logf(TEXT("[Metrics] No game instance"));
+				return;
+			}
+
+			if (Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+			{
+				Metrics->ResetStats();
+				return;
+			}
+
+			Metrics->DumpStats(&Output);
+		}));
@@ -0,0 +1,222 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Tool/PlayKitTokenEstimator.h"
+#include "PlayKitMetrics.generated.h"
+
+/**
+ * Log-linear histogram in the style of HdrHistogram.
+ *
+ * Values are bucketed by power of two, with 32 linear sub-buckets per power,
+ * so any recorded value is reported within ~3% regardless of magnitude and
+ * recording is O(1) with no allocation once the range has been seen.
+ */
+class PLAYKITSDK_API FPlayKitHistogram
+{
+public:
+	/** @param InResolution Smallest distinguishable step, in value units (e.g. 0.001 for 1us on a millisecond histogram) */
+	explicit FPlayKitHistogram(double InResolution = 0.001);
+
+	void Record(double Value);
+	void Reset();
+
+	int64 GetCount() const { return Count; }
+	double GetMin() const { return Count > 0 ? Min : 0.0; }
+	double GetMax() const { return Count > 0 ? Max : 0.0; }
+	double GetMean() const { return Count > 0 ? Sum / Count : 0.0; }
+	double GetSum() const { return Sum; }
+
+	/** Value at the given percentile (0-100), or 0 if empty */
+	double GetPercentile(double Percentile) const;
+
+private:
+	static int32 GetBucketIndex(uint64 Scaled);
+	static uint64 GetBucketMidpoint(int32 Index);
+
+	TArray<uint32> Buckets;
+	double Resolution;
+	int64 Count = 0;
+	double Sum = 0.0;
+	double Min = 0.0;
+	double Max = 0.0;
+};
+
+/**
+ * Summary of one histogram
+ */
+USTRUCT(BlueprintType)
+struct PLAYKITSDK_API FPlayKitMetricSummary
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float Min = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float Mean = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float P50 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float P95 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float P99 = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	float Max = 0.0f;
+};
+
+/**
+ * Request metrics for one endpoint and model
+ */
+USTRUCT(BlueprintType)
+struct PLAYKITSDK_API FPlayKitEndpointStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	EPlayKitEndpoint Endpoint = EPlayKitEndpoint::Chat;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FString Model;
+
+	/** Requests that completed, successfully or not (cancelled requests are not counted) */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	int32 RequestCount = 0;
+
+	/** Network failures and non-2xx responses */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	int32 ErrorCount = 0;
+
+	/** Time spent waiting in the scheduler queue (ms) */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary QueueTimeMs;
+
+	/** From send to the first response byte (ms) */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary TimeToFirstByteMs;
+
+	/** From submit to the first token the player could see (ms). Equals total time for non-streaming requests */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary TimeToFirstTokenMs;
+
+	/** From submit to completion (ms) */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary TotalTimeMs;
+
+	/** Generated tokens per second, measured from the first token to completion for streams */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary TokensPerSecond;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary BytesSent;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit|Metrics")
+	FPlayKitMetricSummary BytesReceived;
+};
+
+/**
+ * PlayKit Metrics
+ * Records the lifecycle of every request that goes through UPlayKitRequestScheduler.
+ *
+ * The scheduler reports queueing, sending, the first response byte and completion;
+ * clients add what only they know (first visible token, generated token count).
+ * Samples go into per-endpoint, per-model histograms.
+ *
+ * Query with GetStats/GetAllStats, or run "playkit.stats" in the console
+ * ("playkit.stats reset" clears everything).
+ */
+UCLASS()
+class PLAYKITSDK_API UPlayKitMetrics : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Metrics", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitMetrics* Get(const UObject* WorldContextObject);
+
+	//========== Client Hooks ==========//
+
+	/** Mark the first token of a response as visible. Later calls for the same request are ignored */
+	static void NoteFirstToken(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request);
+
+	/** Report how many tokens a request generated. Call before the completion handler returns */
+	static void NoteGeneratedTokens(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request, int32 Tokens);
+
+	/** Estimated token count for responses that do not report usage */
+	static int32 EstimateTokenCount(const FString& Text) { return FPlayKitTokenEstimator::EstimateTokens(Text); }
+
+	//========== Scheduler Hooks ==========//
+
+	void BeginTrace(const IHttpRequest* Request, EPlayKitEndpoint Endpoint, const FString& Model);
+	void MarkSent(const IHttpRequest* Request);
+	void MarkFirstByte(const IHttpRequest* Request);
+	void EndTrace(const IHttpRequest* Request, const FHttpResponsePtr& Response, bool bWasSuccessful);
+	void DiscardTrace(const IHttpRequest* Request);
+
+	//========== Queries ==========//
+
+	/** Stats for one endpoint and model. Returns false if nothing was recorded for them */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Metrics")
+	bool GetStats(EPlayKitEndpoint Endpoint, const FString& Model, FPlayKitEndpointStats& OutStats) const;
+
+	/** Stats for every endpoint and model seen so far */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Metrics")
+	TArray<FPlayKitEndpointStats> GetAllStats() const;
+
+	/** Clear all recorded samples */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Metrics")
+	void ResetStats();
+
+	/** Write a table of all stats to an output device (the log if null) */
+	void DumpStats(FOutputDevice* Output = nullptr) const;
+
+private:
+	struct FRequestTrace
+	{
+		EPlayKitEndpoint Endpoint = EPlayKitEndpoint::Chat;
+		FString Model;
+		double QueuedAt = 0.0;
+		double SentAt = 0.0;
+		double FirstByteAt = 0.0;
+		double FirstTokenAt = 0.0;
+		int32 GeneratedTokens = 0;
+	};
+
+	struct FSeries
+	{
+		int32 RequestCount = 0;
+		int32 ErrorCount = 0;
+		FPlayKitHistogram QueueTimeMs;
+		FPlayKitHistogram TimeToFirstByteMs;
+		FPlayKitHistogram TimeToFirstTokenMs;
+		FPlayKitHistogram TotalTimeMs;
+		FPlayKitHistogram TokensPerSecond;
+		FPlayKitHistogram BytesSent{ 1.0 };
+		FPlayKitHistogram BytesReceived{ 1.0 };
+	};
+
+	using FSeriesKey = TPair<EPlayKitEndpoint, FString>;
+
+	static FPlayKitMetricSummary Summarize(const FPlayKitHistogram& Histogram);
+	static FPlayKitEndpointStats MakeStats(const FSeriesKey& Key, const FSeries& Entry);
+
+	// Requests between submit and completion, keyed by request
+	TMap<const IHttpRequest*, FRequestTrace> Traces;
+
+	TMap<FSeriesKey, FSeries> Series;
+};
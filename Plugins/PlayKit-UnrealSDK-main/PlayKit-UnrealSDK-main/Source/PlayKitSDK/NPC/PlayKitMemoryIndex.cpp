@@ -0,0 +1,345 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitMemoryIndex.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitTokenEstimator.h"
+#include "Misc/Crc.h"
+
+namespace
+{
+	const float BM25K1 = 1.2f;
+	const float BM25B = 0.75f;
+
+	/** Longer words are hashed on their first characters only */
+	const int32 MaxTermLength = 32;
+
+	uint32 HashTerm(const TCHAR* Term, int32 Length)
+	{
+		return FCrc::MemCrc32(Term, Length * sizeof(TCHAR));
+	}
+
+	/** Length of a lowercase word without a plural or third person "s" (but "glass" stays) */
+	int32 StemLength(const TCHAR* Word, int32 Length)
+	{
+		return (Length > 3 && Word[Length - 1] == TEXT('s') && Word[Length - 2] != TEXT('s')) ? Length - 1 : Length;
+	}
+
+	const TSet<uint32>& GetStopwords()
+	{
+		static const TSet<uint32> Stopwords = []()
+		{
+			static const TCHAR* const Words[] = {
+				TEXT("a"), TEXT("an"), TEXT("and"), TEXT("are"), TEXT("as"), TEXT("at"), TEXT("be"), TEXT("but"), TEXT("by"),
+				TEXT("do"), TEXT("does"), TEXT("for"), TEXT("from"), TEXT("had"), TEXT("has"), TEXT("have"), TEXT("he"), TEXT("her"),
+				TEXT("him"), TEXT("his"), TEXT("how"), TEXT("i"), TEXT("if"), TEXT("in"), TEXT("is"), TEXT("it"), TEXT("its"),
+				TEXT("me"), TEXT("my"), TEXT("no"), TEXT("not"), TEXT("of"), TEXT("on"), TEXT("or"), TEXT("so"), TEXT("she"),
+				TEXT("that"), TEXT("the"), TEXT("their"), TEXT("them"), TEXT("then"), TEXT("there"), TEXT("they"), TEXT("this"),
+				TEXT("to"), TEXT("was"), TEXT("we"), TEXT("were"), TEXT("what"), TEXT("when"), TEXT("where"), TEXT("which"),
+				TEXT("who"), TEXT("why"), TEXT("will"), TEXT("with"), TEXT("you"), TEXT("your")
+			};
+
+			// Stemmed the way the tokenizer stems, so "this" matches as "thi"
+			TSet<uint32> Result;
+			for (const TCHAR* Word : Words)
+			{
+				Result.Add(HashTerm(Word, StemLength(Word, FCString::Strlen(Word))));
+			}
+			return Result;
+		}();
+		return Stopwords;
+	}
+}
+
+//========== Query ==========//
+
+void FPlayKitMemoryIndex::FQuery::AddText(FStringView Text, float Weight)
+{
+	Tokenize(Text, [this, Weight](uint32 Term)
+	{
+		Terms.FindOrAdd(Term) += Weight;
+	});
+}
+
+//========== Tokenizer ==========//
+
+void FPlayKitMemoryIndex::Tokenize(FStringView Text, TFunctionRef<void(uint32 Term)> Visit)
+{
+	const TSet<uint32>& Stopwords = GetStopwords();
+
+	TCHAR Word[MaxTermLength];
+	int32 Length = 0;
+	int32 FullLength = 0;
+
+	auto FlushWord = [&]()
+	{
+		if (FullLength > 0)
+		{
+			// Truncated words keep their ending
+			const int32 TermLength = Length == FullLength ? StemLength(Word, Length) : Length;
+			const uint32 Term = HashTerm(Word, TermLength);
+			if (!Stopwords.Contains(Term))
+			{
+				Visit(Term);
+			}
+		}
+		Length = 0;
+		FullLength = 0;
+	};
+
+	for (const TCHAR Char : Text)
+	{
+		if (FChar::IsAlnum(Char) && Char < 0x80)
+		{
+			if (Length < MaxTermLength)
+			{
+				Word[Length++] = FChar::ToLower(Char);
+			}
+			++FullLength;
+		}
+		else
+		{
+			FlushWord();
+
+			// Scripts without spaces: each character is a word
+			if (Char >= 0x80 && FChar::IsAlpha(Char))
+			{
+				Visit(HashTerm(&Char, 1));
+			}
+		}
+	}
+	FlushWord();
+}
+
+//========== Editing ==========//
+
+void FPlayKitMemoryIndex::Set(const FString& Name, const FString& Content)
+{
+	bool bPinned = false;
+	if (const int32* Existing = DocByName.Find(Name))
+	{
+		bPinned = Docs[*Existing].bPinned;
+		RemoveDoc(*Existing);
+	}
+
+	const int32 Id = FreeDocs.Num() > 0 ? FreeDocs.Pop(EAllowShrinking::No) : Docs.AddDefaulted();
+	FDoc& Doc = Docs[Id];
+	Doc.Name = Name;
+	Doc.bPinned = bPinned;
+	Doc.bLive = true;
+	Doc.Sequence = ++NextSequence;
+
+	// Term frequencies over the name and the content
+	TMap<uint32, uint16, TInlineSetAllocator<32>> Frequencies;
+	auto CountTerm = [&Frequencies, &Doc](uint32 Term)
+	{
+		uint16& Frequency = Frequencies.FindOrAdd(Term);
+		Frequency = static_cast<uint16>(FMath::Min<int32>(Frequency + 1, MAX_uint16));
+		++Doc.Length;
+	};
+	Tokenize(Name, CountTerm);
+	Tokenize(Content, CountTerm);
+
+	Doc.Terms.Reset(Frequencies.Num());
+	for (const TPair<uint32, uint16>& Pair : Frequencies)
+	{
+		Doc.Terms.Add(Pair);
+		Postings.FindOrAdd(Pair.Key).Add({ Id, Pair.Value });
+	}
+
+	// The line as it appears in the prompt, escaped once here
+	const FString Line = FString::Printf(TEXT("- %s: %s\n"), *Name, *Content);
+	FPlayKitJsonWriter Json(Line.Len() + 16);
+	Json.WriteString(Line);
+	Doc.PromptLine = Json.Finish();
+	Doc.PromptLine.RemoveAt(0, 1, EAllowShrinking::No);
+	Doc.PromptLine.Pop(EAllowShrinking::No);
+	Doc.Tokens = FPlayKitTokenEstimator::EstimateTokens(Line);
+
+	DocByName.Add(Name, Id);
+	TotalLength += Doc.Length;
+	TotalTokens += Doc.Tokens;
+}
+
+void FPlayKitMemoryIndex::Remove(const FString& Name)
+{
+	if (const int32* Existing = DocByName.Find(Name))
+	{
+		RemoveDoc(*Existing);
+	}
+}
+
+void FPlayKitMemoryIndex::RemoveDoc(int32 Id)
+{
+	FDoc& Doc = Docs[Id];
+	for (const TPair<uint32, uint16>& Term : Doc.Terms)
+	{
+		if (TArray<FPosting>* List = Postings.Find(Term.Key))
+		{
+			List->RemoveAllSwap([Id](const FPosting& Posting) { return Posting.Doc == Id; }, EAllowShrinking::No);
+			if (List->IsEmpty())
+			{
+				Postings.Remove(Term.Key);
+			}
+		}
+	}
+
+	DocByName.Remove(Doc.Name);
+	TotalLength -= Doc.Length;
+	TotalTokens -= Doc.Tokens;
+
+	Doc = FDoc();
+	FreeDocs.Add(Id);
+}
+
+void FPlayKitMemoryIndex::Reset()
+{
+	Docs.Reset();
+	FreeDocs.Reset();
+	DocByName.Reset();
+	Postings.Reset();
+	TotalLength = 0;
+	TotalTokens = 0;
+	NextSequence = 0;
+}
+
+void FPlayKitMemoryIndex::SetPinned(const FString& Name, bool bPinned)
+{
+	if (const int32* Existing = DocByName.Find(Name))
+	{
+		Docs[*Existing].bPinned = bPinned;
+	}
+}
+
+bool FPlayKitMemoryIndex::IsPinned(const FString& Name) const
+{
+	const int32* Existing = DocByName.Find(Name);
+	return Existing && Docs[*Existing].bPinned;
+}
+
+//========== Selection ==========//
+
+void FPlayKitMemoryIndex::Rank(const FQuery& Query, TArray<TPair<int32, float>>& OutScores) const
+{
+	OutScores.Reset();
+
+	const int32 DocCount = DocByName.Num();
+	if (DocCount == 0 || Query.IsEmpty())
+	{
+		return;
+	}
+
+	const float AverageLength = FMath::Max(1.0f, static_cast<float>(TotalLength) / DocCount);
+
+	TArray<float, TInlineAllocator<256>> Scores;
+	Scores.SetNumZeroed(Docs.Num());
+
+	for (const TPair<uint32, float>& QueryTerm : Query.Terms)
+	{
+		const TArray<FPosting>* List = Postings.Find(QueryTerm.Key);
+		if (!List)
+		{
+			continue;
+		}
+
+		const float DocsWithTerm = static_cast<float>(List->Num());
+		const float Idf = FMath::Loge(1.0f + (DocCount - DocsWithTerm + 0.5f) / (DocsWithTerm + 0.5f));
+		for (const FPosting& Posting : *List)
+		{
+			const float Frequency = Posting.Frequency;
+			const float Norm = BM25K1 * (1.0f - BM25B + BM25B * Docs[Posting.Doc].Length / AverageLength);
+			Scores[Posting.Doc] += QueryTerm.Value * Idf * Frequency * (BM25K1 + 1.0f) / (Frequency + Norm);
+		}
+	}
+
+	for (int32 Id = 0; Id < Scores.Num(); ++Id)
+	{
+		if (Scores[Id] > 0.0f && !Docs[Id].bPinned)
+		{
+			OutScores.Emplace(Id, Scores[Id]);
+		}
+	}
+
+	OutScores.Sort([](const TPair<int32, float>& A, const TPair<int32, float>& B) { return A.Value > B.Value; });
+}
+
+void FPlayKitMemoryIndex::Select(const FQuery& Query, int32 MaxCount, int32 TokenBudget, TArray<int32>& OutIds) const
+{
+	OutIds.Reset();
+
+	int32 UsedTokens = 0;
+	for (int32 Id = 0; Id < Docs.Num(); ++Id)
+	{
+		if (Docs[Id].bLive && Docs[Id].bPinned)
+		{
+			OutIds.Add(Id);
+			UsedTokens += Docs[Id].Tokens;
+		}
+	}
+
+	TArray<TPair<int32, float>> Ranked;
+	Rank(Query, Ranked);
+
+	int32 Picked = 0;
+	auto TryPick = [&](int32 Id)
+	{
+		if (MaxCount > 0 && Picked >= MaxCount)
+		{
+			return false;
+		}
+
+		// A long memory that does not fit may leave room for a shorter one further down
+		const int32 Tokens = Docs[Id].Tokens;
+		if (TokenBudget <= 0 || UsedTokens + Tokens <= TokenBudget)
+		{
+			OutIds.Add(Id);
+			UsedTokens += Tokens;
+			++Picked;
+		}
+		return true;
+	};
+
+	TBitArray<> bScored(false, Docs.Num());
+	for (const TPair<int32, float>& Entry : Ranked)
+	{
+		bScored[Entry.Key] = true;
+		if (!TryPick(Entry.Key))
+		{
+			return;
+		}
+	}
+
+	// Fill what is left with the most recent memories the query did not reach
+	TArray<int32> Unscored;
+	for (int32 Id = 0; Id < Docs.Num(); ++Id)
+	{
+		if (Docs[Id].bLive && !Docs[Id].bPinned && !bScored[Id])
+		{
+			Unscored.Add(Id);
+		}
+	}
+	Unscored.Sort([this](int32 A, int32 B) { return Docs[A].Sequence > Docs[B].Sequence; });
+
+	for (int32 Id : Unscored)
+	{
+		if (!TryPick(Id))
+		{
+			return;
+		}
+	}
+}
+
+void FPlayKitMemoryIndex::GetAll(TArray<int32>& OutIds) const
+{
+	OutIds.Reset(DocByName.Num());
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		const bool bPinnedPass = Pass == 0;
+		for (int32 Id = 0; Id < Docs.Num(); ++Id)
+		{
+			if (Docs[Id].bLive && Docs[Id].bPinned == bPinnedPass)
+			{
+				OutIds.Add(Id);
+			}
+		}
+	}
+}
@@ -0,0 +1,119 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Lexical index over an NPC's memories, for picking the ones worth a place in the prompt.
+ *
+ * Each memory (its name and content) is tokenized into lowercase words (CJK characters count
+ * as words), minus common stopwords and with a plural "s" stripped, and kept in an inverted
+ * index. Queries are scored with BM25 (k1 = 1.2, b = 0.75). Setting or removing a memory
+ * updates only its own postings.
+ *
+ * The index also keeps each memory's prompt line ("- Name: Content\n") JSON-escaped and its
+ * token estimate, so a prompt can be assembled from the selected memories without re-escaping.
+ *
+ * Usage:
+ *   FPlayKitMemoryIndex::FQuery Query;
+ *   Query.AddText(PlayerMessage, 1.0f);
+ *   Query.AddText(LastReply, 0.5f);
+ *   TArray<int32> Selected;
+ *   Index.Select(Query, 8, 500, Selected);
+ */
+class PLAYKITSDK_API FPlayKitMemoryIndex
+{
+public:
+	/** Weighted bag of query terms */
+	class PLAYKITSDK_API FQuery
+	{
+	public:
+		void AddText(FStringView Text, float Weight = 1.0f);
+		bool IsEmpty() const { return Terms.IsEmpty(); }
+
+	private:
+		friend class FPlayKitMemoryIndex;
+		TMap<uint32, float> Terms;
+	};
+
+	//========== Editing ==========//
+
+	/** Add or replace a memory */
+	void Set(const FString& Name, const FString& Content);
+
+	void Remove(const FString& Name);
+
+	void Reset();
+
+	/** Pinned memories are always selected. Unknown names are ignored */
+	void SetPinned(const FString& Name, bool bPinned);
+
+	bool IsPinned(const FString& Name) const;
+
+	//========== Selection ==========//
+
+	/** Number of memories */
+	int32 Num() const { return DocByName.Num(); }
+
+	/** Sum of the token estimates of all prompt lines */
+	int32 GetTotalTokens() const { return TotalTokens; }
+
+	/**
+	 * Pick memories for a prompt: every pinned memory, then unpinned ones by descending score
+	 * while fewer than MaxCount are picked and their lines fit in TokenBudget (pinned lines count
+	 * against it too). Room left after the scored memories is filled with the most recently set
+	 * ones that share no term with the query, so a message like "hi" still gets some context.
+	 * MaxCount or TokenBudget <= 0 means no limit. OutIds receives memory ids, pinned first.
+	 */
+	void Select(const FQuery& Query, int32 MaxCount, int32 TokenBudget, TArray<int32>& OutIds) const;
+
+	/** Unpinned memories scored against the query, best first, without zero scores */
+	void Rank(const FQuery& Query, TArray<TPair<int32, float>>& OutScores) const;
+
+	/** Every memory id, pinned first */
+	void GetAll(TArray<int32>& OutIds) const;
+
+	//========== Memories ==========//
+
+	const FString& GetName(int32 Id) const { return Docs[Id].Name; }
+
+	/** The memory's prompt line, JSON-escaped UTF-8 without quotes */
+	TConstArrayView<uint8> GetPromptLine(int32 Id) const { return Docs[Id].PromptLine; }
+
+	int32 GetTokens(int32 Id) const { return Docs[Id].Tokens; }
+
+	/** Call Visit for each term of Text, as hashed by the index */
+	static void Tokenize(FStringView Text, TFunctionRef<void(uint32 Term)> Visit);
+
+private:
+	struct FPosting
+	{
+		int32 Doc = 0;
+		uint16 Frequency = 0;
+	};
+
+	struct FDoc
+	{
+		FString Name;
+		TArray<TPair<uint32, uint16>> Terms;
+		TArray<uint8> PromptLine;
+		int32 Length = 0;
+		int32 Tokens = 0;
+		/** Order the memory was last set in; larger is more recent */
+		uint64 Sequence = 0;
+		bool bPinned = false;
+		bool bLive = false;
+	};
+
+	void RemoveDoc(int32 Id);
+
+	TArray<FDoc> Docs;
+	TArray<int32> FreeDocs;
+	TMap<FString, int32> DocByName;
+	TMap<uint32, TArray<FPosting>> Postings;
+
+	int64 TotalLength = 0;
+	int32 TotalTokens = 0;
+	uint64 NextSequence = 0;
+};
@@ -1,10 +1,52 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitNPCActionsModule.h"
+#include "PlayKitLog.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "PlayKitSDK/Tool/PlayKitTool.h"
 
+namespace
+{
+	using FArgumentProblems = TArray<TPair<FString, FString>, TInlineAllocator<4>>;
+
+	/** Error result for a malformed call, worded for the model so it can correct the call */
+	FString MakeArgumentsError(const FString& ActionName, const FArgumentProblems& Problems)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+			TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("error"), FString(TEXT("invalid_arguments")));
+		Writer->WriteValue(TEXT("action"), ActionName);
+		Writer->WriteArrayStart(TEXT("problems"));
+		for (const TPair<FString, FString>& Problem : Problems)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("param"), Problem.Key);
+			Writer->WriteValue(TEXT("message"), Problem.Value);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+		Writer->Close();
+		return Json;
+	}
+}
+
+//========== Action Handler ==========//
+
+void UNPCActionHandlerBase::CompleteAction(const FString& CallId, const FString& Result)
+{
+	if (UPlayKitNPCActionsModule* Module = GetTypedOuter<UPlayKitNPCActionsModule>())
+	{
+		Module->CompleteAction(CallId, Result);
+	}
+}
+
+//========== Actions Module ==========//
+
 UPlayKitNPCActionsModule::UPlayKitNPCActionsModule()
 {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -27,8 +69,20 @@ void UPlayKitNPCActionsModule::RegisterAction(const FNPCAction& Action, FOnActio
 	Registered.Action = Action;
 	Registered.DelegateHandler = Handler;
 	RegisteredActions.Add(Action.ActionName, Registered);
+	bToolsJsonValid = false;
 
-	UE_LOG(LogTemp, Log, TEXT("[ActionsModule] Registered action: %s"), *Action.ActionName);
+	UE_LOG(LogPlayKit, Log, TEXT("[ActionsModule] Registered action: %s"), *Action.ActionName);
+}
+
+void UPlayKitNPCActionsModule::RegisterLatentAction(const FNPCAction& Action, FOnActionExecuteLatent Handler)
+{
+	FRegisteredAction Registered;
+	Registered.Action = Action;
+	Registered.LatentHandler = Handler;
+	RegisteredActions.Add(Action.ActionName, Registered);
+	bToolsJsonValid = false;
+
+	UE_LOG(LogPlayKit, Log, TEXT("[ActionsModule] Registered latent action: %s"), *Action.ActionName);
 }
 
 void UPlayKitNPCActionsModule::RegisterActionBinding(const FNPCActionBinding& Binding)
@@ -37,16 +91,35 @@ void UPlayKitNPCActionsModule::RegisterActionBinding(const FNPCActionBinding& Bi
 	Registered.Action = Binding.Action;
 	Registered.HandlerClass = Binding.HandlerClass;
 	RegisteredActions.Add(Binding.Action.ActionName, Registered);
+	bToolsJsonValid = false;
 
-	UE_LOG(LogTemp, Log, TEXT("[ActionsModule] Registered action binding: %s"), *Binding.Action.ActionName);
+	UE_LOG(LogPlayKit, Log, TEXT("[ActionsModule] Registered action binding: %s"), *Binding.Action.ActionName);
 }
 
 void UPlayKitNPCActionsModule::UnregisterAction(const FString& ActionName)
 {
 	RegisteredActions.Remove(ActionName);
 	HandlerInstances.Remove(ActionName);
+	bToolsJsonValid = false;
+
+	UE_LOG(LogPlayKit, Log, TEXT("[ActionsModule] Unregistered action: %s"), *ActionName);
+}
+
+void UPlayKitNPCActionsModule::SetActionEnabled(const FString& ActionName, bool bEnabled)
+{
+	FRegisteredAction* Registered = RegisteredActions.Find(ActionName);
+	if (!Registered)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[ActionsModule] Action not found: %s"), *ActionName);
+		return;
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("[ActionsModule] Unregistered action: %s"), *ActionName);
+	if (Registered->Action.bEnabled != bEnabled)
+	{
+		Registered->Action.bEnabled = bEnabled;
+		bToolsJsonValid = false;
+		UE_LOG(LogPlayKit, Log, TEXT("[ActionsModule] %s action: %s"), bEnabled ? TEXT("Enabled") : TEXT("Disabled"), *ActionName);
+	}
 }
 
 TArray<FNPCAction> UPlayKitNPCActionsModule::GetEnabledActions() const
@@ -78,47 +151,232 @@ bool UPlayKitNPCActionsModule::HasEnabledActions() const
 
 FString UPlayKitNPCActionsModule::ExecuteAction(const FNPCActionCallArgs& Args)
 {
+	bool bLatent = false;
+	return DispatchAction(Args, bLatent);
+}
+
+void UPlayKitNPCActionsModule::StartAction(const FNPCActionCallArgs& Args)
+{
+	// Errors, rejected calls included, complete at once like synchronous results
+	bool bLatent = false;
+	const FString Result = DispatchAction(Args, bLatent);
+	if (!bLatent)
+	{
+		CompleteAction(Args.CallId, Result);
+	}
+}
+
+FString UPlayKitNPCActionsModule::DispatchAction(const FNPCActionCallArgs& Args, bool& bOutLatent)
+{
+	bOutLatent = false;
+
 	const FRegisteredAction* Registered = RegisteredActions.Find(Args.ActionName);
 	if (!Registered)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[ActionsModule] Action not found: %s"), *Args.ActionName);
+		UE_LOG(LogPlayKit, Warning, TEXT("[ActionsModule] Action not found: %s"), *Args.ActionName);
 		return FString::Printf(TEXT("Error: Action '%s' not found"), *Args.ActionName);
 	}
 
+	// The model may still call an action it was offered before it was disabled
+	if (!Registered->Action.bEnabled)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[ActionsModule] Rejected call to disabled action: %s"), *Args.ActionName);
+		return FString::Printf(TEXT("Error: Action '%s' is currently disabled"), *Args.ActionName);
+	}
+
+	// Malformed calls never reach the handler
+	FNPCActionCallArgs Prepared = Args;
+	FString Error;
+	if (!PrepareActionArgs(Prepared, Error))
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[ActionsModule] Rejected call to %s: %s"), *Args.ActionName, *Error);
+		return Error;
+	}
+
 	// Try delegate handler first
 	if (Registered->DelegateHandler.IsBound())
 	{
-		return Registered->DelegateHandler.Execute(Args);
+		return Registered->DelegateHandler.Execute(Prepared);
+	}
+
+	if (Registered->LatentHandler.IsBound())
+	{
+		bOutLatent = true;
+		Registered->LatentHandler.Execute(Prepared);
+		return FString();
 	}
 
 	// Try class-based handler
-	if (Registered->HandlerClass)
+	if (UNPCActionHandlerBase* Handler = GetHandlerInstance(Args.ActionName, *Registered))
 	{
-		// Get or create handler instance
-		UNPCActionHandlerBase** ExistingInstance = HandlerInstances.Find(Args.ActionName);
-		UNPCActionHandlerBase* Handler = nullptr;
+		const FString Result = Handler->Execute(Prepared);
+		bOutLatent = Handler->bLatent;
+		return bOutLatent ? FString() : Result;
+	}
 
-		if (ExistingInstance)
-		{
-			Handler = *ExistingInstance;
-		}
-		else
+	UE_LOG(LogPlayKit, Warning, TEXT("[ActionsModule] No handler for action: %s"), *Args.ActionName);
+	return FString::Printf(TEXT("Error: No handler for action '%s'"), *Args.ActionName);
+}
+
+bool UPlayKitNPCActionsModule::PrepareActionArgs(FNPCActionCallArgs& Args, FString& OutError) const
+{
+	OutError.Reset();
+	Args.TypedParameters.Reset();
+
+	const FRegisteredAction* Registered = RegisteredActions.Find(Args.ActionName);
+	FArgumentProblems Problems;
+	if (!Registered)
+	{
+		Problems.Emplace(FString(), TEXT("unknown action"));
+		OutError = MakeArgumentsError(Args.ActionName, Problems);
+		return false;
+	}
+
+	for (const FNPCActionParam& Param : Registered->Action.Parameters)
+	{
+		// JSON null arrives as an empty string; either counts as not given
+		const FString* Raw = Args.RawParameters.Find(Param.Name);
+		if (!Raw || Raw->TrimStartAndEnd().IsEmpty())
 		{
-			Handler = NewObject<UNPCActionHandlerBase>(this, Registered->HandlerClass);
-			HandlerInstances.Add(Args.ActionName, Handler);
+			if (Param.bRequired)
+			{
+				Problems.Emplace(Param.Name, TEXT("required parameter is missing"));
+			}
+			continue;
 		}
 
-		if (Handler)
+		switch (Param.Type)
 		{
-			return Handler->Execute(Args);
+		case ENPCParamType::String:
+			Args.TypedParameters.Add(Param.Name, FNPCActionArgValue(TInPlaceType<FString>(), *Raw));
+			break;
+
+		case ENPCParamType::Number:
+			{
+				double Number = 0.0;
+				if (LexTryParseString(Number, *Raw->TrimStartAndEnd()) && FMath::IsFinite(Number))
+				{
+					Args.TypedParameters.Add(Param.Name, FNPCActionArgValue(TInPlaceType<double>(), Number));
+				}
+				else
+				{
+					Problems.Emplace(Param.Name, FString::Printf(TEXT("expected a number, got \"%s\""), **Raw));
+				}
+			}
+			break;
+
+		case ENPCParamType::Boolean:
+			{
+				const FString Trimmed = Raw->TrimStartAndEnd();
+				const bool bTrue = Trimmed.Equals(TEXT("true"), ESearchCase::IgnoreCase) || Trimmed == TEXT("1");
+				const bool bFalse = Trimmed.Equals(TEXT("false"), ESearchCase::IgnoreCase) || Trimmed == TEXT("0");
+				if (bTrue || bFalse)
+				{
+					Args.TypedParameters.Add(Param.Name, FNPCActionArgValue(TInPlaceType<bool>(), bTrue));
+				}
+				else
+				{
+					Problems.Emplace(Param.Name, FString::Printf(TEXT("expected true or false, got \"%s\""), **Raw));
+				}
+			}
+			break;
+
+		case ENPCParamType::Enum:
+			{
+				// No declared options: any string is accepted
+				if (Param.EnumOptions.Num() == 0)
+				{
+					Args.TypedParameters.Add(Param.Name, FNPCActionArgValue(TInPlaceType<FString>(), *Raw));
+					break;
+				}
+
+				// Stored as declared, so handlers can compare case-sensitively
+				const FString* Option = Param.EnumOptions.FindByPredicate([Raw](const FString& Candidate) { return Candidate.Equals(*Raw, ESearchCase::CaseSensitive); });
+				if (!Option)
+				{
+					Option = Param.EnumOptions.FindByPredicate([Raw](const FString& Candidate) { return Candidate.Equals(*Raw, ESearchCase::IgnoreCase); });
+				}
+
+				if (Option)
+				{
+					Args.TypedParameters.Add(Param.Name, FNPCActionArgValue(TInPlaceType<FString>(), *Option));
+				}
+				else
+				{
+					Problems.Emplace(Param.Name, FString::Printf(TEXT("expected one of %s, got \"%s\""), *FString::Join(Param.EnumOptions, TEXT(", ")), **Raw));
+				}
+			}
+			break;
 		}
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("[ActionsModule] No handler for action: %s"), *Args.ActionName);
-	return FString::Printf(TEXT("Error: No handler for action '%s'"), *Args.ActionName);
+	if (Problems.Num() > 0)
+	{
+		OutError = MakeArgumentsError(Args.ActionName, Problems);
+		return false;
+	}
+	return true;
+}
+
+void UPlayKitNPCActionsModule::CompleteAction(const FString& CallId, const FString& Result)
+{
+	OnActionCompleted.Broadcast(CallId, Result);
+}
+
+bool UPlayKitNPCActionsModule::IsLatentAction(const FString& ActionName) const
+{
+	const FRegisteredAction* Registered = RegisteredActions.Find(ActionName);
+	if (!Registered || Registered->DelegateHandler.IsBound())
+	{
+		return false;
+	}
+	if (Registered->LatentHandler.IsBound())
+	{
+		return true;
+	}
+	return Registered->HandlerClass && Registered->HandlerClass.GetDefaultObject()->bLatent;
+}
+
+UNPCActionHandlerBase* UPlayKitNPCActionsModule::GetHandlerInstance(const FString& ActionName, const FRegisteredAction& Registered)
+{
+	if (!Registered.HandlerClass)
+	{
+		return nullptr;
+	}
+
+	// Get or create handler instance
+	if (UNPCActionHandlerBase** ExistingInstance = HandlerInstances.Find(ActionName))
+	{
+		return *ExistingInstance;
+	}
+
+	UNPCActionHandlerBase* Handler = NewObject<UNPCActionHandlerBase>(this, Registered.HandlerClass);
+	HandlerInstances.Add(ActionName, Handler);
+	return Handler;
 }
 
 FString UPlayKitNPCActionsModule::GetActionsAsJsonSchema() const
+{
+	TSharedPtr<FJsonObject> RootObj = MakeShared<FJsonObject>();
+	RootObj->SetArrayField(TEXT("tools"), BuildToolsArray());
+
+	return UPlayKitTool::JsonObjectToString(RootObj, true);
+}
+
+const FString& UPlayKitNPCActionsModule::GetToolsJson() const
+{
+	if (!bToolsJsonValid)
+	{
+		ToolsJson.Reset();
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+			TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ToolsJson);
+		FJsonSerializer::Serialize(BuildToolsArray(), Writer);
+		bToolsJsonValid = true;
+	}
+	return ToolsJson;
+}
+
+TArray<TSharedPtr<FJsonValue>> UPlayKitNPCActionsModule::BuildToolsArray() const
 {
 	TArray<TSharedPtr<FJsonValue>> ToolsArray;
 
@@ -193,9 +451,5 @@ FString UPlayKitNPCActionsModule::GetActionsAsJsonSchema() const
 		ToolsArray.Add(MakeShared<FJsonValueObject>(ToolObj));
 	}
 
-	// Serialize to string
-	TSharedPtr<FJsonObject> RootObj = MakeShared<FJsonObject>();
-	RootObj->SetArrayField(TEXT("tools"), ToolsArray);
-
-	return UPlayKitTool::JsonObjectToString(RootObj, true);
+	return ToolsArray;
 }
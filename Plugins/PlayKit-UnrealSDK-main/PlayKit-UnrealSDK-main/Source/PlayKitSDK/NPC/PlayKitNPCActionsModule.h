@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Interface.h"
+#include "Misc/TVariant.h"
 #include "PlayKitNPCActionsModule.generated.h"
 
 /**
@@ -38,7 +39,7 @@ struct FNPCActionParam
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bRequired = true;
 
-	/** Enum options (only used when Type is Enum) */
+	/** Enum options (only used when Type is Enum). Empty accepts any string */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TArray<FString> EnumOptions;
 
@@ -121,8 +122,17 @@ struct FNPCAction
 	}
 };
 
+/**
+ * An action argument converted to its parameter's type: strings and enum options
+ * as FString, numbers as double, booleans as bool
+ */
+using FNPCActionArgValue = TVariant<FString, double, bool>;
+
 /**
  * NPC Action Call Arguments
+ * UPlayKitNPCActionsModule converts the arguments to their declared types once, before
+ * dispatch (see PrepareActionArgs), so the getters below only look them up. Arguments
+ * built by hand without a module are converted from RawParameters on each access.
  */
 USTRUCT(BlueprintType)
 struct FNPCActionCallArgs
@@ -138,9 +148,16 @@ struct FNPCActionCallArgs
 	UPROPERTY(BlueprintReadOnly)
 	TMap<FString, FString> RawParameters;
 
+	/** Declared parameters, converted; undeclared ones are only in RawParameters */
+	TMap<FString, FNPCActionArgValue> TypedParameters;
+
 	/** Get string parameter */
 	FString GetString(const FString& ParamName) const
 	{
+		if (const FString* Typed = FindTyped<FString>(ParamName))
+		{
+			return *Typed;
+		}
 		const FString* Value = RawParameters.Find(ParamName);
 		return Value ? *Value : FString();
 	}
@@ -148,6 +165,10 @@ struct FNPCActionCallArgs
 	/** Get number parameter */
 	float GetNumber(const FString& ParamName) const
 	{
+		if (const double* Typed = FindTyped<double>(ParamName))
+		{
+			return static_cast<float>(*Typed);
+		}
 		const FString* Value = RawParameters.Find(ParamName);
 		return Value ? FCString::Atof(**Value) : 0.0f;
 	}
@@ -155,6 +176,10 @@ struct FNPCActionCallArgs
 	/** Get integer parameter */
 	int32 GetInt(const FString& ParamName) const
 	{
+		if (const double* Typed = FindTyped<double>(ParamName))
+		{
+			return FMath::TruncToInt32(*Typed);
+		}
 		const FString* Value = RawParameters.Find(ParamName);
 		return Value ? FCString::Atoi(**Value) : 0;
 	}
@@ -162,11 +187,23 @@ struct FNPCActionCallArgs
 	/** Get boolean parameter */
 	bool GetBool(const FString& ParamName) const
 	{
+		if (const bool* Typed = FindTyped<bool>(ParamName))
+		{
+			return *Typed;
+		}
 		const FString* Value = RawParameters.Find(ParamName);
 		if (!Value) return false;
 		return Value->Equals(TEXT("true"), ESearchCase::IgnoreCase) || *Value == TEXT("1");
 	}
 
+	/** The converted argument, if the parameter is declared with this type and was given */
+	template <typename T>
+	const T* FindTyped(const FString& ParamName) const
+	{
+		const FNPCActionArgValue* Value = TypedParameters.Find(ParamName);
+		return Value ? Value->TryGet<T>() : nullptr;
+	}
+
 	/** Check if parameter exists */
 	bool HasParam(const FString& ParamName) const
 	{
@@ -196,7 +233,9 @@ public:
 };
 
 /**
- * Base class for synchronous action handlers
+ * Base class for action handlers.
+ * Synchronous by default. A latent handler (bLatent) starts its work in Execute and reports
+ * the result later with CompleteAction.
  */
 UCLASS(Abstract, Blueprintable)
 class PLAYKITSDK_API UNPCActionHandlerBase : public UObject, public INPCActionHandler
@@ -204,6 +243,14 @@ class PLAYKITSDK_API UNPCActionHandlerBase : public UObject, public INPCActionHa
 	GENERATED_BODY()
 
 public:
+	/** Execute only starts the action; its return value is ignored */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="PlayKit|NPC|Actions")
+	bool bLatent = false;
+
+	/** Report the result of a latent action started by Execute */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	void CompleteAction(const FString& CallId, const FString& Result);
+
 	/** Override to define actions */
 	UFUNCTION(BlueprintNativeEvent, Category="PlayKit|NPC|Actions")
 	TArray<FNPCAction> GetActionDefinitions();
@@ -233,6 +280,11 @@ struct FNPCActionBinding
 // Delegate for action execution result
 DECLARE_DYNAMIC_DELEGATE_RetVal_OneParam(FString, FOnActionExecute, const FNPCActionCallArgs&, Args);
 
+// Delegate that starts a latent action; the handler reports its result with CompleteAction
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnActionExecuteLatent, const FNPCActionCallArgs&, Args);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNPCActionCompleted, FString, CallId, FString, Result);
+
 /**
  * NPC Actions Module Component
  * Manages action definitions and execution for an NPC
@@ -253,6 +305,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
 	void RegisterAction(const FNPCAction& Action, FOnActionExecute Handler);
 
+	/** Register an action whose handler finishes later, by calling CompleteAction with the call's id */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	void RegisterLatentAction(const FNPCAction& Action, FOnActionExecuteLatent Handler);
+
 	/** Register an action binding */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
 	void RegisterActionBinding(const FNPCActionBinding& Binding);
@@ -261,6 +317,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
 	void UnregisterAction(const FString& ActionName);
 
+	/** Enable or disable a registered action. Disabled actions are not offered to the model, and calls to them are rejected */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	void SetActionEnabled(const FString& ActionName, bool bEnabled);
+
 	/** Get all enabled actions */
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Actions")
 	TArray<FNPCAction> GetEnabledActions() const;
@@ -269,29 +329,71 @@ public:
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Actions")
 	bool HasEnabledActions() const;
 
-	/** Execute an action by name */
+	/** Execute an action by name. Latent actions are only started, and return an empty string */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
 	FString ExecuteAction(const FNPCActionCallArgs& Args);
 
+	/**
+	 * Start an action; OnActionCompleted fires with its result, at once for synchronous
+	 * handlers and when the handler calls CompleteAction for latent ones
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	void StartAction(const FNPCActionCallArgs& Args);
+
+	/** Report the result of a latent action */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	void CompleteAction(const FString& CallId, const FString& Result);
+
+	/** True if the action's handler is latent */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Actions")
+	bool IsLatentAction(const FString& ActionName) const;
+
+	/**
+	 * Convert a call's arguments to the types of the action's parameters, into Args.TypedParameters.
+	 * Returns false if the call is malformed: a required parameter is missing, a number or boolean
+	 * does not parse, or an enum value is not one of the options (options match ignoring case, and
+	 * are stored as declared). OutError then holds a JSON error result for the model:
+	 * {"error":"invalid_arguments","action":...,"problems":[{"param":...,"message":...}]}
+	 * ExecuteAction and StartAction call this and do not dispatch malformed calls.
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
+	bool PrepareActionArgs(UPARAM(ref) FNPCActionCallArgs& Args, FString& OutError) const;
+
 	/** Convert actions to JSON schema for AI */
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Actions")
 	FString GetActionsAsJsonSchema() const;
 
+	/** The enabled actions as a condensed JSON "tools" array, ready for a request body. Cached */
+	const FString& GetToolsJson() const;
+
 public:
 	/** Pre-configured action bindings (set in editor) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Actions")
 	TArray<FNPCActionBinding> ActionBindings;
 
+	/** Fired with the result of each action started with StartAction */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|NPC|Actions")
+	FOnNPCActionCompleted OnActionCompleted;
+
 private:
 	struct FRegisteredAction
 	{
 		FNPCAction Action;
 		FOnActionExecute DelegateHandler;
+		FOnActionExecuteLatent LatentHandler;
 		TSubclassOf<UNPCActionHandlerBase> HandlerClass;
 	};
 
+	UNPCActionHandlerBase* GetHandlerInstance(const FString& ActionName, const FRegisteredAction& Registered);
+	FString DispatchAction(const FNPCActionCallArgs& Args, bool& bOutLatent);
+	TArray<TSharedPtr<class FJsonValue>> BuildToolsArray() const;
+
 	TMap<FString, FRegisteredAction> RegisteredActions;
 
+	/** GetToolsJson, rebuilt after actions are registered, unregistered, enabled or disabled */
+	mutable FString ToolsJson;
+	mutable bool bToolsJsonValid = false;
+
 	UPROPERTY()
 	TMap<FString, UNPCActionHandlerBase*> HandlerInstances;
 };
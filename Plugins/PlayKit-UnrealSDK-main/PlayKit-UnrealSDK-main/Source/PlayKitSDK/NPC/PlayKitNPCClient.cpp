@@ -1,13 +1,47 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitNPCClient.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
-#include "HttpModule.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Tool/PlayKitTokenEstimator.h"
+#include "Transport/PlayKitTransport.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
 #include "Dom/JsonValue.h"
 #include "Serialization/JsonSerializer.h"
 #include "Tool/PlayKitTool.h"
+#include "Scheduler/PlayKitRequestScheduler.h"
+#include "Metrics/PlayKitMetrics.h"
+#include "NPC/PlayKitNPCSaveFormat.h"
+#include "NPC/PlayKitNPCJournal.h"
+#include "NPC/PlayKitNPCActionsModule.h"
+#include "Context/PlayKitNPCLODManager.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	/** History messages, besides the new one, that memory selection matches against */
+	const int32 MemoryQueryHistoryMessages = 4;
+
+	const TCHAR* const MemoriesHeader = TEXT("\n\n[Current Memories]\n");
+
+	/** MemoriesHeader, JSON-escaped */
+	const ANSICHAR MemoriesHeaderJson[] = "\\n\\n[Current Memories]\\n";
+
+	/** Closes the system message's content string and object */
+	const ANSICHAR SystemMessageEnd[] = "\"}";
+
+	void AppendAnsi(TArray<uint8>& Out, const ANSICHAR* Text, int32 Length)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(Text), Length);
+	}
+}
 
 UPlayKitNPCClient::UPlayKitNPCClient()
 {
@@ -17,6 +51,39 @@ UPlayKitNPCClient::UPlayKitNPCClient()
 void UPlayKitNPCClient::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (bRestoreFromJournal)
+	{
+		if (UPlayKitNPCJournal* Journal = GetJournal())
+		{
+			Journal->Restore(this);
+		}
+	}
+}
+
+void UPlayKitNPCClient::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelSpeculations();
+	ResetActionRound();
+	if (UPlayKitNPCActionsModule* ActionsModule = GetActionsModule())
+	{
+		ActionsModule->OnActionCompleted.RemoveDynamic(this, &UPlayKitNPCClient::HandleActionCompleted);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+UPlayKitNPCJournal* UPlayKitNPCClient::GetJournal() const
+{
+	return JournalId.IsEmpty() ? nullptr : UPlayKitNPCJournal::Get(this);
+}
+
+void UPlayKitNPCClient::AddToHistory(ENPCMessageRole Role, const FString& Content)
+{
+	ConversationHistory.Add(Role, Content);
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordMessage(this, Role, Content);
+	}
 }
 
 void UPlayKitNPCClient::Setup(const FString& ModelName)
@@ -26,11 +93,11 @@ void UPlayKitNPCClient::Setup(const FString& ModelName)
 	{
 		Model = ModelName.IsEmpty() ? Settings->DefaultChatModel : ModelName;
 		bIsSetup = true;
-		UE_LOG(LogTemp, Log, TEXT("[PlayKit] NPCClient setup with model: %s"), *Model);
+		UE_LOG(LogPlayKit, Log, TEXT("[PlayKit] NPCClient setup with model: %s"), *Model);
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] NPCClient setup failed - Settings not found"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] NPCClient setup failed - Settings not found"));
 	}
 }
 
@@ -79,22 +146,71 @@ FString UPlayKitNPCClient::GetAuthToken() const
 	return TEXT("");
 }
 
+FString UPlayKitNPCClient::GetRequestModel() const
+{
+	if (LODSettings.bUseFastModel)
+	{
+		UPlayKitSettings* Settings = UPlayKitSettings::Get();
+		if (Settings && !Settings->FastModel.IsEmpty())
+		{
+			return Settings->FastModel;
+		}
+	}
+	return Model;
+}
+
+int32 UPlayKitNPCClient::GetMaxContextTokens() const
+{
+	if (LODSettings.MaxContextTokens <= 0)
+	{
+		return MaxContextTokens;
+	}
+	return MaxContextTokens > 0 ? FMath::Min(MaxContextTokens, LODSettings.MaxContextTokens) : LODSettings.MaxContextTokens;
+}
+
 void UPlayKitNPCClient::SetCharacterDesign(const FString& Design)
 {
+	// Keep the cached prompt when nothing changed
+	if (CharacterDesign.Equals(Design, ESearchCase::CaseSensitive))
+	{
+		return;
+	}
+
 	CharacterDesign = Design;
+	InvalidateSystemPrompt();
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordCharacterDesign(this, Design);
+	}
 }
 
 //========== Memory System ==========//
 
 void UPlayKitNPCClient::SetMemory(const FString& MemoryName, const FString& MemoryContent)
 {
+	const FString* Existing = Memories.Find(MemoryName);
+	if (Existing ? Existing->Equals(MemoryContent, ESearchCase::CaseSensitive) : MemoryContent.IsEmpty())
+	{
+		return;
+	}
+
 	if (MemoryContent.IsEmpty())
 	{
 		Memories.Remove(MemoryName);
+		MemoryIndex.Remove(MemoryName);
 	}
 	else
 	{
 		Memories.Add(MemoryName, MemoryContent);
+		MemoryIndex.Set(MemoryName, MemoryContent);
+		MemoryIndex.SetPinned(MemoryName, PinnedMemories.Contains(MemoryName));
+	}
+	InvalidateSystemPrompt();
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordMemory(this, MemoryName, MemoryContent);
 	}
 }
 
@@ -114,13 +230,102 @@ TArray<FString> UPlayKitNPCClient::GetMemoryNames() const
 void UPlayKitNPCClient::ClearMemories()
 {
 	Memories.Empty();
+	MemoryIndex.Reset();
+	InvalidateSystemPrompt();
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordClearMemories(this);
+	}
+}
+
+void UPlayKitNPCClient::SetMemoryPinned(const FString& MemoryName, bool bPinned)
+{
+	if (PinnedMemories.Contains(MemoryName) == bPinned)
+	{
+		return;
+	}
+
+	if (bPinned)
+	{
+		PinnedMemories.Add(MemoryName);
+	}
+	else
+	{
+		PinnedMemories.Remove(MemoryName);
+	}
+	MemoryIndex.SetPinned(MemoryName, bPinned);
+	InvalidateSystemPrompt();
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordMemoryPinned(this, MemoryName, bPinned);
+	}
+}
+
+bool UPlayKitNPCClient::IsMemoryPinned(const FString& MemoryName) const
+{
+	return PinnedMemories.Contains(MemoryName);
+}
+
+TArray<FString> UPlayKitNPCClient::GetRelevantMemories(const FString& Text) const
+{
+	TArray<int32> Ids;
+	SelectMemories(Text, Ids);
+
+	TArray<FString> Names;
+	Names.Reserve(Ids.Num());
+	for (const int32 Id : Ids)
+	{
+		Names.Add(MemoryIndex.GetName(Id));
+	}
+	return Names;
+}
+
+bool UPlayKitNPCClient::AllMemoriesFit() const
+{
+	return (MaxPromptMemories <= 0 || MemoryIndex.Num() <= MaxPromptMemories)
+		&& (MemoryTokenBudget <= 0 || MemoryIndex.GetTotalTokens() <= MemoryTokenBudget);
+}
+
+void UPlayKitNPCClient::SelectMemories(FStringView Message, TArray<int32>& OutIds) const
+{
+	if (AllMemoriesFit())
+	{
+		MemoryIndex.GetAll(OutIds);
+		return;
+	}
+
+	// The new message counts most; the last few messages carry what it refers back to
+	FPlayKitMemoryIndex::FQuery Query;
+	Query.AddText(Message, 1.0f);
+	for (int32 Index = FMath::Max(0, ConversationHistory.Num() - MemoryQueryHistoryMessages); Index < ConversationHistory.Num(); ++Index)
+	{
+		Query.AddText(ConversationHistory[Index].GetContent(), 0.5f);
+	}
+
+	MemoryIndex.Select(Query, MaxPromptMemories, MemoryTokenBudget, OutIds);
+}
+
+void UPlayKitNPCClient::OnMemoriesReplaced()
+{
+	MemoryIndex.Reset();
+	for (const TPair<FString, FString>& Memory : Memories)
+	{
+		MemoryIndex.Set(Memory.Key, Memory.Value);
+	}
+	for (const FString& Name : PinnedMemories)
+	{
+		MemoryIndex.SetPinned(Name, true);
+	}
+	InvalidateSystemPrompt();
 }
 
 //========== Conversation ==========//
 
 void UPlayKitNPCClient::Talk(const FString& Message)
 {
-	if (bIsTalking)
+	if (bIsTalking || IsRunningActions())
 	{
 		OnError.Broadcast(TEXT("BUSY"), TEXT("NPC is already processing a message"));
 		return;
@@ -132,14 +337,36 @@ void UPlayKitNPCClient::Talk(const FString& Message)
 		return;
 	}
 
+	// The player is talking to this NPC: promote it to Focus first, so its tier never throttles the reply
+	UPlayKitNPCLODManager* LODManager = UPlayKitNPCLODManager::Get(this);
+	if (LODManager && LODManager->IsEnabled())
+	{
+		LODManager->NotifyInteraction(this);
+	}
+
+	if (!CanSendRequest())
+	{
+		OnError.Broadcast(TEXT("LOD_THROTTLED"), FString::Printf(TEXT("NPC is at LOD tier %s"), *UEnum::GetValueAsString(LODTier)));
+		return;
+	}
+	LastRequestTime = FPlatformTime::Seconds();
+	ActionContinuations = 0;
+
+	// A reply generated ahead of time is delivered as a stream
+	if (TryAdoptSpeculation(Message))
+	{
+		return;
+	}
+
 	PendingUserMessage = Message;
 	bIsTalking = true;
+	bIsStreaming = false;
 	SendChatRequest(false);
 }
 
 void UPlayKitNPCClient::TalkStream(const FString& Message)
 {
-	if (bIsTalking)
+	if (bIsTalking || IsRunningActions())
 	{
 		OnError.Broadcast(TEXT("BUSY"), TEXT("NPC is already processing a message"));
 		return;
@@ -151,15 +378,38 @@ void UPlayKitNPCClient::TalkStream(const FString& Message)
 		return;
 	}
 
+	// The player is talking to this NPC: promote it to Focus first, so its tier never throttles the reply
+	UPlayKitNPCLODManager* LODManager = UPlayKitNPCLODManager::Get(this);
+	if (LODManager && LODManager->IsEnabled())
+	{
+		LODManager->NotifyInteraction(this);
+	}
+
+	if (!CanSendRequest())
+	{
+		OnError.Broadcast(TEXT("LOD_THROTTLED"), FString::Printf(TEXT("NPC is at LOD tier %s"), *UEnum::GetValueAsString(LODTier)));
+		return;
+	}
+	LastRequestTime = FPlatformTime::Seconds();
+	ActionContinuations = 0;
+
+	if (TryAdoptSpeculation(Message))
+	{
+		return;
+	}
+
 	PendingUserMessage = Message;
 	bIsTalking = true;
-	StreamBuffer.Empty();
+	bIsStreaming = true;
+	StreamDecoder.Reset();
+	StreamedContent.Empty();
+	StreamedToolCalls.Reset();
 	SendChatRequest(true);
 }
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitNPCClient::CreateAuthenticatedRequest(const FString& Url)
 {
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = UPlayKitTransport::CreateRequest(this);
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
@@ -173,67 +423,295 @@ TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitNPCClient::CreateAuthentic
 	return Request;
 }
 
-FString UPlayKitNPCClient::BuildSystemPrompt() const
+int32 UPlayKitNPCClient::AppendMemoryLines(TArray<uint8>& Out, TConstArrayView<int32> Ids) const
+{
+	if (Ids.IsEmpty())
+	{
+		return 0;
+	}
+
+	AppendAnsi(Out, MemoriesHeaderJson, UE_ARRAY_COUNT(MemoriesHeaderJson) - 1);
+	int32 Tokens = FPlayKitTokenEstimator::EstimateTokens(MemoriesHeader);
+	for (const int32 Id : Ids)
+	{
+		Out.Append(MemoryIndex.GetPromptLine(Id));
+		Tokens += MemoryIndex.GetTokens(Id);
+	}
+	return Tokens;
+}
+
+void UPlayKitNPCClient::UpdateSystemPromptCache() const
+{
+	if (SystemPromptCache.bValid)
+	{
+		return;
+	}
+
+	// The design message with its content string reopened, so memory lines can follow
+	TArray<uint8>& DesignJson = SystemPromptCache.DesignJson;
+	FPlayKitJsonWriter Json(CharacterDesign.Len() + 64);
+	Json.WriteMessage(TEXT("system"), CharacterDesign);
+	DesignJson = Json.Finish();
+	DesignJson.SetNum(DesignJson.Num() - (UE_ARRAY_COUNT(SystemMessageEnd) - 1), EAllowShrinking::No);
+	SystemPromptCache.DesignTokens = FPlayKitTokenEstimator::EstimateMessageTokens(CharacterDesign);
+
+	SystemPromptCache.MessageJson.Reset();
+	SystemPromptCache.MessageTokens = 0;
+	if (!CharacterDesign.IsEmpty() || MemoryIndex.Num() > 0)
+	{
+		TArray<int32> Ids;
+		MemoryIndex.GetAll(Ids);
+
+		TArray<uint8>& MessageJson = SystemPromptCache.MessageJson;
+		MessageJson = DesignJson;
+		SystemPromptCache.MessageTokens = SystemPromptCache.DesignTokens + AppendMemoryLines(MessageJson, Ids);
+		AppendAnsi(MessageJson, SystemMessageEnd, UE_ARRAY_COUNT(SystemMessageEnd) - 1);
+	}
+
+	SystemPromptCache.bValid = true;
+}
+
+TConstArrayView<uint8> UPlayKitNPCClient::GetSystemMessage(FStringView UserMessage, int32& OutTokens)
+{
+	UpdateSystemPromptCache();
+
+	if (AllMemoriesFit())
+	{
+		OutTokens = SystemPromptCache.MessageTokens;
+		return SystemPromptCache.MessageJson;
+	}
+
+	TArray<int32> Selected;
+	SelectMemories(UserMessage, Selected);
+
+	OutTokens = 0;
+	if (Selected.IsEmpty() && CharacterDesign.IsEmpty())
+	{
+		return TConstArrayView<uint8>();
+	}
+
+	SystemMessageScratch.Reset();
+	SystemMessageScratch.Append(SystemPromptCache.DesignJson);
+	OutTokens = SystemPromptCache.DesignTokens + AppendMemoryLines(SystemMessageScratch, Selected);
+	AppendAnsi(SystemMessageScratch, SystemMessageEnd, UE_ARRAY_COUNT(SystemMessageEnd) - 1);
+	return SystemMessageScratch;
+}
+
+int32 UPlayKitNPCClient::GetContextWindowStart(int32 FirstIndex, int32 ReservedTokens) const
 {
-	FString Prompt = CharacterDesign;
+	const int32 MaxTokens = GetMaxContextTokens();
+	if (MaxTokens <= 0)
+	{
+		return FirstIndex;
+	}
 
-	// Add memories to context
-	if (Memories.Num() > 0)
+	// Walk back one whole turn at a time, so the window never opens on a reply without its question.
+	// Only the kept turns are estimated, so the cost stays flat however long the history gets.
+	int32 UsedTokens = ReservedTokens;
+	int32 TurnsKept = 0;
+	int32 Start = ConversationHistory.Num();
+	int32 TurnTokens = 0;
+
+	for (int32 Index = ConversationHistory.Num() - 1; Index >= FirstIndex; --Index)
 	{
-		Prompt += TEXT("\n\n[Current Memories]\n");
-		for (const auto& Pair : Memories)
+		const FPlayKitNPCMessageView Msg = ConversationHistory[Index];
+		TurnTokens += FPlayKitTokenEstimator::EstimateMessageTokens(Msg.Content);
+
+		if (Msg.Role != ENPCMessageRole::User && Index > FirstIndex)
+		{
+			continue;
+		}
+
+		if (TurnsKept >= MinRecentTurns && UsedTokens + TurnTokens > MaxTokens)
 		{
-			Prompt += FString::Printf(TEXT("- %s: %s\n"), *Pair.Key, *Pair.Value);
+			break;
 		}
+
+		UsedTokens += TurnTokens;
+		TurnTokens = 0;
+		++TurnsKept;
+		Start = Index;
+	}
+
+	if (Start > FirstIndex)
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Context window: sending %d of %d history messages (~%d tokens)"),
+			FirstIndex + ConversationHistory.Num() - Start, ConversationHistory.Num(), UsedTokens);
 	}
 
-	return Prompt;
+	return Start;
 }
 
-void UPlayKitNPCClient::SendChatRequest(bool bStream)
+TArray<uint8> UPlayKitNPCClient::BuildChatBody(const FString& UserMessage, bool bStream, bool bWithPredictions,
+	TConstArrayView<FNPCActionCall> ActionCalls, const TMap<FString, FString>* ActionResults)
 {
-	const FString Url = FString::Printf(TEXT("%s/ai/%s/v2/chat"), *GetBaseUrl(), *GetGameId());
-	CurrentRequest = CreateAuthenticatedRequest(Url);
+	PLAYKIT_SCOPE(STAT_PlayKit_BuildBody, "PlayKit::NPC::BuildBody");
+
+	// Character design and the memories picked for this message
+	int32 SystemMessageTokens = 0;
+	const TConstArrayView<uint8> SystemMessageJson = GetSystemMessage(UserMessage, SystemMessageTokens);
 
-	// Build messages array
-	TArray<TSharedPtr<FJsonValue>> MessagesArray;
+	// Predictions come back as a trailer on the reply; the instruction goes last, after the stable prefix
+	const FString PredictionInstruction = bWithPredictions
+		? FPlayKitPredictionTrailer::BuildInstruction(PredictionCount) : FString();
 
-	// System message
-	FString SystemPrompt = BuildSystemPrompt();
-	if (!SystemPrompt.IsEmpty())
+	// A continuation answers the last reply's tool calls instead of a player message
+	const bool bContinuation = ActionCalls.Num() > 0;
+	int32 ActionResultsSize = 0;
+
+	// Leading system messages (the compaction summary) are always sent
+	int32 PinnedCount = 0;
+	int32 ReservedTokens = SystemMessageTokens;
+	if (bContinuation)
+	{
+		for (const FNPCActionCall& Call : ActionCalls)
+		{
+			const FString* Result = ActionResults ? ActionResults->Find(Call.CallId) : nullptr;
+			ReservedTokens += FPlayKitTokenEstimator::EstimateMessageTokens(Result ? *Result : FString());
+			ActionResultsSize += (Result ? Result->Len() : 0) + Call.CallId.Len() + 128;
+		}
+	}
+	else
 	{
-		TSharedPtr<FJsonObject> SystemMsg = MakeShared<FJsonObject>();
-		SystemMsg->SetStringField(TEXT("role"), TEXT("system"));
-		SystemMsg->SetStringField(TEXT("content"), SystemPrompt);
-		MessagesArray.Add(MakeShared<FJsonValueObject>(SystemMsg));
+		ReservedTokens += FPlayKitTokenEstimator::EstimateMessageTokens(UserMessage);
+	}
+	if (bWithPredictions)
+	{
+		ReservedTokens += FPlayKitTokenEstimator::EstimateMessageTokens(PredictionInstruction);
+	}
+	while (PinnedCount < ConversationHistory.Num() && ConversationHistory.GetRole(PinnedCount) == ENPCMessageRole::System)
+	{
+		ReservedTokens += FPlayKitTokenEstimator::EstimateMessageTokens(ConversationHistory[PinnedCount].Content);
+		++PinnedCount;
 	}
 
-	// History messages
-	for (const FNPCMessage& Msg : ConversationHistory)
+	// Decide which turns fit before anything is written
+	const int32 WindowStart = GetContextWindowStart(PinnedCount, ReservedTokens);
+	const int32 HistoryEnd = ConversationHistory.Num();
+
+	// Pinned messages, then the window
+	const TPair<int32, int32> SentRanges[] = { { 0, PinnedCount }, { WindowStart, HistoryEnd } };
+
+	// Size the buffer once for the whole window
+	int32 BodySizeHint = SystemMessageJson.Num() + UserMessage.Len() + PredictionInstruction.Len() + ActionResultsSize + 256;
+	for (const TPair<int32, int32>& Range : SentRanges)
 	{
-		TSharedPtr<FJsonObject> HistoryMsg = MakeShared<FJsonObject>();
-		HistoryMsg->SetStringField(TEXT("role"), Msg.Role);
-		HistoryMsg->SetStringField(TEXT("content"), Msg.Content);
-		MessagesArray.Add(MakeShared<FJsonValueObject>(HistoryMsg));
+		for (int32 Index = Range.Key; Index < Range.Value; ++Index)
+		{
+			BodySizeHint += ConversationHistory.GetContentSize(Index) + 48;
+		}
 	}
 
-	// Current user message
-	TSharedPtr<FJsonObject> UserMsg = MakeShared<FJsonObject>();
-	UserMsg->SetStringField(TEXT("role"), TEXT("user"));
-	UserMsg->SetStringField(TEXT("content"), PendingUserMessage);
-	MessagesArray.Add(MakeShared<FJsonValueObject>(UserMsg));
+	// Build request body straight into UTF-8
+	FPlayKitJsonWriter Json(BodySizeHint);
+	Json.BeginObject();
+	Json.WriteStringField("model", GetRequestModel());
 
-	// Build request body
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), Model);
-	RequestBody->SetArrayField(TEXT("messages"), MessagesArray);
-	RequestBody->SetNumberField(TEXT("temperature"), Temperature);
-	RequestBody->SetBoolField(TEXT("stream"), bStream);
+	// The reply that made the calls, with the calls, as the model expects before their results
+	auto WriteActionCallsMessage = [&Json, ActionCalls](FUtf8StringView Content)
+	{
+		Json.BeginObject();
+		Json.WriteStringField("role", TEXT("assistant"));
+		Json.WriteStringField("content", Content);
+		Json.WriteKey("tool_calls");
+		Json.BeginArray();
+		for (const FNPCActionCall& Call : ActionCalls)
+		{
+			Json.BeginObject();
+			Json.WriteStringField("id", Call.CallId);
+			Json.WriteStringField("type", TEXT("function"));
+			Json.WriteKey("function");
+			Json.BeginObject();
+			Json.WriteStringField("name", Call.ActionName);
+			// Echoed as the model sent them, so numbers, booleans and nested values keep their types
+			Json.WriteStringField("arguments", Call.ArgumentsJson.IsEmpty() ? FString(TEXT("{}")) : Call.ArgumentsJson);
+			Json.EndObject();
+			Json.EndObject();
+		}
+		Json.EndArray();
+		Json.EndObject();
+	};
 
-	FString JsonString;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
-	CurrentRequest->SetContentAsString(JsonString);
+	Json.WriteKey("messages");
+	Json.BeginArray();
+	if (SystemMessageJson.Num() > 0)
+	{
+		Json.WriteRawValue(reinterpret_cast<const ANSICHAR*>(SystemMessageJson.GetData()), SystemMessageJson.Num());
+	}
+	bool bWroteActionCalls = false;
+	for (const TPair<int32, int32>& Range : SentRanges)
+	{
+		for (int32 Index = Range.Key; Index < Range.Value; ++Index)
+		{
+			const FPlayKitNPCMessageView Msg = ConversationHistory[Index];
+			if (bContinuation && Index == HistoryEnd - 1 && Msg.Role == ENPCMessageRole::Assistant)
+			{
+				WriteActionCallsMessage(Msg.Content);
+				bWroteActionCalls = true;
+				continue;
+			}
+			Json.WriteMessage(FPlayKitNPCHistory::RoleToString(Msg.Role), Msg.Content);
+		}
+	}
+	if (bContinuation)
+	{
+		if (!bWroteActionCalls)
+		{
+			WriteActionCallsMessage(FUtf8StringView());
+		}
+		for (const FNPCActionCall& Call : ActionCalls)
+		{
+			const FString* Result = ActionResults ? ActionResults->Find(Call.CallId) : nullptr;
+			Json.WriteMessage(TEXT("tool"), Result ? FStringView(*Result) : FStringView(), Call.CallId);
+		}
+	}
+	else
+	{
+		Json.WriteMessage(TEXT("user"), UserMessage);
+	}
+	if (bWithPredictions)
+	{
+		Json.WriteMessage(TEXT("system"), PredictionInstruction);
+	}
+	Json.EndArray();
+
+	if (bAutoExecuteActions)
+	{
+		const UPlayKitNPCActionsModule* ActionsModule = GetActionsModule();
+		if (ActionsModule && ActionsModule->HasEnabledActions())
+		{
+			Json.WriteKey("tools");
+			Json.WriteRawValue(ActionsModule->GetToolsJson());
+		}
+	}
+
+	Json.WriteNumberField("temperature", Temperature);
+	if (LODSettings.MaxTokens > 0)
+	{
+		Json.WriteIntField("max_tokens", LODSettings.MaxTokens);
+	}
+	Json.WriteBoolField("stream", bStream);
+	Json.EndObject();
+	return Json.Finish();
+}
+
+void UPlayKitNPCClient::SendChatRequest(bool bStream)
+{
+	const FString Url = FString::Printf(TEXT("%s/ai/%s/v2/chat"), *GetBaseUrl(), *GetGameId());
+	CurrentRequest = CreateAuthenticatedRequest(Url);
+
+	bFusedPredictionsRequested = WantsReplyPredictions() && bFusedReplyPredictions;
+	bTrailerPredictionsBroadcast = false;
+	PredictionTrailer.Reset();
+
+	if (bSendingContinuation)
+	{
+		CurrentRequest->SetContent(BuildChatBody(FString(), bStream, bFusedPredictionsRequested, ActionRound.Calls, &ActionRound.Results));
+	}
+	else
+	{
+		CurrentRequest->SetContent(BuildChatBody(PendingUserMessage, bStream, bFusedPredictionsRequested));
+	}
 
 	if (bStream)
 	{
@@ -244,8 +722,8 @@ void UPlayKitNPCClient::SendChatRequest(bool bStream)
 	CurrentRequest->OnProcessRequestComplete().BindUObject(
 		this, &UPlayKitNPCClient::HandleChatResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[NPCClient] Sending chat request, stream=%s"), bStream ? TEXT("true") : TEXT("false"));
-	CurrentRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Sending chat request, stream=%s"), bStream ? TEXT("true") : TEXT("false"));
+	UPlayKitRequestScheduler::Submit(this, CurrentRequest.ToSharedRef(), EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Chat, GetRequestModel());
 }
 
 void UPlayKitNPCClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived)
@@ -255,49 +733,149 @@ void UPlayKitNPCClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 Byt
 		return;
 	}
 
-	FString Content = Request->GetResponse()->GetContentAsString();
-	if (Content.Len() <= StreamBuffer.Len())
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseStreamChunk, "PlayKit::NPC::StreamChunk");
+
+	// Decode only the bytes that arrived since the last tick
+	TArray<FPlayKitSSEEvent> Events;
+	StreamDecoder.ConsumeResponse(Request->GetResponse()->GetContent(), Events);
+
+	for (const FPlayKitSSEEvent& Event : Events)
+	{
+		ProcessStreamEvent(Event);
+	}
+}
+
+void UPlayKitNPCClient::ProcessStreamEvent(const FPlayKitSSEEvent& Event)
+{
+	if (Event.IsDone())
 	{
 		return;
 	}
 
-	// Get new content
-	FString NewContent = Content.RightChop(StreamBuffer.Len());
-	StreamBuffer = Content;
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Event.Data);
 
-	// Parse SSE format
-	TArray<FString> Lines;
-	NewContent.ParseIntoArray(Lines, TEXT("\n"), true);
+	const FPlayKitJsonView Delta = Root.Find("choices").At(0).Find("delta");
 
-	for (const FString& Line : Lines)
+	FString ChunkContent;
+	if (Delta.Find("content").TryGetString(ChunkContent))
 	{
-		if (Line.StartsWith(TEXT("data: ")))
+		if (StreamedContent.IsEmpty() && !ChunkContent.IsEmpty())
 		{
-			FString Data = Line.RightChop(6);
-			if (Data == TEXT("[DONE]"))
-			{
-				continue;
-			}
+			UPlayKitMetrics::NoteFirstToken(this, CurrentRequest);
+		}
+		StreamedContent += ChunkContent;
 
-			TSharedPtr<FJsonObject> JsonObject;
-			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
-			if (FJsonSerializer::Deserialize(Reader, JsonObject))
-			{
-				const TArray<TSharedPtr<FJsonValue>>* Choices;
-				if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
-				{
-					TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-					const TSharedPtr<FJsonObject>* DeltaPtr;
-					if (Choice->TryGetObjectField(TEXT("delta"), DeltaPtr) && DeltaPtr)
-					{
-						FString ChunkContent;
-						if ((*DeltaPtr)->TryGetStringField(TEXT("content"), ChunkContent))
-						{
-							OnStreamChunk.Broadcast(ChunkContent);
-						}
-					}
-				}
-			}
+		// The predictions trailer is never shown; text that may start it waits for the next chunk
+		const FString ShownContent = bFusedPredictionsRequested ? PredictionTrailer.Append(ChunkContent) : ChunkContent;
+		if (!ShownContent.IsEmpty() || !bFusedPredictionsRequested)
+		{
+			PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
+			OnStreamChunk.Broadcast(ShownContent);
+		}
+
+		if (bFusedPredictionsRequested && PredictionTrailer.IsComplete())
+		{
+			BroadcastTrailerPredictions();
+		}
+	}
+
+	Delta.Find("tool_calls").ForEachElement([this](const FPlayKitJsonView& ToolCallDelta)
+	{
+		AppendStreamedToolCall(ToolCallDelta);
+		return true;
+	});
+}
+
+void UPlayKitNPCClient::AppendStreamedToolCall(const FPlayKitJsonView& ToolCallDelta)
+{
+	if (!ToolCallDelta.IsObject())
+	{
+		return;
+	}
+
+	// The first delta of a call carries its id and name; later ones only argument fragments
+	const FString CallId = ToolCallDelta.Find("id").AsString();
+	int32 Index = ToolCallDelta.Find("index").AsInt(INDEX_NONE);
+	if (Index == INDEX_NONE)
+	{
+		// Without an index, a new id starts the next call
+		const bool bNewCall = StreamedToolCalls.IsEmpty() || (!CallId.IsEmpty() && CallId != StreamedToolCalls.Last().Call.CallId);
+		Index = bNewCall ? StreamedToolCalls.Num() : StreamedToolCalls.Num() - 1;
+	}
+
+	if (Index < 0 || Index > StreamedToolCalls.Num())
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Ignoring streamed tool call with index %d"), Index);
+		return;
+	}
+
+	if (Index == StreamedToolCalls.Num())
+	{
+		// Calls stream one after another, so the ones before are done even if their arguments never closed
+		FireStreamedToolCalls();
+		StreamedToolCalls.AddDefaulted();
+	}
+
+	FStreamedToolCall& ToolCall = StreamedToolCalls[Index];
+	if (ToolCall.bFired)
+	{
+		return;
+	}
+
+	if (!CallId.IsEmpty())
+	{
+		ToolCall.Call.CallId = CallId;
+	}
+
+	const FPlayKitJsonView Function = ToolCallDelta.Find("function");
+	FString Fragment;
+	if (Function.Find("name").TryGetString(Fragment))
+	{
+		ToolCall.Call.ActionName += Fragment;
+	}
+	if (Function.Find("arguments").TryGetString(Fragment) && !Fragment.IsEmpty())
+	{
+		ToolCall.Arguments.Append(Fragment);
+	}
+
+	// Fire the moment the arguments object closes, while the reply may still be streaming
+	if (ToolCall.Arguments.IsComplete() && !ToolCall.Call.ActionName.IsEmpty())
+	{
+		ToolCall.bFired = true;
+		ToolCall.Call.ArgumentsJson = ToolCall.Arguments.GetCompletedJson();
+		ParseActionArguments(ToolCall.Call.ArgumentsJson, ToolCall.Call.Parameters);
+
+		PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
+		if (!StartActionCall(ToolCall.Call))
+		{
+			OnActionTriggered.Broadcast(ToolCall.Call);
+		}
+	}
+}
+
+void UPlayKitNPCClient::FireStreamedToolCalls()
+{
+	for (FStreamedToolCall& ToolCall : StreamedToolCalls)
+	{
+		if (ToolCall.bFired)
+		{
+			continue;
+		}
+
+		// No arguments, or a stream cut short: use what arrived, closed up
+		ToolCall.bFired = true;
+		ToolCall.Call.ArgumentsJson = ToolCall.Arguments.GetRepairedJson();
+		ParseActionArguments(ToolCall.Call.ArgumentsJson, ToolCall.Call.Parameters);
+		if (ToolCall.Call.ActionName.IsEmpty())
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Dropping streamed tool call '%s' without a name"), *ToolCall.Call.CallId);
+			continue;
+		}
+
+		PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
+		if (!StartActionCall(ToolCall.Call))
+		{
+			OnActionTriggered.Broadcast(ToolCall.Call);
 		}
 	}
 }
@@ -305,6 +883,14 @@ void UPlayKitNPCClient::HandleStreamProgress(FHttpRequestPtr Request, uint64 Byt
 void UPlayKitNPCClient::HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
 	bIsTalking = false;
+	const bool bWasStreaming = bIsStreaming;
+	const bool bContinuation = bSendingContinuation;
+	bSendingContinuation = false;
+
+	if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200)
+	{
+		bIsStreaming = false;
+	}
 
 	FNPCResponse NPCResponse;
 
@@ -312,286 +898,625 @@ void UPlayKitNPCClient::HandleChatResponse(FHttpRequestPtr Request, FHttpRespons
 	{
 		NPCResponse.bSuccess = false;
 		NPCResponse.ErrorMessage = TEXT("Network error");
+		ResetActionRound();
 		OnResponse.Broadcast(NPCResponse);
 		OnError.Broadcast(TEXT("NETWORK_ERROR"), TEXT("Failed to get response"));
 		return;
 	}
 
 	const int32 ResponseCode = Response->GetResponseCode();
-	UE_LOG(LogTemp, Log, TEXT("[NPCClient] Chat response: HTTP %d"), ResponseCode);
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Chat response: HTTP %d"), ResponseCode);
 
 	if (ResponseCode != 200)
 	{
 		NPCResponse.bSuccess = false;
 		NPCResponse.ErrorMessage = FString::Printf(TEXT("HTTP %d: %s"), ResponseCode, *Response->GetContentAsString());
+		ResetActionRound();
 		OnResponse.Broadcast(NPCResponse);
 		OnError.Broadcast(TEXT("HTTP_ERROR"), NPCResponse.ErrorMessage);
 		return;
 	}
 
-	// For streaming, extract full content from buffer
-	if (!StreamBuffer.IsEmpty())
+	// For streaming, content was accumulated as events arrived
+	if (bIsStreaming)
 	{
-		// Parse final content from stream
-		FString FullContent;
-		TArray<FString> Lines;
-		StreamBuffer.ParseIntoArray(Lines, TEXT("\n"), true);
-
-		for (const FString& Line : Lines)
+		// Drain bytes that arrived after the last progress tick, plus any unterminated final event
 		{
-			if (Line.StartsWith(TEXT("data: ")))
+			PLAYKIT_SCOPE(STAT_PlayKit_ParseStreamChunk, "PlayKit::NPC::StreamChunk");
+			TArray<FPlayKitSSEEvent> Events;
+			StreamDecoder.ConsumeResponse(Response->GetContent(), Events);
+			StreamDecoder.Finish(Events);
+			for (const FPlayKitSSEEvent& Event : Events)
 			{
-				FString Data = Line.RightChop(6);
-				if (Data == TEXT("[DONE]"))
-				{
-					continue;
-				}
+				ProcessStreamEvent(Event);
+			}
+		}
 
-				TSharedPtr<FJsonObject> JsonObject;
-				TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
-				if (FJsonSerializer::Deserialize(Reader, JsonObject))
-				{
-					const TArray<TSharedPtr<FJsonValue>>* Choices;
-					if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
-					{
-						TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-						const TSharedPtr<FJsonObject>* DeltaPtr;
-						if (Choice->TryGetObjectField(TEXT("delta"), DeltaPtr) && DeltaPtr)
-						{
-							FString ChunkContent;
-							if ((*DeltaPtr)->TryGetStringField(TEXT("content"), ChunkContent))
-							{
-								FullContent += ChunkContent;
-							}
-						}
-					}
-				}
+		UPlayKitMetrics::NoteGeneratedTokens(this, Request, UPlayKitMetrics::EstimateTokenCount(StreamedContent));
+		bIsStreaming = false;
+
+		FString FullContent = MoveTemp(StreamedContent);
+		if (bFusedPredictionsRequested)
+		{
+			const FString HeldBack = PredictionTrailer.Finish();
+			if (!HeldBack.IsEmpty())
+			{
+				OnStreamChunk.Broadcast(HeldBack);
 			}
+			FullContent = PredictionTrailer.GetReply();
 		}
 
 		NPCResponse.bSuccess = true;
 		NPCResponse.Content = FullContent;
 
-		// Add to history
-		ConversationHistory.Add(FNPCMessage(TEXT("user"), PendingUserMessage));
-		ConversationHistory.Add(FNPCMessage(TEXT("assistant"), FullContent));
+		// Actions were fired as their arguments completed; fire any left open, then report them all
+		FireStreamedToolCalls();
+		for (FStreamedToolCall& ToolCall : StreamedToolCalls)
+		{
+			if (!ToolCall.Call.ActionName.IsEmpty())
+			{
+				NPCResponse.ActionCalls.Add(MoveTemp(ToolCall.Call));
+			}
+		}
+		StreamedToolCalls.Reset();
+
+		// Add to history; a continuation's player message is already there
+		if (!bContinuation)
+		{
+			AddToHistory(ENPCMessageRole::User, PendingUserMessage);
+		}
+		AddToHistory(ENPCMessageRole::Assistant, FullContent);
 
+		PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
 		OnStreamComplete.Broadcast(FullContent);
 		OnResponse.Broadcast(NPCResponse);
-		StreamBuffer.Empty();
 	}
 	else
 	{
 		// Parse non-streaming response
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-		if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+		PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::NPC::ParseResponse");
+		const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Response->GetContent());
+		if (!Root.IsObject())
 		{
 			NPCResponse.bSuccess = false;
 			NPCResponse.ErrorMessage = TEXT("Failed to parse response");
+			ResetActionRound();
 			OnResponse.Broadcast(NPCResponse);
 			OnError.Broadcast(TEXT("PARSE_ERROR"), NPCResponse.ErrorMessage);
 			return;
 		}
 
 		// Extract content
-		const TArray<TSharedPtr<FJsonValue>>* Choices;
-		if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
+		const FPlayKitJsonView Message = Root.Find("choices").At(0).Find("message");
+		if (Message.IsObject())
 		{
-			TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-			const TSharedPtr<FJsonObject>* MessagePtr;
-			if (Choice->TryGetObjectField(TEXT("message"), MessagePtr) && MessagePtr)
-			{
-				(*MessagePtr)->TryGetStringField(TEXT("content"), NPCResponse.Content);
+			Message.Find("content").TryGetString(NPCResponse.Content);
 
-				// Check for tool calls / actions
-				const TArray<TSharedPtr<FJsonValue>>* ToolCalls;
-				if ((*MessagePtr)->TryGetArrayField(TEXT("tool_calls"), ToolCalls))
-				{
-					ParseActionCalls(*MessagePtr, NPCResponse.ActionCalls);
-				}
+			const int32 CompletionTokens = Root.Find("usage").Find("completion_tokens").AsInt();
+			UPlayKitMetrics::NoteGeneratedTokens(this, Request, CompletionTokens > 0
+				? CompletionTokens : UPlayKitMetrics::EstimateTokenCount(NPCResponse.Content));
+
+			if (bFusedPredictionsRequested)
+			{
+				PredictionTrailer.Append(NPCResponse.Content);
+				PredictionTrailer.Finish();
+				NPCResponse.Content = PredictionTrailer.GetReply();
 			}
+
+			// Check for tool calls / actions
+			ParseActionCalls(Message, NPCResponse.ActionCalls);
 		}
 
 		NPCResponse.bSuccess = true;
 
-		// Add to history
-		ConversationHistory.Add(FNPCMessage(TEXT("user"), PendingUserMessage));
-		ConversationHistory.Add(FNPCMessage(TEXT("assistant"), NPCResponse.Content));
+		// Add to history; a continuation's player message is already there
+		if (!bContinuation)
+		{
+			AddToHistory(ENPCMessageRole::User, PendingUserMessage);
+		}
+		AddToHistory(ENPCMessageRole::Assistant, NPCResponse.Content);
 
 		// Broadcast action triggers
+		PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
 		for (const FNPCActionCall& ActionCall : NPCResponse.ActionCalls)
 		{
-			OnActionTriggered.Broadcast(ActionCall);
+			if (!StartActionCall(ActionCall))
+			{
+				OnActionTriggered.Broadcast(ActionCall);
+			}
 		}
 
 		OnResponse.Broadcast(NPCResponse);
 	}
 
-	// Auto-generate predictions if enabled
-	if (bAutoGenerateReplyPredictions)
+	// The NPC has yet to react to its actions; predictions wait for the reply that does
+	if (ActionRound.bActive)
+	{
+		FinishActionCalls(bWasStreaming);
+		return;
+	}
+
+	// Auto-generate predictions if enabled, with a second request unless they came with the reply
+	if (WantsReplyPredictions() && !(bFusedPredictionsRequested && BroadcastTrailerPredictions()))
 	{
+		if (bFusedPredictionsRequested)
+		{
+			UE_LOG(LogPlayKit, Log, TEXT("[NPCClient] Reply had no predictions trailer, requesting them separately"));
+		}
 		GenerateReplyPredictions(PredictionCount);
 	}
+	else if (bSpeculativeReplies && bTrailerPredictionsBroadcast)
+	{
+		// Now that the history holds this turn, the speculations can continue from it
+		SpeculateReplies(PredictionTrailer.GetPredictions());
+	}
+}
+
+void UPlayKitNPCClient::ParseActionCalls(const FPlayKitJsonView& Message, TArray<FNPCActionCall>& OutActionCalls)
+{
+	Message.Find("tool_calls").ForEachElement([&OutActionCalls](const FPlayKitJsonView& ToolCall)
+	{
+		if (!ToolCall.IsObject())
+		{
+			return true;
+		}
+
+		FNPCActionCall& ActionCall = OutActionCalls.AddDefaulted_GetRef();
+		ActionCall.CallId = ToolCall.Find("id").AsString();
+
+		const FPlayKitJsonView Function = ToolCall.Find("function");
+		ActionCall.ActionName = Function.Find("name").AsString();
+
+		// Arguments arrive as a JSON document encoded in a string
+		ActionCall.ArgumentsJson = Function.Find("arguments").AsString();
+		ParseActionArguments(ActionCall.ArgumentsJson, ActionCall.Parameters);
+		return true;
+	});
 }
 
-void UPlayKitNPCClient::ParseActionCalls(const TSharedPtr<FJsonObject>& JsonObject, TArray<FNPCActionCall>& OutActionCalls)
+void UPlayKitNPCClient::ParseActionArguments(FStringView ArgumentsJson, TMap<FString, FString>& OutParameters)
 {
-	const TArray<TSharedPtr<FJsonValue>>* ToolCalls;
-	if (!JsonObject->TryGetArrayField(TEXT("tool_calls"), ToolCalls))
+	if (ArgumentsJson.IsEmpty())
 	{
 		return;
 	}
 
-	for (const TSharedPtr<FJsonValue>& ToolCallValue : *ToolCalls)
+	FTCHARToUTF8 ArgumentsUtf8(ArgumentsJson.GetData(), ArgumentsJson.Len());
+	FPlayKitJsonView::Parse(reinterpret_cast<const uint8*>(ArgumentsUtf8.Get()), ArgumentsUtf8.Length())
+		.ForEachMember([&OutParameters](const FString& Key, const FPlayKitJsonView& Value)
+		{
+			OutParameters.Add(Key, Value.ToValueString());
+			return true;
+		});
+}
+
+//========== History Management ==========//
+
+void UPlayKitNPCClient::ClearHistory()
+{
+	ConversationHistory.Empty();
+	++HistoryRevision;
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
 	{
-		TSharedPtr<FJsonObject> ToolCall = ToolCallValue->AsObject();
-		if (!ToolCall.IsValid())
+		Journal->RecordSnapshot(this);
+	}
+}
+
+bool UPlayKitNPCClient::RevertHistory()
+{
+	// Remove last user message and assistant response
+	if (ConversationHistory.Num() >= 2)
+	{
+		ConversationHistory.RemoveLast(2);
+		++HistoryRevision;
+
+		if (UPlayKitNPCJournal* Journal = GetJournal())
 		{
-			continue;
+			Journal->RecordRemoveLast(this, 2);
 		}
+		return true;
+	}
+	return false;
+}
+
+int32 UPlayKitNPCClient::RevertChatMessages(int32 Count)
+{
+	const int32 Removed = FMath::Clamp(Count, 0, ConversationHistory.Num());
+	ConversationHistory.RemoveLast(Removed);
+	if (Removed > 0)
+	{
+		++HistoryRevision;
+
+		if (UPlayKitNPCJournal* Journal = GetJournal())
+		{
+			Journal->RecordRemoveLast(this, Removed);
+		}
+	}
+	return Removed;
+}
+
+void UPlayKitNPCClient::AppendChatMessage(const FString& Role, const FString& Content)
+{
+	if (!FPlayKitNPCHistory::IsKnownRole(Role))
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Unknown message role '%s', storing as 'user'"), *Role);
+	}
+	AddToHistory(FPlayKitNPCHistory::RoleFromString(Role), Content);
+}
+
+TArray<FNPCMessage> UPlayKitNPCClient::GetHistory() const
+{
+	TArray<FNPCMessage> History;
+	History.Reserve(ConversationHistory.Num());
+	for (const FPlayKitNPCMessageView Msg : ConversationHistory)
+	{
+		History.Emplace(FPlayKitNPCHistory::RoleToString(Msg.Role), Msg.GetContent());
+	}
+	return History;
+}
+
+FNPCMessage UPlayKitNPCClient::GetHistoryMessage(int32 Index) const
+{
+	if (Index >= 0 && Index < ConversationHistory.Num())
+	{
+		const FPlayKitNPCMessageView Msg = ConversationHistory[Index];
+		return FNPCMessage(FPlayKitNPCHistory::RoleToString(Msg.Role), Msg.GetContent());
+	}
+	return FNPCMessage();
+}
+
+//========== Compaction ==========//
+
+int32 UPlayKitNPCClient::GetCompactableMessageCount(int32 KeepRecentTurns) const
+{
+	int32 TurnsSeen = 0;
+	for (int32 Index = ConversationHistory.Num() - 1; Index >= 0; --Index)
+	{
+		if (ConversationHistory.GetRole(Index) == ENPCMessageRole::User && ++TurnsSeen == KeepRecentTurns)
+		{
+			return Index;
+		}
+	}
+
+	// Fewer turns than are kept; with nothing to keep, everything may go
+	return KeepRecentTurns <= 0 ? ConversationHistory.Num() : 0;
+}
+
+bool UPlayKitNPCClient::ReplaceWithSummary(int32 Count, uint32 ExpectedRevision, const FString& Summary)
+{
+	if (ExpectedRevision != HistoryRevision || Count <= 0 || Count > ConversationHistory.Num())
+	{
+		return false;
+	}
+
+	// Messages appended since the summary was requested sit after Count and are kept
+	ConversationHistory.ReplaceFirst(Count, ENPCMessageRole::System, Summary);
+	++HistoryRevision;
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordSnapshot(this);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[NPCClient] Replaced %d messages with a summary, %d remain"), Count, ConversationHistory.Num());
+	return true;
+}
+
+FString UPlayKitNPCClient::SaveHistory() const
+{
+	TArray<TSharedPtr<FJsonValue>> HistoryArray;
+
+	for (const FPlayKitNPCMessageView Msg : ConversationHistory)
+	{
+		TSharedPtr<FJsonObject> MsgObj = MakeShared<FJsonObject>();
+		MsgObj->SetStringField(TEXT("role"), FPlayKitNPCHistory::RoleToString(Msg.Role));
+		MsgObj->SetStringField(TEXT("content"), Msg.GetContent());
+		HistoryArray.Add(MakeShared<FJsonValueObject>(MsgObj));
+	}
+
+	TSharedPtr<FJsonObject> SaveObj = MakeShared<FJsonObject>();
+	SaveObj->SetArrayField(TEXT("history"), HistoryArray);
+	SaveObj->SetStringField(TEXT("characterDesign"), CharacterDesign);
+
+	// Save memories
+	TSharedPtr<FJsonObject> MemoriesObj = MakeShared<FJsonObject>();
+	for (const auto& Pair : Memories)
+	{
+		MemoriesObj->SetStringField(Pair.Key, Pair.Value);
+	}
+	SaveObj->SetObjectField(TEXT("memories"), MemoriesObj);
+
+	TArray<TSharedPtr<FJsonValue>> PinnedArray;
+	for (const FString& Name : PinnedMemories)
+	{
+		PinnedArray.Add(MakeShared<FJsonValueString>(Name));
+	}
+	SaveObj->SetArrayField(TEXT("pinnedMemories"), PinnedArray);
+
+	return UPlayKitTool::JsonObjectToString(SaveObj);
+}
+
+bool UPlayKitNPCClient::LoadHistory(const FString& SaveData)
+{
+	TSharedPtr<FJsonObject> SaveObj;
+	if (!UPlayKitTool::StringToJsonObject(SaveData, SaveObj, true))
+	{
+		return false;
+	}
+
+	// Load history
+	ConversationHistory.Empty();
+	++HistoryRevision;
+	const TArray<TSharedPtr<FJsonValue>>* HistoryArray;
+	if (SaveObj->TryGetArrayField(TEXT("history"), HistoryArray))
+	{
+		for (const TSharedPtr<FJsonValue>& MsgValue : *HistoryArray)
+		{
+			TSharedPtr<FJsonObject> MsgObj = MsgValue->AsObject();
+			if (MsgObj.IsValid())
+			{
+				ConversationHistory.Add(
+					FPlayKitNPCHistory::RoleFromString(MsgObj->GetStringField(TEXT("role"))),
+					MsgObj->GetStringField(TEXT("content")));
+			}
+		}
+	}
+
+	// Load character design
+	SaveObj->TryGetStringField(TEXT("characterDesign"), CharacterDesign);
+
+	// Load memories
+	Memories.Empty();
+	const TSharedPtr<FJsonObject>* MemoriesObjPtr;
+	if (SaveObj->TryGetObjectField(TEXT("memories"), MemoriesObjPtr) && MemoriesObjPtr)
+	{
+		for (const auto& Pair : (*MemoriesObjPtr)->Values)
+		{
+			Memories.Add(Pair.Key, Pair.Value->AsString());
+		}
+	}
+
+	PinnedMemories.Empty();
+	const TArray<TSharedPtr<FJsonValue>>* PinnedArray;
+	if (SaveObj->TryGetArrayField(TEXT("pinnedMemories"), PinnedArray))
+	{
+		for (const TSharedPtr<FJsonValue>& NameValue : *PinnedArray)
+		{
+			PinnedMemories.Add(NameValue->AsString());
+		}
+	}
+	OnMemoriesReplaced();
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordSnapshot(this);
+	}
+
+	return true;
+}
+
+TArray<uint8> UPlayKitNPCClient::SaveHistoryBinary(bool bCompress) const
+{
+	const UPlayKitNPCClient* Self = this;
+	return FPlayKitNPCSaveFormat::Save(MakeArrayView(&Self, 1), bCompress);
+}
+
+bool UPlayKitNPCClient::LoadHistoryBinary(const TArray<uint8>& SaveData)
+{
+	if (!FPlayKitNPCSaveFormat::IsBinarySave(SaveData))
+	{
+		// Saves from before the binary format
+		FUTF8ToTCHAR Json(reinterpret_cast<const ANSICHAR*>(SaveData.GetData()), SaveData.Num());
+		return LoadHistory(FString(Json.Length(), Json.Get()));
+	}
+
+	UPlayKitNPCClient* Self = this;
+	if (FPlayKitNPCSaveFormat::Load(SaveData, MakeArrayView(&Self, 1)) != 1)
+	{
+		return false;
+	}
+
+	if (UPlayKitNPCJournal* Journal = GetJournal())
+	{
+		Journal->RecordSnapshot(this);
+	}
+	return true;
+}
 
-		FNPCActionCall ActionCall;
-		ActionCall.CallId = ToolCall->GetStringField(TEXT("id"));
+TArray<uint8> UPlayKitNPCClient::SaveHistories(const TArray<UPlayKitNPCClient*>& NPCs, bool bCompress)
+{
+	return FPlayKitNPCSaveFormat::Save(TConstArrayView<const UPlayKitNPCClient*>(NPCs.GetData(), NPCs.Num()), bCompress);
+}
 
-		const TSharedPtr<FJsonObject>* FunctionPtr;
-		if (ToolCall->TryGetObjectField(TEXT("function"), FunctionPtr) && FunctionPtr)
+int32 UPlayKitNPCClient::LoadHistories(const TArray<UPlayKitNPCClient*>& NPCs, const TArray<uint8>& SaveData)
+{
+	const int32 Loaded = FPlayKitNPCSaveFormat::Load(SaveData, NPCs);
+	if (Loaded > 0)
+	{
+		for (UPlayKitNPCClient* NPC : NPCs)
 		{
-			ActionCall.ActionName = (*FunctionPtr)->GetStringField(TEXT("name"));
-
-			FString ArgumentsStr = (*FunctionPtr)->GetStringField(TEXT("arguments"));
-			TSharedPtr<FJsonObject> Arguments;
-			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ArgumentsStr);
-			if (FJsonSerializer::Deserialize(Reader, Arguments))
+			if (UPlayKitNPCJournal* Journal = NPC ? NPC->GetJournal() : nullptr)
 			{
-				for (const auto& Pair : Arguments->Values)
-				{
-					ActionCall.Parameters.Add(Pair.Key, Pair.Value->AsString());
-				}
+				Journal->RecordSnapshot(NPC);
 			}
 		}
-
-		OutActionCalls.Add(ActionCall);
 	}
+	return Loaded;
 }
 
-//========== History Management ==========//
-
-void UPlayKitNPCClient::ClearHistory()
-{
-	ConversationHistory.Empty();
-}
+//========== Action Results ==========//
 
-bool UPlayKitNPCClient::RevertHistory()
+void UPlayKitNPCClient::ReportActionResult(const FString& CallId, const FString& Result)
 {
-	// Remove last user message and assistant response
-	if (ConversationHistory.Num() >= 2)
+	if (ActionRound.bActive && ActionRound.Calls.ContainsByPredicate([&CallId](const FNPCActionCall& Call) { return Call.CallId == CallId; }))
 	{
-		ConversationHistory.RemoveAt(ConversationHistory.Num() - 1);
-		ConversationHistory.RemoveAt(ConversationHistory.Num() - 1);
-		return true;
+		HandleActionCompleted(CallId, Result);
+		return;
 	}
-	return false;
+	PendingActionResults.Add(CallId, Result);
 }
 
-int32 UPlayKitNPCClient::RevertChatMessages(int32 Count)
+void UPlayKitNPCClient::ReportActionResults(const TMap<FString, FString>& Results)
 {
-	int32 Removed = FMath::Min(Count, ConversationHistory.Num());
-	for (int32 i = 0; i < Removed; i++)
+	for (const auto& Pair : Results)
 	{
-		ConversationHistory.RemoveAt(ConversationHistory.Num() - 1);
+		ReportActionResult(Pair.Key, Pair.Value);
 	}
-	return Removed;
 }
 
-void UPlayKitNPCClient::AppendChatMessage(const FString& Role, const FString& Content)
+//========== Action Loop ==========//
+
+UPlayKitNPCActionsModule* UPlayKitNPCClient::GetActionsModule() const
 {
-	ConversationHistory.Add(FNPCMessage(Role, Content));
+	const AActor* Owner = GetOwner();
+	return Owner ? Owner->FindComponentByClass<UPlayKitNPCActionsModule>() : nullptr;
 }
 
-FString UPlayKitNPCClient::SaveHistory() const
+bool UPlayKitNPCClient::StartActionCall(const FNPCActionCall& Call)
 {
-	TArray<TSharedPtr<FJsonValue>> HistoryArray;
+	if (!bAutoExecuteActions || ActionContinuations >= MaxActionRounds)
+	{
+		return false;
+	}
 
-	for (const FNPCMessage& Msg : ConversationHistory)
+	UPlayKitNPCActionsModule* ActionsModule = GetActionsModule();
+	if (!ActionsModule)
 	{
-		TSharedPtr<FJsonObject> MsgObj = MakeShared<FJsonObject>();
-		MsgObj->SetStringField(TEXT("role"), Msg.Role);
-		MsgObj->SetStringField(TEXT("content"), Msg.Content);
-		HistoryArray.Add(MakeShared<FJsonValueObject>(MsgObj));
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] bAutoExecuteActions is set but %s has no UPlayKitNPCActionsModule"), *GetNameSafe(GetOwner()));
+		return false;
 	}
 
-	TSharedPtr<FJsonObject> SaveObj = MakeShared<FJsonObject>();
-	SaveObj->SetArrayField(TEXT("history"), HistoryArray);
-	SaveObj->SetStringField(TEXT("characterDesign"), CharacterDesign);
+	if (!ActionRound.bActive)
+	{
+		ActionRound.bActive = true;
+		ActionsModule->OnActionCompleted.AddUniqueDynamic(this, &UPlayKitNPCClient::HandleActionCompleted);
+	}
 
-	// Save memories
-	TSharedPtr<FJsonObject> MemoriesObj = MakeShared<FJsonObject>();
-	for (const auto& Pair : Memories)
+	// Results are matched to calls by id, and the continuation needs one for each
+	FNPCActionCall& Added = ActionRound.Calls.Add_GetRef(Call);
+	if (Added.CallId.IsEmpty())
 	{
-		MemoriesObj->SetStringField(Pair.Key, Pair.Value);
+		Added.CallId = FString::Printf(TEXT("call_%d_%d"), ActionContinuations, ActionRound.Calls.Num());
 	}
-	SaveObj->SetObjectField(TEXT("memories"), MemoriesObj);
 
-	return UPlayKitTool::JsonObjectToString(SaveObj);
+	FNPCActionCallArgs Args;
+	Args.ActionName = Added.ActionName;
+	Args.CallId = Added.CallId;
+	Args.RawParameters = Added.Parameters;
+
+	OnActionStarted.Broadcast(Added);
+
+	// Synchronous handlers complete inside StartAction; latent ones run alongside the rest
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Starting action %s (%s)"), *Args.ActionName, *Args.CallId);
+	ActionsModule->StartAction(Args);
+	return true;
 }
 
-bool UPlayKitNPCClient::LoadHistory(const FString& SaveData)
+void UPlayKitNPCClient::FinishActionCalls(bool bStream)
 {
-	TSharedPtr<FJsonObject> SaveObj;
-	if (!UPlayKitTool::StringToJsonObject(SaveData, SaveObj, true))
+	ActionRound.bReplyComplete = true;
+	ActionRound.bStream = bStream;
+
+	UWorld* World = GetWorld();
+	if (World && ActionTimeoutSeconds > 0.0f && ActionRound.Results.Num() < ActionRound.Calls.Num())
 	{
-		return false;
+		World->GetTimerManager().SetTimer(ActionRound.TimeoutHandle, this, &UPlayKitNPCClient::HandleActionTimeout, ActionTimeoutSeconds, false);
 	}
 
-	// Load history
-	ConversationHistory.Empty();
-	const TArray<TSharedPtr<FJsonValue>>* HistoryArray;
-	if (SaveObj->TryGetArrayField(TEXT("history"), HistoryArray))
+	SendActionContinuation();
+}
+
+void UPlayKitNPCClient::HandleActionCompleted(FString CallId, FString Result)
+{
+	if (!ActionRound.bActive || ActionRound.Results.Contains(CallId)
+		|| !ActionRound.Calls.ContainsByPredicate([&CallId](const FNPCActionCall& Call) { return Call.CallId == CallId; }))
 	{
-		for (const TSharedPtr<FJsonValue>& MsgValue : *HistoryArray)
-		{
-			TSharedPtr<FJsonObject> MsgObj = MsgValue->AsObject();
-			if (MsgObj.IsValid())
-			{
-				FNPCMessage Msg;
-				Msg.Role = MsgObj->GetStringField(TEXT("role"));
-				Msg.Content = MsgObj->GetStringField(TEXT("content"));
-				ConversationHistory.Add(Msg);
-			}
-		}
+		return;
 	}
 
-	// Load character design
-	SaveObj->TryGetStringField(TEXT("characterDesign"), CharacterDesign);
+	ActionRound.Results.Add(CallId, Result);
+	SendActionContinuation();
+}
 
-	// Load memories
-	Memories.Empty();
-	const TSharedPtr<FJsonObject>* MemoriesObjPtr;
-	if (SaveObj->TryGetObjectField(TEXT("memories"), MemoriesObjPtr) && MemoriesObjPtr)
+void UPlayKitNPCClient::HandleActionTimeout()
+{
+	for (const FNPCActionCall& Call : ActionRound.Calls)
 	{
-		for (const auto& Pair : (*MemoriesObjPtr)->Values)
+		if (!ActionRound.Results.Contains(Call.CallId))
 		{
-			Memories.Add(Pair.Key, Pair.Value->AsString());
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Action %s (%s) timed out"), *Call.ActionName, *Call.CallId);
+			ActionRound.Results.Add(Call.CallId, TEXT("Error: the action did not finish in time"));
 		}
 	}
+	SendActionContinuation();
+}
 
-	return true;
+void UPlayKitNPCClient::SendActionContinuation()
+{
+	// Waits for the reply to end and for every result, so all of them go in one request
+	if (!ActionRound.bActive || !ActionRound.bReplyComplete || ActionRound.Results.Num() < ActionRound.Calls.Num())
+	{
+		return;
+	}
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Sending %d action results"), ActionRound.Calls.Num());
+
+	++ActionContinuations;
+	bSendingContinuation = true;
+	bIsTalking = true;
+	bIsStreaming = ActionRound.bStream;
+	StreamDecoder.Reset();
+	StreamedContent.Empty();
+	StreamedToolCalls.Reset();
+	SendChatRequest(bIsStreaming);
+
+	// The body holds the calls and results now, so the record goes after the reply that made them
+	RecordActionRound();
+
+	// Calls in the continuation's reply start a new round
+	ResetActionRound();
 }
 
-//========== Action Results ==========//
+namespace
+{
+	const TCHAR ActionRecordHeader[] = TEXT("Actions you took in your previous reply, and their results:");
+}
 
-void UPlayKitNPCClient::ReportActionResult(const FString& CallId, const FString& Result)
+bool UPlayKitNPCClient::IsActionRecord(const FPlayKitNPCMessageView& Message)
 {
-	PendingActionResults.Add(CallId, Result);
+	if (Message.Role != ENPCMessageRole::System)
+	{
+		return false;
+	}
+	const FTCHARToUTF8 Header(ActionRecordHeader);
+	return Message.Content.StartsWith(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Header.Get()), Header.Length()));
 }
 
-void UPlayKitNPCClient::ReportActionResults(const TMap<FString, FString>& Results)
+void UPlayKitNPCClient::RecordActionRound()
 {
-	for (const auto& Pair : Results)
+	// The history has no tool messages, so later turns learn what the NPC did from this note
+	FString Record = ActionRecordHeader;
+	for (const FNPCActionCall& Call : ActionRound.Calls)
+	{
+		const FString* Result = ActionRound.Results.Find(Call.CallId);
+		Record += FString::Printf(TEXT("\n- %s(%s) -> %s"), *Call.ActionName,
+			Call.ArgumentsJson.IsEmpty() ? TEXT("{}") : *Call.ArgumentsJson,
+			(Result && !Result->IsEmpty()) ? **Result : TEXT("done"));
+	}
+	AddToHistory(ENPCMessageRole::System, Record);
+}
+
+void UPlayKitNPCClient::ResetActionRound()
+{
+	if (UWorld* World = GetWorld())
 	{
-		PendingActionResults.Add(Pair.Key, Pair.Value);
+		World->GetTimerManager().ClearTimer(ActionRound.TimeoutHandle);
 	}
+	ActionRound.Calls.Reset();
+	ActionRound.Results.Reset();
+	ActionRound.bActive = false;
+	ActionRound.bReplyComplete = false;
 }
 
 //========== Reply Predictions ==========//
@@ -640,152 +1565,347 @@ void UPlayKitNPCClient::GenerateReplyPredictions(int32 Count)
 		Count, *LastNPCMessage, *RecentHistory, Count
 	);
 
-	// Build messages array - only the prompt, no history needed in messages
-	TArray<TSharedPtr<FJsonValue>> MessagesArray;
-	TSharedPtr<FJsonObject> PredictMsg = MakeShared<FJsonObject>();
-	PredictMsg->SetStringField(TEXT("role"), TEXT("user"));
-	PredictMsg->SetStringField(TEXT("content"), PromptContent);
-	MessagesArray.Add(MakeShared<FJsonValueObject>(PredictMsg));
-
 	// Build request body - USE FAST MODEL
 	UPlayKitSettings* Settings = UPlayKitSettings::Get();
 	FString FastModelName = Settings ? Settings->FastModel : TEXT("gpt-4o-mini");
 
-	TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-	RequestBody->SetStringField(TEXT("model"), FastModelName);
-	RequestBody->SetArrayField(TEXT("messages"), MessagesArray);
-	RequestBody->SetNumberField(TEXT("temperature"), 0.8f);
+	// Only the prompt, no history needed in messages
+	FPlayKitJsonWriter Json(PromptContent.Len() + 128);
+	Json.BeginObject();
+	Json.WriteStringField("model", FastModelName);
+	Json.WriteKey("messages");
+	Json.BeginArray();
+	Json.WriteMessage(TEXT("user"), PromptContent);
+	Json.EndArray();
+	Json.WriteNumberField("temperature", 0.8f);
+	Json.EndObject();
 
-	FString JsonString;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-	FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
-	PredictionsRequest->SetContentAsString(JsonString);
+	PredictionsRequest->SetContent(Json.Finish());
 
 	PredictionsRequest->OnProcessRequestComplete().BindUObject(
 		this, &UPlayKitNPCClient::HandlePredictionsResponse);
 
-	UE_LOG(LogTemp, Log, TEXT("[NPCClient] Generating %d predictions using model: %s"), Count, *FastModelName);
-	PredictionsRequest->ProcessRequest();
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Generating %d predictions using model: %s"), Count, *FastModelName);
+	UPlayKitRequestScheduler::Submit(this, PredictionsRequest.ToSharedRef(), EPlayKitRequestPriority::Prediction, EPlayKitEndpoint::Chat, FastModelName);
 }
 
 void UPlayKitNPCClient::HandlePredictionsResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
 	if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[NPCClient] Failed to generate predictions: HTTP error"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Failed to generate predictions: HTTP error"));
 		OnError.Broadcast(TEXT("PREDICTION_ERROR"), TEXT("Failed to generate predictions"));
 		return;
 	}
 
-	TSharedPtr<FJsonObject> JsonObject;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-	if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+	PLAYKIT_SCOPE(STAT_PlayKit_ParseResponse, "PlayKit::NPC::ParsePredictions");
+
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Response->GetContent());
+	if (!Root.IsObject())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[NPCClient] Failed to parse predictions response JSON"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Failed to parse predictions response JSON"));
 		OnError.Broadcast(TEXT("PARSE_ERROR"), TEXT("Failed to parse predictions response"));
 		return;
 	}
 
 	TArray<FString> Predictions;
 
-	const TArray<TSharedPtr<FJsonValue>>* Choices;
-	if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
+	FString Content;
+	if (Root.Find("choices").At(0).Find("message").Find("content").TryGetString(Content))
 	{
-		TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
-		const TSharedPtr<FJsonObject>* MessagePtr;
-		if (Choice->TryGetObjectField(TEXT("message"), MessagePtr) && MessagePtr)
-		{
-			FString Content;
-			if ((*MessagePtr)->TryGetStringField(TEXT("content"), Content))
-			{
-				// Primary: Try to parse as JSON array
-				Predictions = ParsePredictionsFromJson(Content);
+		// Primary: Try to parse as JSON array
+		Predictions = ParsePredictionsFromJson(Content);
 
-				// Fallback: If JSON parsing failed or returned empty, try text extraction
-				if (Predictions.Num() == 0)
-				{
-					UE_LOG(LogTemp, Log, TEXT("[NPCClient] JSON parsing failed, trying text extraction fallback"));
-					Predictions = ExtractPredictionsFromText(Content, PredictionCount);
-				}
-			}
+		// Fallback: If JSON parsing failed or returned empty, try text extraction
+		if (Predictions.Num() == 0)
+		{
+			UE_LOG(LogPlayKit, Log, TEXT("[NPCClient] JSON parsing failed, trying text extraction fallback"));
+			Predictions = ExtractPredictionsFromText(Content, PredictionCount);
 		}
 	}
 
 	if (Predictions.Num() > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[NPCClient] Generated %d reply predictions"), Predictions.Num());
+		UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Generated %d reply predictions"), Predictions.Num());
+
+		PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
 		OnReplyPredictionsGenerated.Broadcast(Predictions);
+
+		if (bSpeculativeReplies)
+		{
+			SpeculateReplies(Predictions);
+		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[NPCClient] No predictions could be extracted from response"));
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] No predictions could be extracted from response"));
 		OnError.Broadcast(TEXT("PARSE_ERROR"), TEXT("Failed to extract predictions from response"));
 	}
 }
 
-//========== Reply Prediction Helpers ==========//
-
-TArray<FString> UPlayKitNPCClient::ParsePredictionsFromJson(const FString& Response)
+bool UPlayKitNPCClient::BroadcastTrailerPredictions()
 {
-	TArray<FString> Predictions;
-
-	// Find JSON array boundaries
-	int32 StartIndex = Response.Find(TEXT("["));
-	int32 EndIndex = Response.Find(TEXT("]"), ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+	if (bTrailerPredictionsBroadcast)
+	{
+		return true;
+	}
 
-	if (StartIndex == INDEX_NONE || EndIndex == INDEX_NONE || EndIndex <= StartIndex)
+	const TArray<FString> Predictions = PredictionTrailer.GetPredictions();
+	if (Predictions.IsEmpty())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[NPCClient] Could not find JSON array in prediction response"));
-		return Predictions;
+		return false;
 	}
 
-	FString JsonArray = Response.Mid(StartIndex, EndIndex - StartIndex + 1);
+	bTrailerPredictionsBroadcast = true;
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Got %d reply predictions with the reply"), Predictions.Num());
+
+	PLAYKIT_SCOPE(STAT_PlayKit_Broadcast, "PlayKit::NPC::Broadcast");
+	OnReplyPredictionsGenerated.Broadcast(Predictions);
+	return true;
+}
 
-	// Manual JSON array parsing (similar to Unity SDK approach)
-	bool bInString = false;
-	bool bEscaped = false;
-	FString CurrentString;
+//========== Speculation ==========//
+
+uint32 UPlayKitNPCClient::GetSpeculationContextHash() const
+{
+	return HashCombine(ConversationHistory.ComputeHash(), PromptRevision);
+}
 
-	for (int32 i = 1; i < JsonArray.Len() - 1; i++)
+void UPlayKitNPCClient::SpeculateReplies(const TArray<FString>& Messages)
+{
+	if (bIsTalking || !LODSettings.bAllowPredictions || GetAuthToken().IsEmpty())
 	{
-		TCHAR c = JsonArray[i];
+		return;
+	}
 
-		if (bEscaped)
+	// Keep speculations that still match the conversation and are asked for again; cancel the rest
+	const uint32 ContextHash = GetSpeculationContextHash();
+	TArray<FString> Wanted;
+	for (const FString& Message : Messages)
+	{
+		const FString Trimmed = Message.TrimStartAndEnd();
+		if (!Trimmed.IsEmpty())
 		{
-			CurrentString.AppendChar(c);
-			bEscaped = false;
-			continue;
+			Wanted.AddUnique(Trimmed);
 		}
+	}
 
-		if (c == TEXT('\\'))
+	for (int32 Index = Speculations.Num() - 1; Index >= 0; --Index)
+	{
+		FSpeculation& Speculation = Speculations[Index];
+		const bool bWanted = Wanted.ContainsByPredicate([&Speculation](const FString& Message) { return Message.Equals(Speculation.Message, ESearchCase::CaseSensitive); });
+		if (Speculation.ContextHash != ContextHash || !bWanted)
 		{
-			bEscaped = true;
-			continue;
+			CancelSpeculationRequest(Speculation.Request);
+			Speculations.RemoveAt(Index);
 		}
+	}
 
-		if (c == TEXT('"'))
+	const bool bWithPredictions = WantsReplyPredictions() && bFusedReplyPredictions;
+	for (const FString& Message : Wanted)
+	{
+		if (!Speculations.ContainsByPredicate([&Message](const FSpeculation& Speculation) { return Speculation.Message.Equals(Message, ESearchCase::CaseSensitive); }))
 		{
-			if (bInString)
-			{
-				// End of string
-				FString Trimmed = CurrentString.TrimStartAndEnd();
-				if (!Trimmed.IsEmpty())
-				{
-					Predictions.Add(Trimmed);
-				}
-				CurrentString.Empty();
-			}
-			bInString = !bInString;
-			continue;
+			FSpeculation& Speculation = Speculations.AddDefaulted_GetRef();
+			Speculation.Message = Message;
+			Speculation.ContextHash = ContextHash;
+			Speculation.bWithPredictions = bWithPredictions;
 		}
+	}
+
+	StartSpeculations();
+}
+
+void UPlayKitNPCClient::StartSpeculations()
+{
+	int32 Running = 0;
+	for (const FSpeculation& Speculation : Speculations)
+	{
+		Running += Speculation.Request.IsValid() && !Speculation.Response.IsValid() ? 1 : 0;
+	}
+
+	if (Running >= MaxConcurrentSpeculations || bIsTalking)
+	{
+		return;
+	}
 
-		if (bInString)
+	// The body is built from the conversation as it is now, so it must still be the one speculated on
+	const uint32 ContextHash = GetSpeculationContextHash();
+	const FString Url = FString::Printf(TEXT("%s/ai/%s/v2/chat"), *GetBaseUrl(), *GetGameId());
+	for (FSpeculation& Speculation : Speculations)
+	{
+		if (Running >= MaxConcurrentSpeculations)
+		{
+			break;
+		}
+		if (Speculation.Request.IsValid() || Speculation.ContextHash != ContextHash)
 		{
-			CurrentString.AppendChar(c);
+			continue;
 		}
+
+		// Always streamed, so a reply picked while still generating can be taken over mid-stream
+		Speculation.Request = CreateAuthenticatedRequest(Url);
+		Speculation.Request->SetContent(BuildChatBody(Speculation.Message, true, Speculation.bWithPredictions));
+		Speculation.Request->OnProcessRequestComplete().BindUObject(this, &UPlayKitNPCClient::HandleSpeculationResponse);
+
+		UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Speculating reply to \"%s\""), *Speculation.Message);
+		UPlayKitRequestScheduler::Submit(this, Speculation.Request.ToSharedRef(), EPlayKitRequestPriority::Prediction, EPlayKitEndpoint::Chat, GetRequestModel());
+		++Running;
 	}
+}
 
-	return Predictions;
+void UPlayKitNPCClient::HandleSpeculationResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	const int32 Index = Speculations.IndexOfByPredicate([&Request](const FSpeculation& Speculation) { return Speculation.Request == Request; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (bWasSuccessful && Response.IsValid() && Response->GetResponseCode() == 200)
+	{
+		Speculations[Index].Response = Response;
+	}
+	else
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Speculative reply to \"%s\" failed"), *Speculations[Index].Message);
+		Speculations.RemoveAt(Index);
+	}
+
+	StartSpeculations();
+}
+
+bool UPlayKitNPCClient::TryAdoptSpeculation(const FString& Message)
+{
+	if (Speculations.IsEmpty())
+	{
+		return false;
+	}
+
+	// Only a reply generated from this exact conversation can stand in for a fresh one
+	const uint32 ContextHash = GetSpeculationContextHash();
+	const FString Trimmed = Message.TrimStartAndEnd();
+	const int32 Index = Speculations.IndexOfByPredicate([ContextHash, &Trimmed](const FSpeculation& Speculation)
+	{
+		return Speculation.Request.IsValid() && Speculation.ContextHash == ContextHash && Speculation.Message.Equals(Trimmed, ESearchCase::CaseSensitive);
+	});
+
+	FSpeculation Winner;
+	if (Index != INDEX_NONE)
+	{
+		Winner = MoveTemp(Speculations[Index]);
+		Speculations.RemoveAt(Index);
+	}
+	CancelSpeculations();
+
+	// Still queued at Prediction priority: a fresh Interactive request gets there sooner
+	if (!Winner.Request.IsValid() || Winner.Request->GetStatus() == EHttpRequestStatus::NotStarted)
+	{
+		CancelSpeculationRequest(Winner.Request);
+		return false;
+	}
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] Serving speculative reply to \"%s\" (%s)"),
+		*Trimmed, Winner.Response.IsValid() ? TEXT("complete") : TEXT("streaming"));
+
+	PendingUserMessage = Message;
+	bIsTalking = true;
+	bIsStreaming = true;
+	StreamDecoder.Reset();
+	StreamedContent.Empty();
+	StreamedToolCalls.Reset();
+	bFusedPredictionsRequested = Winner.bWithPredictions;
+	bTrailerPredictionsBroadcast = false;
+	PredictionTrailer.Reset();
+	CurrentRequest = Winner.Request;
+
+	if (Winner.Response.IsValid())
+	{
+		// The whole stream is in the response; the reset decoder replays it from the start
+		HandleChatResponse(Winner.Request, Winner.Response, true);
+	}
+	else
+	{
+		// Through the scheduler, so its slot and metrics hooks stay in front of the new handlers
+		UPlayKitRequestScheduler::RebindHandlers(this, CurrentRequest,
+			FHttpRequestCompleteDelegate::CreateUObject(this, &UPlayKitNPCClient::HandleChatResponse),
+			FHttpRequestProgressDelegate64::CreateUObject(this, &UPlayKitNPCClient::HandleStreamProgress));
+
+		// Catch up on what has streamed so far
+		HandleStreamProgress(CurrentRequest, 0, 0);
+	}
+	return true;
+}
+
+void UPlayKitNPCClient::CancelSpeculations()
+{
+	for (FSpeculation& Speculation : Speculations)
+	{
+		CancelSpeculationRequest(Speculation.Request);
+	}
+	Speculations.Reset();
+}
+
+void UPlayKitNPCClient::CancelSpeculationRequest(const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	if (Request.IsValid())
+	{
+		Request->OnRequestProgress64().Unbind();
+		Request->OnProcessRequestComplete().Unbind();
+		UPlayKitRequestScheduler::Cancel(this, Request);
+	}
+}
+
+bool UPlayKitNPCClient::IsReplySpeculated(const FString& Message) const
+{
+	const uint32 ContextHash = GetSpeculationContextHash();
+	const FString Trimmed = Message.TrimStartAndEnd();
+	return Speculations.ContainsByPredicate([ContextHash, &Trimmed](const FSpeculation& Speculation)
+	{
+		return Speculation.ContextHash == ContextHash && Speculation.Message.Equals(Trimmed, ESearchCase::CaseSensitive);
+	});
+}
+
+//========== LOD ==========//
+
+bool UPlayKitNPCClient::CanSendRequest() const
+{
+	return LODSettings.bAllowRequests
+		&& FPlatformTime::Seconds() - LastRequestTime >= LODSettings.MinRequestInterval;
+}
+
+void UPlayKitNPCClient::ApplyLOD(EPlayKitNPCLODTier Tier, const FPlayKitNPCLODSettings& Settings)
+{
+	if (Tier != LODTier)
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[NPCClient] %s: LOD tier %s -> %s"), *GetNameSafe(GetOwner()),
+			*UEnum::GetValueAsString(LODTier), *UEnum::GetValueAsString(Tier));
+	}
+
+	LODTier = Tier;
+	LODSettings = Settings;
+
+	// Speculations already running would be paid for at the old tier
+	if (!Settings.bAllowPredictions && Speculations.Num() > 0)
+	{
+		CancelSpeculations();
+	}
+}
+
+//========== Reply Prediction Helpers ==========//
+
+TArray<FString> UPlayKitNPCClient::ParsePredictionsFromJson(const FString& Response)
+{
+	// Skips any prose or code fence in front of the array, and closes it up if it was cut off
+	FPlayKitPartialJson Parser;
+	Parser.Append(Response);
+	if (!Parser.HasStarted())
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCClient] Could not find JSON array in prediction response"));
+		return TArray<FString>();
+	}
+
+	return FPlayKitPredictionTrailer::ParseArray(Parser.IsComplete() ? Parser.GetCompletedJson() : Parser.GetRepairedJson());
 }
 
 TArray<FString> UPlayKitNPCClient::ExtractPredictionsFromText(const FString& Response, int32 ExpectedCount)
@@ -853,10 +1973,10 @@ FString UPlayKitNPCClient::BuildRecentHistoryString() const
 	// Iterate from end to get most recent messages
 	for (int32 i = ConversationHistory.Num() - 1; i >= 0 && Count < MaxMessages; i--)
 	{
-		const FNPCMessage& Msg = ConversationHistory[i];
-		if (Msg.Role != TEXT("system"))
+		const FPlayKitNPCMessageView Msg = ConversationHistory[i];
+		if (Msg.Role != ENPCMessageRole::System)
 		{
-			RecentMessages.Insert(FString::Printf(TEXT("%s: %s"), *Msg.Role, *Msg.Content), 0);
+			RecentMessages.Insert(FString::Printf(TEXT("%s: %s"), FPlayKitNPCHistory::RoleToString(Msg.Role), *Msg.GetContent()), 0);
 			Count++;
 		}
 	}
@@ -869,10 +1989,41 @@ FString UPlayKitNPCClient::GetLastNPCMessage() const
 	// Find the last assistant message
 	for (int32 i = ConversationHistory.Num() - 1; i >= 0; i--)
 	{
-		if (ConversationHistory[i].Role == TEXT("assistant"))
+		if (ConversationHistory.GetRole(i) == ENPCMessageRole::Assistant)
 		{
-			return ConversationHistory[i].Content;
+			return ConversationHistory[i].GetContent();
 		}
 	}
 	return FString();
 }
+
+//========== Console ==========//
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GPlayKitNPCMemoryCommand(
+	TEXT("playkit.npcmemory"),
+	TEXT("Print the memory held by each NPC's conversation history."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Output)
+		{
+			int32 NPCCount = 0;
+			int64 TotalBytes = 0;
+			for (TObjectIterator<UPlayKitNPCClient> It; It; ++It)
+			{
+				const UPlayKitNPCClient* NPC = *It;
+				if (NPC->IsTemplate() || (World && NPC->GetWorld() != World))
+				{
+					continue;
+				}
+
+				const FPlayKitNPCHistory& History = NPC->GetHistoryView();
+				const int64 Bytes = NPC->GetHistoryMemoryBytes();
+				Output.Logf(TEXT("[NPCClient] %-40s %5d messages %8d content bytes %8lld allocated"),
+					*GetNameSafe(NPC->GetOwner()), History.Num(), History.GetContentBytes(), Bytes);
+
+				++NPCCount;
+				TotalBytes += Bytes;
+			}
+
+			Output.Logf(TEXT("[NPCClient] %d NPCs, %lld bytes of history (%lld per NPC)"),
+				NPCCount, TotalBytes, NPCCount > 0 ? TotalBytes / NPCCount : 0);
+		}));
@@ -5,10 +5,20 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Interfaces/IHttpRequest.h"
+#include "Engine/TimerHandle.h"
+#include "Tool/PlayKitSSEDecoder.h"
+#include "Tool/PlayKitPartialJson.h"
+#include "NPC/PlayKitNPCHistory.h"
+#include "NPC/PlayKitMemoryIndex.h"
+#include "NPC/PlayKitPredictionTrailer.h"
+#include "NPC/PlayKitNPCLOD.h"
 #include "PlayKitNPCClient.generated.h"
 
+class FPlayKitJsonView;
+
 /**
  * NPC Message Structure
+ * Blueprint-facing copy of a history message; the client stores history as FPlayKitNPCHistory.
  */
 USTRUCT(BlueprintType)
 struct FNPCMessage
@@ -41,6 +51,10 @@ struct FNPCActionCall
 
 	UPROPERTY(BlueprintReadOnly)
 	TMap<FString, FString> Parameters;
+
+	/** The arguments exactly as the model sent them, a JSON object */
+	UPROPERTY(BlueprintReadOnly)
+	FString ArgumentsJson;
 };
 
 /**
@@ -96,11 +110,24 @@ class PLAYKITSDK_API UPlayKitNPCClient : public UActorComponent
 {
 	GENERATED_BODY()
 
+	// Benchmarks the private body building and parsing paths
+	friend class FPlayKitBenchmarks;
+
+	// Sends compaction requests with this client's endpoint and credentials
+	friend class UPlayKitAIContextManager;
+
+	// Reads and restores history, character design and memories directly
+	friend class FPlayKitNPCSaveFormat;
+
+	// Replays journal records into the history and memories
+	friend class UPlayKitNPCJournal;
+
 public:
 	UPlayKitNPCClient();
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	//========== Initialization ==========//
@@ -144,6 +171,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Memory")
 	void ClearMemories();
 
+	/**
+	 * Pin a memory so it is in every prompt, however little it has to do with the conversation.
+	 * A name can be pinned before its memory is set; pins survive ClearMemories.
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Memory")
+	void SetMemoryPinned(const FString& MemoryName, bool bPinned);
+
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Memory")
+	bool IsMemoryPinned(const FString& MemoryName) const;
+
+	/**
+	 * Names of the memories a prompt would include for this text: the pinned ones, then the most
+	 * relevant ones within MaxPromptMemories and MemoryTokenBudget
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Memory")
+	TArray<FString> GetRelevantMemories(const FString& Text) const;
+
 	//========== Conversation ==========//
 
 	/** Send a message to the NPC and get a response */
@@ -158,11 +202,68 @@ public:
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC")
 	bool IsTalking() const { return bIsTalking; }
 
+	/** Check if the action loop is running the reply's tool calls (see bAutoExecuteActions) */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Actions")
+	bool IsRunningActions() const { return ActionRound.bActive; }
+
+	//========== Speculation ==========//
+
+	/**
+	 * Start generating the NPC's replies to likely player messages in the background, at
+	 * Prediction priority and at most MaxConcurrentSpeculations at a time. When the player then
+	 * says one of them, Talk or TalkStream serves the finished reply at once, or picks up its
+	 * stream where it is, and cancels the others. Called with the reply predictions when
+	 * bSpeculativeReplies is set.
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Speculation")
+	void SpeculateReplies(const TArray<FString>& Messages);
+
+	/** Cancel every speculative reply */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Speculation")
+	void CancelSpeculations();
+
+	/** True if a speculative reply to this message is ready or generating */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Speculation")
+	bool IsReplySpeculated(const FString& Message) const;
+
+	//========== LOD ==========//
+
+	/** Tier assigned by UPlayKitNPCLODManager */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|LOD")
+	EPlayKitNPCLODTier GetLODTier() const { return LODTier; }
+
+	/** True if the LOD tier allows a request now. Check it before ambient requests; Talk promotes the NPC to Focus first */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|LOD")
+	bool CanSendRequest() const;
+
+	/** Limit requests to what a tier allows. Called by UPlayKitNPCLODManager */
+	void ApplyLOD(EPlayKitNPCLODTier Tier, const FPlayKitNPCLODSettings& Settings);
+
+	/** Lift the tier's limits, back to the NPC's own settings */
+	void ClearLOD() { ApplyLOD(EPlayKitNPCLODTier::Focus, FPlayKitNPCLODSettings()); }
+
 	//========== History Management ==========//
 
-	/** Get the conversation history */
+	/**
+	 * Get a copy of the conversation history.
+	 * Builds a new array of strings on every call; prefer GetHistoryMessage or, from C++, GetHistoryView.
+	 */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|History")
+	TArray<FNPCMessage> GetHistory() const;
+
+	/** Get one message of the conversation history. Returns an empty message if Index is out of range */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|History")
+	FNPCMessage GetHistoryMessage(int32 Index) const;
+
+	/** Read the conversation history in place, without copying */
+	const FPlayKitNPCHistory& GetHistoryView() const { return ConversationHistory; }
+
+	/** True for the system message that records an action round (see bAutoExecuteActions) */
+	static bool IsActionRecord(const FPlayKitNPCMessageView& Message);
+
+	/** Bytes of memory held by the conversation history */
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|History")
-	TArray<FNPCMessage> GetHistory() const { return ConversationHistory; }
+	int64 GetHistoryMemoryBytes() const { return static_cast<int64>(ConversationHistory.GetAllocatedSize()); }
 
 	/** Get the number of messages in history */
 	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|History")
@@ -192,9 +293,50 @@ public:
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|History")
 	bool LoadHistory(const FString& SaveData);
 
+	/**
+	 * Save history, character design and memories in the compact binary format.
+	 * Much smaller and faster than SaveHistory; use SaveHistories for many NPCs at once.
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|History")
+	TArray<uint8> SaveHistoryBinary(bool bCompress = true) const;
+
+	/** Load data from SaveHistoryBinary. JSON saves from SaveHistory are accepted too */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|History")
+	bool LoadHistoryBinary(const TArray<uint8>& SaveData);
+
+	/** Save several NPCs into one blob. Character designs and memories they share are stored once */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|History")
+	static TArray<uint8> SaveHistories(const TArray<UPlayKitNPCClient*>& NPCs, bool bCompress = true);
+
+	/**
+	 * Load a blob from SaveHistories into NPCs, in the order they were saved.
+	 * @return Number of NPCs loaded, or -1 if the data is not a valid save
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|History")
+	static int32 LoadHistories(const TArray<UPlayKitNPCClient*>& NPCs, const TArray<uint8>& SaveData);
+
+	//========== Compaction ==========//
+
+	/**
+	 * Revision of the history, bumped by every change except appending new messages.
+	 * Work done on a copy of the older messages stays valid while the revision is unchanged.
+	 */
+	uint32 GetHistoryRevision() const { return HistoryRevision; }
+
+	/** Number of leading messages that lie before the most recent KeepRecentTurns turns */
+	int32 GetCompactableMessageCount(int32 KeepRecentTurns) const;
+
+	/**
+	 * Replace the first Count messages with a single summary message.
+	 * Leading system messages (such as an earlier summary) are always sent, whatever the context budget.
+	 * @param ExpectedRevision History revision the summary was made from
+	 * @return False, changing nothing, if the history was edited since
+	 */
+	bool ReplaceWithSummary(int32 Count, uint32 ExpectedRevision, const FString& Summary);
+
 	//========== Action Results ==========//
 
-	/** Report the result of an action */
+	/** Report the result of an action. Completes the call if the action loop is running it */
 	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Actions")
 	void ReportActionResult(const FString& CallId, const FString& Result);
 
@@ -223,10 +365,21 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="PlayKit|NPC")
 	FOnNPCStreamComplete OnStreamComplete;
 
-	/** Fired when NPC triggers an action */
+	/**
+	 * Fired when NPC triggers an action for the game to run. In streaming mode, fired as soon as
+	 * the call's arguments are complete, while the rest of the reply is still streaming.
+	 * Calls run by the action loop (bAutoExecuteActions) fire OnActionStarted instead
+	 */
 	UPROPERTY(BlueprintAssignable, Category="PlayKit|NPC")
 	FOnNPCActionTriggered OnActionTriggered;
 
+	/**
+	 * Fired when the action loop starts running a call through the actions module, for
+	 * presentation only: the call is already being executed and must not be executed again
+	 */
+	UPROPERTY(BlueprintAssignable, Category="PlayKit|NPC|Actions")
+	FOnNPCActionTriggered OnActionStarted;
+
 	/** Fired when reply predictions are generated */
 	UPROPERTY(BlueprintAssignable, Category="PlayKit|NPC")
 	FOnReplyPredictionsGenerated OnReplyPredictionsGenerated;
@@ -246,19 +399,133 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Predictions", meta=(ClampMin="2", ClampMax="6"))
 	int32 PredictionCount = 3;
 
+	/**
+	 * With bAutoGenerateReplyPredictions, ask for the predictions at the end of the reply itself
+	 * instead of in a second request. The trailer is stripped before the reply is shown or stored,
+	 * and the predictions are broadcast as soon as they have streamed in. Falls back to a second
+	 * request when the model leaves them out.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Predictions")
+	bool bFusedReplyPredictions = false;
+
 	/** Temperature for response generation */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC", meta=(ClampMin="0.0", ClampMax="2.0"))
 	float Temperature = 0.7f;
 
+	/**
+	 * Token budget for the messages of one request: system prompt, history and the new message.
+	 * Older turns that do not fit are left out of the request (they stay in the history). 0 = no limit.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Context", meta=(ClampMin="0"))
+	int32 MaxContextTokens = 8192;
+
+	/** Most recent turns that are always sent, even over budget. A turn is a player message and the replies to it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Context", meta=(ClampMin="0"))
+	int32 MinRecentTurns = 4;
+
+	//========== Actions ==========//
+
+	/**
+	 * Run the reply's tool calls through the owner's UPlayKitNPCActionsModule as they arrive, every
+	 * one started before any is waited on, then send all the results back in one continuation
+	 * request so the NPC reacts to them without another player message. The module's actions are
+	 * sent as tools with each request. Talk reports BUSY until the continuation is answered.
+	 * Calls the loop runs fire OnActionStarted, not OnActionTriggered, so listeners that execute
+	 * actions from OnActionTriggered do not run them twice. Each round is kept in the history as
+	 * a system message listing the actions, their arguments and results.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Actions")
+	bool bAutoExecuteActions = false;
+
+	/** Continuation requests per player message; tool calls after the last one are only broadcast */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Actions", meta=(ClampMin="1"))
+	int32 MaxActionRounds = 3;
+
+	/** Latent actions that have not completed this long after the reply are reported as timed out. 0 = wait forever */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Actions", meta=(ClampMin="0.0", Units="s"))
+	float ActionTimeoutSeconds = 10.0f;
+
+	//========== Speculation ==========//
+
+	/**
+	 * Generate replies to the reply predictions in the background (see SpeculateReplies), so the
+	 * one the player picks is instant. Costs up to PredictionCount extra requests per turn.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Speculation")
+	bool bSpeculativeReplies = false;
+
+	/** Most speculative replies generating at once; the rest wait for one to finish */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Speculation", meta=(ClampMin="1", ClampMax="6"))
+	int32 MaxConcurrentSpeculations = 2;
+
+	//========== Memory Selection ==========//
+
+	/**
+	 * Most memories sent with a request, besides the pinned ones. When an NPC has more, the ones
+	 * most relevant to the new message and the last few history messages are picked. 0 = no limit.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Memory", meta=(ClampMin="0"))
+	int32 MaxPromptMemories = 12;
+
+	/** Token budget for the memories sent with a request, pinned ones included. 0 = no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Memory", meta=(ClampMin="0"))
+	int32 MemoryTokenBudget = 600;
+
+	//========== Journal ==========//
+
+	/**
+	 * Name of this NPC's crash-safe journal (see UPlayKitNPCJournal). Must be unique per NPC and
+	 * stable across sessions, e.g. a pet's save slot id. Empty disables journaling.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Journal")
+	FString JournalId;
+
+	/** Restore history, character design and memories from the journal in BeginPlay */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Journal")
+	bool bRestoreFromJournal = true;
+
 private:
 	// Internal methods
+	class UPlayKitNPCJournal* GetJournal() const;
+	void AddToHistory(ENPCMessageRole Role, const FString& Content);
+	TArray<uint8> BuildChatBody(const FString& UserMessage, bool bStream, bool bWithPredictions,
+		TConstArrayView<FNPCActionCall> ActionCalls = TConstArrayView<FNPCActionCall>(), const TMap<FString, FString>* ActionResults = nullptr);
 	void SendChatRequest(bool bStream);
 	void HandleChatResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
 	void HandleStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived);
+	void ProcessStreamEvent(const FPlayKitSSEEvent& Event);
+	void AppendStreamedToolCall(const FPlayKitJsonView& ToolCallDelta);
+	void FireStreamedToolCalls();
 	void HandlePredictionsResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
-	FString BuildSystemPrompt() const;
+	bool BroadcastTrailerPredictions();
+	uint32 GetSpeculationContextHash() const;
+	void StartSpeculations();
+	void HandleSpeculationResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	bool TryAdoptSpeculation(const FString& Message);
+	void CancelSpeculationRequest(const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request);
+	void InvalidateSystemPrompt() { SystemPromptCache.bValid = false; ++PromptRevision; }
+	void UpdateSystemPromptCache() const;
+	int32 AppendMemoryLines(TArray<uint8>& Out, TConstArrayView<int32> Ids) const;
+	TConstArrayView<uint8> GetSystemMessage(FStringView UserMessage, int32& OutTokens);
+	bool AllMemoriesFit() const;
+	void SelectMemories(FStringView Message, TArray<int32>& OutIds) const;
+	void OnMemoriesReplaced();
+	int32 GetContextWindowStart(int32 FirstIndex, int32 ReservedTokens) const;
+	FString GetRequestModel() const;
+	int32 GetMaxContextTokens() const;
+	class UPlayKitNPCActionsModule* GetActionsModule() const;
+	bool StartActionCall(const FNPCActionCall& Call);
+	void RecordActionRound();
+	void FinishActionCalls(bool bStream);
+	UFUNCTION()
+	void HandleActionCompleted(FString CallId, FString Result);
+	void HandleActionTimeout();
+	void SendActionContinuation();
+	void ResetActionRound();
+	bool WantsReplyPredictions() const { return bAutoGenerateReplyPredictions && LODSettings.bAllowPredictions; }
 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateAuthenticatedRequest(const FString& Url);
-	void ParseActionCalls(const TSharedPtr<FJsonObject>& JsonObject, TArray<FNPCActionCall>& OutActionCalls);
+	void ParseActionCalls(const FPlayKitJsonView& Message, TArray<FNPCActionCall>& OutActionCalls);
+	static void ParseActionArguments(FStringView ArgumentsJson, TMap<FString, FString>& OutParameters);
 
 	// Reply prediction helpers
 	TArray<FString> ParsePredictionsFromJson(const FString& Response);
@@ -281,13 +548,87 @@ private:
 	// State
 	bool bIsTalking = false;
 	FString PendingUserMessage;
-	FString StreamBuffer;
+
+	// Streaming state
+	bool bIsStreaming = false;
+	FPlayKitSSEDecoder StreamDecoder;
+	FString StreamedContent;
+
+	/** A tool call assembled from stream deltas, fired once its arguments close */
+	struct FStreamedToolCall
+	{
+		FNPCActionCall Call;
+		FPlayKitPartialJson Arguments;
+		bool bFired = false;
+	};
+	TArray<FStreamedToolCall> StreamedToolCalls;
+
+	/** Tool calls of the latest reply, run by the action loop */
+	struct FActionRound
+	{
+		TArray<FNPCActionCall> Calls;
+
+		/** By call id */
+		TMap<FString, FString> Results;
+
+		bool bActive = false;
+
+		/** The reply has finished, so no more calls will arrive */
+		bool bReplyComplete = false;
+
+		bool bStream = false;
+		FTimerHandle TimeoutHandle;
+	};
+	FActionRound ActionRound;
+
+	/** Continuations sent for the current player message */
+	int32 ActionContinuations = 0;
+
+	/** The request in flight sends action results, not a player message */
+	bool bSendingContinuation = false;
+
+	// Predictions fused into the reply
+	bool bFusedPredictionsRequested = false;
+	bool bTrailerPredictionsBroadcast = false;
+	FPlayKitPredictionTrailer PredictionTrailer;
 
 	// Memory
 	TMap<FString, FString> Memories;
+	TSet<FString> PinnedMemories;
+	FPlayKitMemoryIndex MemoryIndex;
+
+	/**
+	 * System prompt parts as escaped UTF-8, rebuilt only after the character design or a memory
+	 * changes. Requests splice them into the body as-is instead of assembling and escaping again.
+	 */
+	struct FSystemPromptCache
+	{
+		/** {"role":"system","content":" and the character design, left open for the memories */
+		TArray<uint8> DesignJson;
+		int32 DesignTokens = 0;
+
+		/** The whole message with every memory, sent while they all fit; empty when the prompt is */
+		TArray<uint8> MessageJson;
+		int32 MessageTokens = 0;
+
+		bool bValid = false;
+	};
+	mutable FSystemPromptCache SystemPromptCache;
+
+	/** Bumped whenever the system prompt changes, so speculations made for the old one are not served */
+	uint32 PromptRevision = 0;
+
+	/** The system message with the selected memories, reused across requests */
+	TArray<uint8> SystemMessageScratch;
+
+	// LOD
+	EPlayKitNPCLODTier LODTier = EPlayKitNPCLODTier::Focus;
+	FPlayKitNPCLODSettings LODSettings;
+	double LastRequestTime = TNumericLimits<double>::Lowest();
 
 	// History
-	TArray<FNPCMessage> ConversationHistory;
+	FPlayKitNPCHistory ConversationHistory;
+	uint32 HistoryRevision = 0;
 
 	// Pending action results
 	TMap<FString, FString> PendingActionResults;
@@ -295,4 +636,19 @@ private:
 	// HTTP
 	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> CurrentRequest;
 	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> PredictionsRequest;
+
+	/** A reply generated ahead of time, valid while the conversation hashes to ContextHash */
+	struct FSpeculation
+	{
+		FString Message;
+		uint32 ContextHash = 0;
+		bool bWithPredictions = false;
+
+		/** Null until a slot frees up */
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+
+		/** Set once the whole reply has arrived */
+		FHttpResponsePtr Response;
+	};
+	TArray<FSpeculation> Speculations;
 };
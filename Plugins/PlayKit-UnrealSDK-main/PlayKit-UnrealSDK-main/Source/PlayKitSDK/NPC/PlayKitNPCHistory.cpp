@@ -0,0 +1,217 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitNPCHistory.h"
+#include "Misc/Crc.h"
+
+//========== Editing ==========//
+
+void FPlayKitNPCHistory::Add(ENPCMessageRole Role, FStringView Content)
+{
+	FTCHARToUTF8 Utf8(Content.GetData(), Content.Len());
+	Add(Role, FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length()));
+}
+
+void FPlayKitNPCHistory::Add(ENPCMessageRole Role, FUtf8StringView Content)
+{
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Offset = Arena.Num();
+	Entry.Length = Content.Len();
+	Entry.Role = Role;
+	Arena.Append(Content.GetData(), Content.Len());
+}
+
+void FPlayKitNPCHistory::RemoveLast(int32 Count)
+{
+	Count = FMath::Min(Count, Entries.Num());
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	const int32 FirstRemoved = Entries.Num() - Count;
+	Arena.SetNum(Entries[FirstRemoved].Offset, EAllowShrinking::No);
+	Entries.SetNum(FirstRemoved, EAllowShrinking::No);
+}
+
+void FPlayKitNPCHistory::ReplaceFirst(int32 Count, ENPCMessageRole Role, FStringView Content)
+{
+	Count = FMath::Clamp(Count, 0, Entries.Num());
+
+	FTCHARToUTF8 Utf8(Content.GetData(), Content.Len());
+	const int32 NewLength = Utf8.Length();
+	const int32 RemovedBytes = Count < Entries.Num() ? Entries[Count].Offset : Arena.Num();
+	const int32 Shift = NewLength - RemovedBytes;
+
+	// Move the kept content into place behind the new message, then write the message
+	const int32 KeptBytes = Arena.Num() - RemovedBytes;
+	if (Shift > 0)
+	{
+		Arena.AddUninitialized(Shift);
+	}
+	FMemory::Memmove(Arena.GetData() + NewLength, Arena.GetData() + RemovedBytes, KeptBytes);
+	if (Shift < 0)
+	{
+		Arena.SetNum(NewLength + KeptBytes, EAllowShrinking::No);
+	}
+	FMemory::Memcpy(Arena.GetData(), Utf8.Get(), NewLength);
+
+	Entries.RemoveAt(0, Count, EAllowShrinking::No);
+	for (FEntry& Entry : Entries)
+	{
+		Entry.Offset += Shift;
+	}
+
+	FEntry First;
+	First.Offset = 0;
+	First.Length = NewLength;
+	First.Role = Role;
+	Entries.Insert(First, 0);
+}
+
+void FPlayKitNPCHistory::Reset()
+{
+	Entries.Reset();
+	Arena.Reset();
+}
+
+void FPlayKitNPCHistory::Empty()
+{
+	Entries.Empty();
+	Arena.Empty();
+}
+
+void FPlayKitNPCHistory::Shrink()
+{
+	Entries.Shrink();
+	Arena.Shrink();
+}
+
+//========== Memory ==========//
+
+uint32 FPlayKitNPCHistory::ComputeHash() const
+{
+	uint32 Crc = 0;
+	for (const FEntry& Entry : Entries)
+	{
+		const uint8 Role = static_cast<uint8>(Entry.Role);
+		Crc = FCrc::MemCrc32(&Role, sizeof(Role), Crc);
+		Crc = FCrc::MemCrc32(&Entry.Length, sizeof(Entry.Length), Crc);
+		Crc = FCrc::MemCrc32(Arena.GetData() + Entry.Offset, Entry.Length, Crc);
+	}
+	return Crc;
+}
+
+//========== Serialization ==========//
+
+void FPlayKitNPCHistory::Save(FArchive& Ar) const
+{
+	check(!Ar.IsLoading());
+
+	uint32 Count = Entries.Num();
+	uint32 ContentBytes = Arena.Num();
+	Ar.SerializeIntPacked(Count);
+	Ar.SerializeIntPacked(ContentBytes);
+
+	for (const FEntry& Entry : Entries)
+	{
+		uint8 Role = static_cast<uint8>(Entry.Role);
+		uint32 Length = Entry.Length;
+		Ar << Role;
+		Ar.SerializeIntPacked(Length);
+	}
+
+	// FArchive only takes mutable buffers; a saving archive does not write to it
+	Ar.Serialize(const_cast<UTF8CHAR*>(Arena.GetData()), Arena.Num());
+}
+
+void FPlayKitNPCHistory::Serialize(FArchive& Ar)
+{
+	if (!Ar.IsLoading())
+	{
+		Save(Ar);
+		return;
+	}
+
+	uint32 Count = 0;
+	uint32 ContentBytes = 0;
+	Ar.SerializeIntPacked(Count);
+	Ar.SerializeIntPacked(ContentBytes);
+
+	// Every entry takes at least two bytes, so larger counts cannot be genuine
+	const int64 Remaining = Ar.TotalSize() - Ar.Tell();
+	if (Ar.IsError() || Count > MAX_int32 || ContentBytes > MAX_int32 || int64(Count) * 2 + ContentBytes > Remaining)
+	{
+		Ar.SetError();
+		Reset();
+		return;
+	}
+	Entries.SetNumUninitialized(Count);
+	Arena.SetNumUninitialized(ContentBytes);
+
+	int64 Offset = 0;
+	for (FEntry& Entry : Entries)
+	{
+		uint8 Role = 0;
+		uint32 Length = 0;
+		Ar << Role;
+		Ar.SerializeIntPacked(Length);
+
+		if (Role > static_cast<uint8>(ENPCMessageRole::Tool) || Offset + Length > ContentBytes)
+		{
+			Ar.SetError();
+			break;
+		}
+		Entry.Role = static_cast<ENPCMessageRole>(Role);
+		Entry.Offset = static_cast<int32>(Offset);
+		Entry.Length = static_cast<int32>(Length);
+		Offset += Length;
+	}
+
+	if (Ar.IsError() || Offset != ContentBytes)
+	{
+		Ar.SetError();
+		Reset();
+		return;
+	}
+
+	Ar.Serialize(Arena.GetData(), Arena.Num());
+}
+
+//========== Roles ==========//
+
+const TCHAR* FPlayKitNPCHistory::RoleToString(ENPCMessageRole Role)
+{
+	switch (Role)
+	{
+	case ENPCMessageRole::System:    return TEXT("system");
+	case ENPCMessageRole::Assistant: return TEXT("assistant");
+	case ENPCMessageRole::Tool:      return TEXT("tool");
+	case ENPCMessageRole::User:
+	default:                         return TEXT("user");
+	}
+}
+
+ENPCMessageRole FPlayKitNPCHistory::RoleFromString(FStringView Role)
+{
+	if (Role.Equals(TEXT("assistant"), ESearchCase::IgnoreCase))
+	{
+		return ENPCMessageRole::Assistant;
+	}
+	if (Role.Equals(TEXT("system"), ESearchCase::IgnoreCase))
+	{
+		return ENPCMessageRole::System;
+	}
+	if (Role.Equals(TEXT("tool"), ESearchCase::IgnoreCase))
+	{
+		return ENPCMessageRole::Tool;
+	}
+	return ENPCMessageRole::User;
+}
+
+bool FPlayKitNPCHistory::IsKnownRole(FStringView Role)
+{
+	return Role.Equals(TEXT("user"), ESearchCase::IgnoreCase)
+		|| Role.Equals(TEXT("assistant"), ESearchCase::IgnoreCase)
+		|| Role.Equals(TEXT("system"), ESearchCase::IgnoreCase)
+		|| Role.Equals(TEXT("tool"), ESearchCase::IgnoreCase);
+}
@@ -0,0 +1,139 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayKitTypes.h"
+
+/**
+ * Read-only view of one message in an FPlayKitNPCHistory.
+ * Points into the history's storage: valid until the history is next modified.
+ */
+struct FPlayKitNPCMessageView
+{
+	ENPCMessageRole Role = ENPCMessageRole::User;
+
+	/** Content as UTF-8 */
+	FUtf8StringView Content;
+
+	/** Content converted to a string. Allocates */
+	FString GetContent() const { return FString(Content); }
+};
+
+/**
+ * Conversation history of one NPC, stored compactly.
+ *
+ * The content of all messages lives back to back as UTF-8 in a single arena,
+ * with a 12-byte entry per message holding its role, offset and length. English
+ * text takes half the memory of UTF-16, there is no per-message allocation, and
+ * request bodies copy the bytes straight into the JSON writer without converting.
+ *
+ * Appending and removing from the end are cheap; replacing leading messages
+ * (compaction) moves the rest of the arena down once.
+ *
+ * Usage:
+ *   for (const FPlayKitNPCMessageView Message : History)
+ *   {
+ *       Json.WriteMessage(FPlayKitNPCHistory::RoleToString(Message.Role), Message.Content);
+ *   }
+ */
+class PLAYKITSDK_API FPlayKitNPCHistory
+{
+public:
+	int32 Num() const { return Entries.Num(); }
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+
+	FPlayKitNPCMessageView operator[](int32 Index) const
+	{
+		const FEntry& Entry = Entries[Index];
+		return { Entry.Role, FUtf8StringView(Arena.GetData() + Entry.Offset, Entry.Length) };
+	}
+
+	ENPCMessageRole GetRole(int32 Index) const { return Entries[Index].Role; }
+
+	/** Size of a message's content in bytes */
+	int32 GetContentSize(int32 Index) const { return Entries[Index].Length; }
+
+	//========== Editing ==========//
+
+	void Add(ENPCMessageRole Role, FStringView Content);
+	void Add(ENPCMessageRole Role, FUtf8StringView Content);
+
+	/** Remove up to Count messages from the end */
+	void RemoveLast(int32 Count);
+
+	/** Replace the first Count messages with a single message */
+	void ReplaceFirst(int32 Count, ENPCMessageRole Role, FStringView Content);
+
+	/** Remove all messages, keeping the memory for reuse */
+	void Reset();
+
+	/** Remove all messages and free the memory */
+	void Empty();
+
+	/** Release slack left by removals */
+	void Shrink();
+
+	//========== Memory ==========//
+
+	/** Bytes allocated for entries and content */
+	SIZE_T GetAllocatedSize() const { return Entries.GetAllocatedSize() + Arena.GetAllocatedSize(); }
+
+	/** Bytes of content, in UTF-8 */
+	int32 GetContentBytes() const { return Arena.Num(); }
+
+	/** CRC-32 of every message's role and content, in order. Equal histories hash equal */
+	uint32 ComputeHash() const;
+
+	//========== Serialization ==========//
+
+	/**
+	 * Save or load the messages: count, then role and length of each (packed), then the content
+	 * as one UTF-8 block. On a malformed archive the history is left empty and Ar is set to error.
+	 */
+	void Serialize(FArchive& Ar);
+
+	/** Save the messages in the Serialize format, without needing a mutable history */
+	void Save(FArchive& Ar) const;
+
+	//========== Roles ==========//
+
+	/** Wire name of a role ("system", "user", "assistant", "tool") */
+	static const TCHAR* RoleToString(ENPCMessageRole Role);
+
+	/** Role for a wire name. Unknown names map to User */
+	static ENPCMessageRole RoleFromString(FStringView Role);
+
+	/** True if Role is one of the wire names */
+	static bool IsKnownRole(FStringView Role);
+
+	//========== Iteration ==========//
+
+	class FIterator
+	{
+	public:
+		FIterator(const FPlayKitNPCHistory& InHistory, int32 InIndex) : History(InHistory), Index(InIndex) {}
+
+		FPlayKitNPCMessageView operator*() const { return History[Index]; }
+		FIterator& operator++() { ++Index; return *this; }
+		bool operator!=(const FIterator& Other) const { return Index != Other.Index; }
+
+	private:
+		const FPlayKitNPCHistory& History;
+		int32 Index;
+	};
+
+	FIterator begin() const { return FIterator(*this, 0); }
+	FIterator end() const { return FIterator(*this, Entries.Num()); }
+
+private:
+	struct FEntry
+	{
+		int32 Offset = 0;
+		int32 Length = 0;
+		ENPCMessageRole Role = ENPCMessageRole::User;
+	};
+
+	TArray<FEntry> Entries;
+	TArray<UTF8CHAR> Arena;
+};
@@ -0,0 +1,678 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitNPCJournal.h"
+#include "PlayKitNPCClient.h"
+#include "PlayKitNPCSaveFormat.h"
+#include "PlayKitLog.h"
+#include "Containers/Queue.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+
+namespace
+{
+	/** Record types; values are stored in journals, never renumber */
+	enum class EJournalRecord : uint8
+	{
+		Message = 1,
+		RemoveLast = 2,
+		Memory = 3,
+		ClearMemories = 4,
+		CharacterDesign = 5,
+		MemoryPinned = 6
+	};
+
+	/** Each record: payload size and CRC-32 of the payload, then the payload (sequence, type, fields) */
+	const int32 FrameHeaderSize = 8;
+
+	/** Snapshots start with the sequence number of the last record they include */
+	const int32 SnapshotHeaderSize = sizeof(uint64);
+
+	FString GetSnapshotPath(const FString& JournalId)
+	{
+		return UPlayKitNPCJournal::GetJournalDir() / FPaths::MakeValidFileName(JournalId) + TEXT(".snapshot");
+	}
+
+	FString GetJournalPath(const FString& JournalId)
+	{
+		return UPlayKitNPCJournal::GetJournalDir() / FPaths::MakeValidFileName(JournalId) + TEXT(".journal");
+	}
+
+	void WriteUtf8(FArchive& Ar, FStringView Value)
+	{
+		FTCHARToUTF8 Utf8(Value.GetData(), Value.Len());
+		uint32 Length = Utf8.Length();
+		Ar.SerializeIntPacked(Length);
+		Ar.Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Length);
+	}
+
+	/** Read a string written by WriteUtf8 as a view into Data, the buffer Ar reads */
+	bool ReadUtf8(FArchive& Ar, const uint8* Data, int64 End, FUtf8StringView& OutValue)
+	{
+		uint32 Length = 0;
+		Ar.SerializeIntPacked(Length);
+		if (Ar.IsError() || Ar.Tell() + Length > End)
+		{
+			return false;
+		}
+		OutValue = FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Data + Ar.Tell()), Length);
+		Ar.Seek(Ar.Tell() + Length);
+		return true;
+	}
+}
+
+/**
+ * Background thread that owns the journal files. The game thread only queues finished records,
+ * and copies of NPC state that are serialized and compressed into snapshots here.
+ * Without multithreading, operations run inline on the calling thread.
+ */
+class FPlayKitNPCJournalWriter final : public FRunnable
+{
+public:
+	enum class EOpType : uint8
+	{
+		Append,
+		Snapshot,
+		Delete,
+		Flush
+	};
+
+	struct FOp
+	{
+		EOpType Type = EOpType::Append;
+		FString JournalId;
+		TArray<uint8> Bytes;
+		FEvent* DoneEvent = nullptr;
+
+		/** Snapshot only: the state to save, and the sequence number of the last record it includes */
+		TUniquePtr<FPlayKitNPCSaveFormat::FNPCState> State;
+		uint64 LastSequence = 0;
+	};
+
+	FPlayKitNPCJournalWriter()
+	{
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		if (FPlatformProcess::SupportsMultithreading())
+		{
+			Thread = FRunnableThread::Create(this, TEXT("PlayKitJournalWriter"), 0, TPri_BelowNormal);
+		}
+	}
+
+	virtual ~FPlayKitNPCJournalWriter() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+			delete Thread;
+			Thread = nullptr;
+		}
+
+		// Anything queued after the thread's last pass
+		Drain();
+		Handles.Empty();
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	}
+
+	void Enqueue(FOp&& Op)
+	{
+		if (!Thread)
+		{
+			Process(Op);
+			FlushHandles();
+			return;
+		}
+
+		Queue.Enqueue(MoveTemp(Op));
+		WorkEvent->Trigger();
+	}
+
+	/** Block until every queued operation is written */
+	void Flush()
+	{
+		if (!Thread)
+		{
+			return;
+		}
+
+		FOp Op;
+		Op.Type = EOpType::Flush;
+		Op.DoneEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		FEvent* DoneEvent = Op.DoneEvent;
+		Enqueue(MoveTemp(Op));
+		DoneEvent->Wait();
+		FPlatformProcess::ReturnSynchEventToPool(DoneEvent);
+	}
+
+	//~ FRunnable
+	virtual uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			WorkEvent->Wait();
+			Drain();
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WorkEvent->Trigger();
+	}
+
+private:
+	void Drain()
+	{
+		FOp Op;
+		while (Queue.Dequeue(Op))
+		{
+			Process(Op);
+		}
+		FlushHandles();
+	}
+
+	void Process(FOp& Op)
+	{
+		switch (Op.Type)
+		{
+		case EOpType::Append:
+			if (IFileHandle* Handle = GetJournalHandle(Op.JournalId))
+			{
+				if (!Handle->Write(Op.Bytes.GetData(), Op.Bytes.Num()))
+				{
+					UE_LOG(LogPlayKit, Warning, TEXT("[NPCJournal] Failed to append to journal '%s'"), *Op.JournalId);
+				}
+			}
+			break;
+
+		case EOpType::Snapshot:
+		{
+			{
+				FMemoryWriter Ar(Op.Bytes);
+				Ar << Op.LastSequence;
+			}
+			const FPlayKitNPCSaveFormat::FNPCState* State = Op.State.Get();
+			Op.Bytes.Append(FPlayKitNPCSaveFormat::Save(MakeArrayView(&State, 1), true));
+			Op.State.Reset();
+
+			// Replace the snapshot atomically, then start the journal over
+			const FString SnapshotPath = GetSnapshotPath(Op.JournalId);
+			const FString TempPath = SnapshotPath + TEXT(".tmp");
+			if (!FFileHelper::SaveArrayToFile(Op.Bytes, *TempPath) || !IFileManager::Get().Move(*SnapshotPath, *TempPath, true, true))
+			{
+				UE_LOG(LogPlayKit, Warning, TEXT("[NPCJournal] Failed to write snapshot '%s'; keeping the journal"), *Op.JournalId);
+				break;
+			}
+			Handles.Remove(Op.JournalId);
+			IFileManager::Get().Delete(*GetJournalPath(Op.JournalId), false, false, true);
+			break;
+		}
+
+		case EOpType::Delete:
+			Handles.Remove(Op.JournalId);
+			IFileManager::Get().Delete(*GetJournalPath(Op.JournalId), false, false, true);
+			IFileManager::Get().Delete(*GetSnapshotPath(Op.JournalId), false, false, true);
+			break;
+
+		case EOpType::Flush:
+			FlushHandles();
+			Op.DoneEvent->Trigger();
+			break;
+		}
+	}
+
+	IFileHandle* GetJournalHandle(const FString& JournalId)
+	{
+		if (TUniquePtr<IFileHandle>* Existing = Handles.Find(JournalId))
+		{
+			return Existing->Get();
+		}
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.CreateDirectoryTree(*UPlayKitNPCJournal::GetJournalDir());
+		IFileHandle* Handle = PlatformFile.OpenWrite(*GetJournalPath(JournalId), true, true);
+		if (!Handle)
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCJournal] Failed to open journal '%s'"), *JournalId);
+			return nullptr;
+		}
+		Handles.Add(JournalId, TUniquePtr<IFileHandle>(Handle));
+		return Handle;
+	}
+
+	void FlushHandles()
+	{
+		for (TPair<FString, TUniquePtr<IFileHandle>>& Pair : Handles)
+		{
+			Pair.Value->Flush();
+		}
+	}
+
+	// Only the game thread enqueues
+	TQueue<FOp, EQueueMode::Spsc> Queue;
+	FEvent* WorkEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping { false };
+
+	// Open journals; touched by the writer thread only (or the game thread once it has stopped)
+	TMap<FString, TUniquePtr<IFileHandle>> Handles;
+};
+
+//========== Lifecycle ==========//
+
+void UPlayKitNPCJournal::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Writer = new FPlayKitNPCJournalWriter();
+	UE_LOG(LogPlayKit, Log, TEXT("[NPCJournal] Initialized"));
+}
+
+void UPlayKitNPCJournal::Deinitialize()
+{
+	// Writes out everything still queued
+	delete Writer;
+	Writer = nullptr;
+	States.Empty();
+
+	Super::Deinitialize();
+}
+
+UPlayKitNPCJournal* UPlayKitNPCJournal::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UGameInstance* GameInstance = Cast<UGameInstance>(WorldContextObject);
+	if (!GameInstance)
+	{
+		if (const UGameInstanceSubsystem* Subsystem = Cast<UGameInstanceSubsystem>(WorldContextObject))
+		{
+			GameInstance = Subsystem->GetGameInstance();
+		}
+		else if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			GameInstance = World->GetGameInstance();
+		}
+	}
+
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitNPCJournal>() : nullptr;
+}
+
+FString UPlayKitNPCJournal::GetJournalDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("PlayKit/Journal");
+}
+
+//========== Restore ==========//
+
+bool UPlayKitNPCJournal::Restore(UPlayKitNPCClient* NPC)
+{
+	if (!NPC || NPC->JournalId.IsEmpty())
+	{
+		return false;
+	}
+
+	// The files must hold everything recorded before they are read
+	Flush();
+
+	const FString& JournalId = NPC->JournalId;
+	bool bRestored = false;
+	uint64 LastSequence = 0;
+
+	TArray<uint8> Snapshot;
+	if (FFileHelper::LoadFileToArray(Snapshot, *GetSnapshotPath(JournalId), FILEREAD_Silent) && Snapshot.Num() > SnapshotHeaderSize)
+	{
+		FLargeMemoryReader Ar(Snapshot.GetData(), Snapshot.Num());
+		Ar << LastSequence;
+
+		UPlayKitNPCClient* Target = NPC;
+		bRestored = FPlayKitNPCSaveFormat::Load(MakeArrayView(Snapshot).RightChop(SnapshotHeaderSize), MakeArrayView(&Target, 1)) == 1;
+		if (!bRestored)
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCJournal] Snapshot of '%s' is unreadable; replaying the journal alone"), *JournalId);
+			LastSequence = 0;
+		}
+	}
+
+	TArray<uint8> Journal;
+	int32 Replayed = 0;
+	uint64 MaxSequence = LastSequence;
+	if (FFileHelper::LoadFileToArray(Journal, *GetJournalPath(JournalId), FILEREAD_Silent))
+	{
+		FLargeMemoryReader Ar(Journal.GetData(), Journal.Num());
+		while (Ar.Tell() + FrameHeaderSize <= Ar.TotalSize())
+		{
+			uint32 Size = 0;
+			uint32 Crc = 0;
+			Ar << Size << Crc;
+
+			const int64 Start = Ar.Tell();
+			const int64 End = Start + Size;
+			if (End > Ar.TotalSize() || FCrc::MemCrc32(Journal.GetData() + Start, Size) != Crc)
+			{
+				// Torn by a crash mid-write; nothing after it was acknowledged
+				UE_LOG(LogPlayKit, Log, TEXT("[NPCJournal] Journal '%s' ends in an incomplete record at byte %lld"), *JournalId, Start - FrameHeaderSize);
+				break;
+			}
+
+			uint64 Sequence = 0;
+			uint8 Type = 0;
+			Ar << Sequence << Type;
+
+			// Already in the snapshot
+			if (Sequence <= LastSequence)
+			{
+				Ar.Seek(End);
+				continue;
+			}
+
+			bool bValid = !Ar.IsError();
+			switch (static_cast<EJournalRecord>(Type))
+			{
+			case EJournalRecord::Message:
+			{
+				uint8 Role = 0;
+				FUtf8StringView Content;
+				Ar << Role;
+				bValid &= Role <= static_cast<uint8>(ENPCMessageRole::Tool) && ReadUtf8(Ar, Journal.GetData(), End, Content);
+				if (bValid)
+				{
+					NPC->ConversationHistory.Add(static_cast<ENPCMessageRole>(Role), Content);
+				}
+				break;
+			}
+
+			case EJournalRecord::RemoveLast:
+			{
+				uint32 Count = 0;
+				Ar.SerializeIntPacked(Count);
+				NPC->ConversationHistory.RemoveLast(static_cast<int32>(FMath::Min<uint32>(Count, MAX_int32)));
+				break;
+			}
+
+			case EJournalRecord::Memory:
+			{
+				FUtf8StringView Name;
+				FUtf8StringView Content;
+				bValid &= ReadUtf8(Ar, Journal.GetData(), End, Name) && ReadUtf8(Ar, Journal.GetData(), End, Content);
+				if (bValid)
+				{
+					if (Content.IsEmpty())
+					{
+						NPC->Memories.Remove(FString(Name));
+					}
+					else
+					{
+						NPC->Memories.Add(FString(Name), FString(Content));
+					}
+				}
+				break;
+			}
+
+			case EJournalRecord::ClearMemories:
+				NPC->Memories.Empty();
+				break;
+
+			case EJournalRecord::CharacterDesign:
+			{
+				FUtf8StringView Design;
+				bValid &= ReadUtf8(Ar, Journal.GetData(), End, Design);
+				if (bValid)
+				{
+					NPC->CharacterDesign = FString(Design);
+				}
+				break;
+			}
+
+			case EJournalRecord::MemoryPinned:
+			{
+				FUtf8StringView Name;
+				uint8 bPinned = 0;
+				bValid &= ReadUtf8(Ar, Journal.GetData(), End, Name);
+				Ar << bPinned;
+				if (bValid)
+				{
+					if (bPinned)
+					{
+						NPC->PinnedMemories.Add(FString(Name));
+					}
+					else
+					{
+						NPC->PinnedMemories.Remove(FString(Name));
+					}
+				}
+				break;
+			}
+
+			default:
+				bValid = false;
+				break;
+			}
+
+			if (!bValid || Ar.IsError())
+			{
+				UE_LOG(LogPlayKit, Warning, TEXT("[NPCJournal] Journal '%s' has an invalid record at byte %lld; stopping there"), *JournalId, Start - FrameHeaderSize);
+				break;
+			}
+
+			Ar.Seek(End);
+			MaxSequence = FMath::Max(MaxSequence, Sequence);
+			++Replayed;
+		}
+	}
+
+	if (Replayed > 0)
+	{
+		++NPC->HistoryRevision;
+		NPC->OnMemoriesReplaced();
+		bRestored = true;
+	}
+
+	FJournalState& State = States.FindOrAdd(JournalId);
+	State = FJournalState();
+	State.NextSequence = MaxSequence + 1;
+
+	// Fold the replayed records (and any torn tail) into a fresh snapshot
+	if (Journal.Num() > 0)
+	{
+		QueueSnapshot(NPC, State);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[NPCJournal] Restored '%s': snapshot %s, %d journal records, %d messages"),
+		*JournalId, Snapshot.Num() > 0 ? TEXT("loaded") : TEXT("missing"), Replayed, NPC->ConversationHistory.Num());
+	return bRestored;
+}
+
+void UPlayKitNPCJournal::Delete(const FString& JournalId)
+{
+	if (JournalId.IsEmpty() || !Writer)
+	{
+		return;
+	}
+
+	States.Remove(JournalId);
+
+	FPlayKitNPCJournalWriter::FOp Op;
+	Op.Type = FPlayKitNPCJournalWriter::EOpType::Delete;
+	Op.JournalId = JournalId;
+	Writer->Enqueue(MoveTemp(Op));
+}
+
+void UPlayKitNPCJournal::Flush()
+{
+	if (Writer)
+	{
+		Writer->Flush();
+	}
+}
+
+//========== Recording ==========//
+
+void UPlayKitNPCJournal::RecordMessage(UPlayKitNPCClient* NPC, ENPCMessageRole Role, FStringView Content)
+{
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::Message);
+		uint8 RoleValue = static_cast<uint8>(Role);
+		Ar << Type << RoleValue;
+		WriteUtf8(Ar, Content);
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordRemoveLast(UPlayKitNPCClient* NPC, int32 Count)
+{
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::RemoveLast);
+		uint32 PackedCount = Count;
+		Ar << Type;
+		Ar.SerializeIntPacked(PackedCount);
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordMemory(UPlayKitNPCClient* NPC, const FString& MemoryName, const FString& MemoryContent)
+{
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::Memory);
+		Ar << Type;
+		WriteUtf8(Ar, MemoryName);
+		WriteUtf8(Ar, MemoryContent);
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordClearMemories(UPlayKitNPCClient* NPC)
+{
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::ClearMemories);
+		Ar << Type;
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordMemoryPinned(UPlayKitNPCClient* NPC, const FString& MemoryName, bool bPinned)
+{
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::MemoryPinned);
+		uint8 PinnedByte = bPinned ? 1 : 0;
+		Ar << Type;
+		WriteUtf8(Ar, MemoryName);
+		Ar << PinnedByte;
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordCharacterDesign(UPlayKitNPCClient* NPC, const FString& Design)
+{
+	if (FJournalState* State = BeginRecord(NPC))
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Ar(Payload);
+		uint8 Type = static_cast<uint8>(EJournalRecord::CharacterDesign);
+		Ar << Type;
+		WriteUtf8(Ar, Design);
+		QueueRecord(NPC, *State, MoveTemp(Payload));
+	}
+}
+
+void UPlayKitNPCJournal::RecordSnapshot(UPlayKitNPCClient* NPC)
+{
+	if (!NPC || NPC->JournalId.IsEmpty() || !Writer)
+	{
+		return;
+	}
+
+	QueueSnapshot(NPC, States.FindOrAdd(NPC->JournalId));
+}
+
+UPlayKitNPCJournal::FJournalState* UPlayKitNPCJournal::BeginRecord(UPlayKitNPCClient* NPC)
+{
+	if (!NPC || NPC->JournalId.IsEmpty() || !Writer)
+	{
+		return nullptr;
+	}
+
+	if (FJournalState* State = States.Find(NPC->JournalId))
+	{
+		return State;
+	}
+
+	// Files left by an earlier session that were never restored describe a different state
+	QueueSnapshot(NPC, States.Add(NPC->JournalId));
+	return nullptr;
+}
+
+void UPlayKitNPCJournal::QueueRecord(UPlayKitNPCClient* NPC, FJournalState& State, TArray<uint8>&& Payload)
+{
+	uint64 Sequence = State.NextSequence++;
+
+	FPlayKitNPCJournalWriter::FOp Op;
+	Op.JournalId = NPC->JournalId;
+	Op.Bytes.Reserve(FrameHeaderSize + sizeof(Sequence) + Payload.Num());
+	{
+		FMemoryWriter Ar(Op.Bytes);
+		uint32 Size = sizeof(Sequence) + Payload.Num();
+		uint32 Crc = 0;
+		Ar << Size << Crc << Sequence;
+		Ar.Serialize(Payload.GetData(), Payload.Num());
+	}
+
+	const uint32 Crc = FCrc::MemCrc32(Op.Bytes.GetData() + FrameHeaderSize, Op.Bytes.Num() - FrameHeaderSize);
+	FMemory::Memcpy(Op.Bytes.GetData() + sizeof(uint32), &Crc, sizeof(Crc));
+
+	++State.RecordsSinceSnapshot;
+	State.BytesSinceSnapshot += Op.Bytes.Num();
+	Writer->Enqueue(MoveTemp(Op));
+
+	if (State.RecordsSinceSnapshot >= CompactAfterRecords || State.BytesSinceSnapshot >= CompactAfterBytes)
+	{
+		QueueSnapshot(NPC, State);
+	}
+}
+
+void UPlayKitNPCJournal::QueueSnapshot(UPlayKitNPCClient* NPC, FJournalState& State)
+{
+	FPlayKitNPCJournalWriter::FOp Op;
+	Op.Type = FPlayKitNPCJournalWriter::EOpType::Snapshot;
+	Op.JournalId = NPC->JournalId;
+
+	// Only the copy happens here; the writer serializes and compresses it.
+	// The snapshot includes every record handed out so far
+	Op.State = MakeUnique<FPlayKitNPCSaveFormat::FNPCState>(FPlayKitNPCSaveFormat::Capture(*NPC));
+	Op.LastSequence = State.NextSequence - 1;
+
+	State.RecordsSinceSnapshot = 0;
+	State.BytesSinceSnapshot = 0;
+	Writer->Enqueue(MoveTemp(Op));
+}
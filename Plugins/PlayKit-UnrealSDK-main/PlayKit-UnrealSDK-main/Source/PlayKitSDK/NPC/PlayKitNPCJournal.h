@@ -0,0 +1,110 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "PlayKitTypes.h"
+#include "PlayKitNPCJournal.generated.h"
+
+class UPlayKitNPCClient;
+class FPlayKitNPCJournalWriter;
+
+/**
+ * PlayKit NPC Journal
+ * Crash-safe persistence of NPC conversations without game-thread file IO.
+ *
+ * Every NPC with a JournalId records each change (a message, a revert, a memory, pin or
+ * character design change) as a small checksummed record. Records are handed to a background writer
+ * thread, which appends them to Saved/PlayKit/Journal/<JournalId>.journal and flushes after
+ * each batch. Changes that rewrite history (clear, load, summary) and every CompactAfterRecords
+ * records write a snapshot in the binary save format instead, which resets the journal.
+ *
+ * On restore, the snapshot is loaded and the journal records after it are replayed. A record
+ * torn by a crash mid-write fails its checksum and ends the replay there.
+ *
+ * Records carry sequence numbers and snapshots the last one they include, so a crash between
+ * writing a snapshot and resetting the journal never replays a record twice.
+ */
+UCLASS()
+class PLAYKITSDK_API UPlayKitNPCJournal : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|NPC|Journal", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitNPCJournal* Get(const UObject* WorldContextObject);
+
+	/** Write a snapshot once a journal holds this many records */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Journal", meta=(ClampMin="1"))
+	int32 CompactAfterRecords = 256;
+
+	/** Write a snapshot once a journal holds this many bytes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|NPC|Journal", meta=(ClampMin="1024"))
+	int64 CompactAfterBytes = 1024 * 1024;
+
+	//========== Restore ==========//
+
+	/**
+	 * Rebuild an NPC's history, character design and memories from its snapshot and journal.
+	 * Reads the files on the calling thread; call while loading.
+	 * @return True if anything was restored
+	 */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Journal")
+	bool Restore(UPlayKitNPCClient* NPC);
+
+	/** Delete an NPC's snapshot and journal */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Journal")
+	void Delete(const FString& JournalId);
+
+	/** Block until everything recorded so far is on disk */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|NPC|Journal")
+	void Flush();
+
+	//========== Recording ==========//
+	// Called by UPlayKitNPCClient after each change; no-ops for NPCs without a JournalId
+
+	void RecordMessage(UPlayKitNPCClient* NPC, ENPCMessageRole Role, FStringView Content);
+	void RecordRemoveLast(UPlayKitNPCClient* NPC, int32 Count);
+	void RecordMemory(UPlayKitNPCClient* NPC, const FString& MemoryName, const FString& MemoryContent);
+	void RecordClearMemories(UPlayKitNPCClient* NPC);
+	void RecordMemoryPinned(UPlayKitNPCClient* NPC, const FString& MemoryName, bool bPinned);
+	void RecordCharacterDesign(UPlayKitNPCClient* NPC, const FString& Design);
+
+	/** Replace the journal with a snapshot of the NPC's whole state */
+	void RecordSnapshot(UPlayKitNPCClient* NPC);
+
+	/** Directory holding the snapshot and journal files */
+	static FString GetJournalDir();
+
+private:
+	struct FJournalState
+	{
+		uint64 NextSequence = 1;
+		int32 RecordsSinceSnapshot = 0;
+		int64 BytesSinceSnapshot = 0;
+	};
+
+	/**
+	 * State of the NPC's journal for recording a change that has already been applied.
+	 * Null if the NPC has no JournalId, or if this is the journal's first change this session:
+	 * then a snapshot of the current state, which includes the change, starts the journal.
+	 */
+	FJournalState* BeginRecord(UPlayKitNPCClient* NPC);
+
+	/** Frame a record and queue it; may follow it with a snapshot */
+	void QueueRecord(UPlayKitNPCClient* NPC, FJournalState& State, TArray<uint8>&& Payload);
+
+	/** Copy the NPC's state and queue it; the writer thread serializes and compresses it */
+	void QueueSnapshot(UPlayKitNPCClient* NPC, FJournalState& State);
+
+	/** Journal state per JournalId */
+	TMap<FString, FJournalState> States;
+
+	/** Owns the writer thread. Created in Initialize, deleted in Deinitialize after draining */
+	FPlayKitNPCJournalWriter* Writer = nullptr;
+};
@@ -0,0 +1,56 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayKitNPCLOD.generated.h"
+
+/**
+ * How much an NPC's conversation is worth to the player right now, most first.
+ * Assigned by UPlayKitNPCLODManager; an NPC no manager has seen stays at Focus.
+ */
+UENUM(BlueprintType)
+enum class EPlayKitNPCLODTier : uint8
+{
+	/** The player is talking to it */
+	Focus,
+	/** Close by and on screen */
+	Near,
+	/** In earshot, or close but off screen */
+	Far,
+	/** Out of range; sends nothing */
+	Dormant
+};
+
+/**
+ * What an NPC may spend on requests at one LOD tier
+ */
+USTRUCT(BlueprintType)
+struct PLAYKITSDK_API FPlayKitNPCLODSettings
+{
+	GENERATED_BODY()
+
+	/** Send requests at all. Talk promotes the NPC to Focus first, so this limits everything else */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD")
+	bool bAllowRequests = true;
+
+	/** Use UPlayKitSettings::FastModel instead of the NPC's own model */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD")
+	bool bUseFastModel = false;
+
+	/** Length limit for a reply (max_tokens). 0 = the model's default */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0"))
+	int32 MaxTokens = 0;
+
+	/** Token budget for the messages of a request, if lower than the NPC's MaxContextTokens. 0 = the NPC's own */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0"))
+	int32 MaxContextTokens = 0;
+
+	/** Shortest time between two requests. CanSendRequest is false before it has passed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD", meta=(ClampMin="0.0", Units="s"))
+	float MinRequestInterval = 0.0f;
+
+	/** Allow reply predictions and speculative replies */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit|LOD")
+	bool bAllowPredictions = true;
+};
@@ -0,0 +1,476 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitNPCSaveFormat.h"
+#include "PlayKitNPCClient.h"
+#include "PlayKitLog.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	const uint32 SaveMagic = 0x484E4B50; // "PKNH" in a little-endian dump
+
+	enum class ESaveCompression : uint8
+	{
+		None = 0,
+		Zlib = 1,
+		Oodle = 2
+	};
+
+	FName GetCompressionFormat(ESaveCompression Compression)
+	{
+		switch (Compression)
+		{
+		case ESaveCompression::Zlib:  return NAME_Zlib;
+		case ESaveCompression::Oodle: return NAME_Oodle;
+		default:                      return NAME_None;
+		}
+	}
+
+	/** Fixed-size header in front of the payload */
+	struct FSaveHeader
+	{
+		uint32 Magic = SaveMagic;
+		uint16 Version = static_cast<uint16>(FPlayKitNPCSaveFormat::EVersion::Latest);
+		uint8 Compression = static_cast<uint8>(ESaveCompression::None);
+		uint8 Reserved = 0;
+		int32 PayloadSize = 0;
+		int32 StoredSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FSaveHeader& Header)
+		{
+			return Ar << Header.Magic << Header.Version << Header.Compression << Header.Reserved << Header.PayloadSize << Header.StoredSize;
+		}
+	};
+
+	const int32 HeaderSize = 16;
+
+	/** Largest payload Load will allocate for; the header's size is checked against it before decompressing */
+	const int32 MaxPayloadSize = 256 * 1024 * 1024;
+
+	void WriteUtf8(FArchive& Ar, const FString& Value)
+	{
+		FTCHARToUTF8 Utf8(*Value, Value.Len());
+		uint32 Length = Utf8.Length();
+		Ar.SerializeIntPacked(Length);
+		Ar.Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Length);
+	}
+
+	bool ReadUtf8(FArchive& Ar, FString& OutValue)
+	{
+		uint32 Length = 0;
+		Ar.SerializeIntPacked(Length);
+		if (Ar.IsError() || int64(Length) > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			return false;
+		}
+
+		TArray<UTF8CHAR, TInlineAllocator<256>> Bytes;
+		Bytes.SetNumUninitialized(Length);
+		Ar.Serialize(Bytes.GetData(), Length);
+		OutValue = FString(FUtf8StringView(Bytes.GetData(), Length));
+		return !Ar.IsError();
+	}
+
+	/** Collects each distinct string once and hands out its index */
+	class FStringTableWriter
+	{
+	public:
+		uint32 Add(const FString& Value)
+		{
+			if (const uint32* Existing = Indices.Find(Value))
+			{
+				return *Existing;
+			}
+			const uint32 Index = Strings.Num();
+			Strings.Add(&Value);
+			Indices.Add(Value, Index);
+			return Index;
+		}
+
+		void Write(FArchive& Ar) const
+		{
+			uint32 Count = Strings.Num();
+			Ar.SerializeIntPacked(Count);
+			for (const FString* Value : Strings)
+			{
+				WriteUtf8(Ar, *Value);
+			}
+		}
+
+	private:
+		// Point at the NPCs' own strings, which outlive the save
+		TArray<const FString*> Strings;
+		TMap<FString, uint32> Indices;
+	};
+
+	/** One NPC's state, parsed in full before anything is applied */
+	struct FSaveRecord
+	{
+		bool bPresent = false;
+		FString CharacterDesign;
+		TMap<FString, FString> Memories;
+		TSet<FString> PinnedMemories;
+		FPlayKitNPCHistory History;
+	};
+
+	/** Write one NPC's record; the strings are added to StringTable and must outlive it */
+	void WriteRecord(FArchive& Ar, FStringTableWriter& StringTable, const FString& CharacterDesign,
+		const TMap<FString, FString>& Memories, const TSet<FString>& PinnedMemories, const FPlayKitNPCHistory& History)
+	{
+		uint32 DesignIndex = StringTable.Add(CharacterDesign);
+		Ar.SerializeIntPacked(DesignIndex);
+
+		uint32 MemoryCount = Memories.Num();
+		Ar.SerializeIntPacked(MemoryCount);
+		for (const TPair<FString, FString>& Memory : Memories)
+		{
+			uint32 NameIndex = StringTable.Add(Memory.Key);
+			uint32 ValueIndex = StringTable.Add(Memory.Value);
+			Ar.SerializeIntPacked(NameIndex);
+			Ar.SerializeIntPacked(ValueIndex);
+		}
+
+		uint32 PinnedCount = PinnedMemories.Num();
+		Ar.SerializeIntPacked(PinnedCount);
+		for (const FString& Name : PinnedMemories)
+		{
+			uint32 NameIndex = StringTable.Add(Name);
+			Ar.SerializeIntPacked(NameIndex);
+		}
+
+		History.Save(Ar);
+	}
+
+	/** Put the string table in front of the records, compress, and prepend the header */
+	TArray<uint8> FinishSave(const FStringTableWriter& StringTable, const TArray<uint8>& RecordBytes, bool bCompress)
+	{
+		TArray<uint8> Payload;
+		{
+			FMemoryWriter Ar(Payload);
+			StringTable.Write(Ar);
+			Ar.Serialize(RecordBytes.GetData(), RecordBytes.Num());
+		}
+
+		FSaveHeader Header;
+		Header.PayloadSize = Payload.Num();
+		Header.StoredSize = Payload.Num();
+
+		TArray<uint8> Result;
+		Result.Reserve(HeaderSize + Payload.Num());
+		Result.AddUninitialized(HeaderSize);
+
+		bool bStoredCompressed = false;
+		if (bCompress && Payload.Num() > 0)
+		{
+			const ESaveCompression Compression = FCompression::IsFormatValid(NAME_Oodle) ? ESaveCompression::Oodle : ESaveCompression::Zlib;
+			const FName Format = GetCompressionFormat(Compression);
+
+			int32 CompressedSize = FCompression::CompressMemoryBound(Format, Payload.Num());
+			Result.AddUninitialized(CompressedSize);
+			if (FCompression::CompressMemory(Format, Result.GetData() + HeaderSize, CompressedSize, Payload.GetData(), Payload.Num(), COMPRESS_BiasSpeed)
+				&& CompressedSize < Payload.Num())
+			{
+				Result.SetNum(HeaderSize + CompressedSize, EAllowShrinking::No);
+				Header.Compression = static_cast<uint8>(Compression);
+				Header.StoredSize = CompressedSize;
+				bStoredCompressed = true;
+			}
+			else
+			{
+				Result.SetNum(HeaderSize, EAllowShrinking::No);
+			}
+		}
+
+		if (!bStoredCompressed)
+		{
+			Result.Append(Payload);
+		}
+
+		TArray<uint8> HeaderBytes;
+		FMemoryWriter HeaderAr(HeaderBytes);
+		HeaderAr << Header;
+		check(HeaderBytes.Num() == HeaderSize);
+		FMemory::Memcpy(Result.GetData(), HeaderBytes.GetData(), HeaderSize);
+
+		return Result;
+	}
+
+	bool ReadStringIndex(FArchive& Ar, const TArray<FString>& Strings, const FString*& OutString)
+	{
+		uint32 Index = 0;
+		Ar.SerializeIntPacked(Index);
+		if (Ar.IsError() || !Strings.IsValidIndex(static_cast<int32>(Index)))
+		{
+			Ar.SetError();
+			return false;
+		}
+		OutString = &Strings[Index];
+		return true;
+	}
+
+	bool ReadPayload(FArchive& Ar, uint16 Version, TArray<FSaveRecord>& OutRecords)
+	{
+		// Each string and record takes at least a byte; bound the counts by what is left
+		uint32 StringCount = 0;
+		Ar.SerializeIntPacked(StringCount);
+		if (Ar.IsError() || int64(StringCount) > Ar.TotalSize() - Ar.Tell())
+		{
+			return false;
+		}
+
+		TArray<FString> Strings;
+		Strings.SetNum(StringCount);
+		for (FString& Value : Strings)
+		{
+			if (!ReadUtf8(Ar, Value))
+			{
+				return false;
+			}
+		}
+
+		uint32 RecordCount = 0;
+		Ar.SerializeIntPacked(RecordCount);
+		if (Ar.IsError() || int64(RecordCount) > Ar.TotalSize() - Ar.Tell())
+		{
+			return false;
+		}
+
+		OutRecords.SetNum(RecordCount);
+		for (FSaveRecord& Record : OutRecords)
+		{
+			uint8 bPresent = 0;
+			Ar << bPresent;
+			Record.bPresent = bPresent != 0;
+			if (!Record.bPresent)
+			{
+				continue;
+			}
+
+			const FString* Design = nullptr;
+			if (!ReadStringIndex(Ar, Strings, Design))
+			{
+				return false;
+			}
+			Record.CharacterDesign = *Design;
+
+			uint32 MemoryCount = 0;
+			Ar.SerializeIntPacked(MemoryCount);
+			if (Ar.IsError() || int64(MemoryCount) * 2 > Ar.TotalSize() - Ar.Tell())
+			{
+				return false;
+			}
+			Record.Memories.Reserve(MemoryCount);
+			for (uint32 Index = 0; Index < MemoryCount; ++Index)
+			{
+				const FString* Name = nullptr;
+				const FString* Value = nullptr;
+				if (!ReadStringIndex(Ar, Strings, Name) || !ReadStringIndex(Ar, Strings, Value))
+				{
+					return false;
+				}
+				Record.Memories.Add(*Name, *Value);
+			}
+
+			if (Version >= static_cast<uint16>(FPlayKitNPCSaveFormat::EVersion::PinnedMemories))
+			{
+				uint32 PinnedCount = 0;
+				Ar.SerializeIntPacked(PinnedCount);
+				if (Ar.IsError() || int64(PinnedCount) > Ar.TotalSize() - Ar.Tell())
+				{
+					return false;
+				}
+				Record.PinnedMemories.Reserve(PinnedCount);
+				for (uint32 Index = 0; Index < PinnedCount; ++Index)
+				{
+					const FString* Name = nullptr;
+					if (!ReadStringIndex(Ar, Strings, Name))
+					{
+						return false;
+					}
+					Record.PinnedMemories.Add(*Name);
+				}
+			}
+
+			Record.History.Serialize(Ar);
+			if (Ar.IsError())
+			{
+				return false;
+			}
+		}
+
+		return !Ar.IsError();
+	}
+}
+
+TArray<uint8> FPlayKitNPCSaveFormat::Save(TConstArrayView<const UPlayKitNPCClient*> NPCs, bool bCompress)
+{
+	PLAYKIT_SCOPE(STAT_PlayKit_SaveHistory, "PlayKit::NPCSave::Save");
+
+	// Records first, so the string table is complete when it is written in front of them
+	FStringTableWriter StringTable;
+	TArray<uint8> RecordBytes;
+	{
+		FMemoryWriter Ar(RecordBytes);
+		uint32 RecordCount = NPCs.Num();
+		Ar.SerializeIntPacked(RecordCount);
+
+		for (const UPlayKitNPCClient* NPC : NPCs)
+		{
+			uint8 bPresent = NPC != nullptr;
+			Ar << bPresent;
+			if (NPC)
+			{
+				WriteRecord(Ar, StringTable, NPC->CharacterDesign, NPC->Memories, NPC->PinnedMemories, NPC->ConversationHistory);
+			}
+		}
+	}
+
+	return FinishSave(StringTable, RecordBytes, bCompress);
+}
+
+TArray<uint8> FPlayKitNPCSaveFormat::Save(TConstArrayView<const FNPCState*> States, bool bCompress)
+{
+	PLAYKIT_SCOPE(STAT_PlayKit_SaveHistory, "PlayKit::NPCSave::Save");
+
+	FStringTableWriter StringTable;
+	TArray<uint8> RecordBytes;
+	{
+		FMemoryWriter Ar(RecordBytes);
+		uint32 RecordCount = States.Num();
+		Ar.SerializeIntPacked(RecordCount);
+
+		for (const FNPCState* State : States)
+		{
+			uint8 bPresent = State != nullptr;
+			Ar << bPresent;
+			if (State)
+			{
+				WriteRecord(Ar, StringTable, State->CharacterDesign, State->Memories, State->PinnedMemories, State->History);
+			}
+		}
+	}
+
+	return FinishSave(StringTable, RecordBytes, bCompress);
+}
+
+FPlayKitNPCSaveFormat::FNPCState FPlayKitNPCSaveFormat::Capture(const UPlayKitNPCClient& NPC)
+{
+	FNPCState State;
+	State.CharacterDesign = NPC.CharacterDesign;
+	State.Memories = NPC.Memories;
+	State.PinnedMemories = NPC.PinnedMemories;
+	State.History = NPC.ConversationHistory;
+	return State;
+}
+
+int32 FPlayKitNPCSaveFormat::Load(TConstArrayView<uint8> Data, TConstArrayView<UPlayKitNPCClient*> NPCs)
+{
+	PLAYKIT_SCOPE(STAT_PlayKit_LoadHistory, "PlayKit::NPCSave::Load");
+
+	if (!IsBinarySave(Data))
+	{
+		return INDEX_NONE;
+	}
+
+	FSaveHeader Header;
+	{
+		TArray<uint8> HeaderBytes(Data.GetData(), HeaderSize);
+		FMemoryReader HeaderAr(HeaderBytes);
+		HeaderAr << Header;
+	}
+
+	if (Header.Version == 0 || Header.Version > static_cast<uint16>(EVersion::Latest))
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Unsupported save version %d (latest is %d)"),
+			Header.Version, static_cast<int32>(EVersion::Latest));
+		return INDEX_NONE;
+	}
+
+	if (Header.PayloadSize < 0 || Header.StoredSize < 0 || Header.StoredSize != Data.Num() - HeaderSize)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Save data is truncated or corrupt"));
+		return INDEX_NONE;
+	}
+
+	if (Header.PayloadSize > MaxPayloadSize)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Save payload of %d bytes exceeds the %d byte limit; treating it as corrupt"),
+			Header.PayloadSize, MaxPayloadSize);
+		return INDEX_NONE;
+	}
+
+	const uint8* Stored = Data.GetData() + HeaderSize;
+	TArray<uint8> Payload;
+	const ESaveCompression Compression = static_cast<ESaveCompression>(Header.Compression);
+	if (Compression == ESaveCompression::None)
+	{
+		if (Header.StoredSize != Header.PayloadSize)
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Save data is truncated or corrupt"));
+			return INDEX_NONE;
+		}
+		Payload.Append(Stored, Header.StoredSize);
+	}
+	else
+	{
+		const FName Format = GetCompressionFormat(Compression);
+		Payload.SetNumUninitialized(Header.PayloadSize);
+		if (Format.IsNone() || !FCompression::UncompressMemory(Format, Payload.GetData(), Header.PayloadSize, Stored, Header.StoredSize))
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Failed to decompress save data"));
+			return INDEX_NONE;
+		}
+	}
+
+	TArray<FSaveRecord> Records;
+	{
+		FMemoryReader Ar(Payload, true);
+		if (!ReadPayload(Ar, Header.Version, Records))
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Save data is corrupt"));
+			return INDEX_NONE;
+		}
+	}
+
+	if (Records.Num() != NPCs.Num())
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[NPCSave] Save holds %d NPCs, restoring into %d"), Records.Num(), NPCs.Num());
+	}
+
+	int32 Restored = 0;
+	const int32 Count = FMath::Min(Records.Num(), NPCs.Num());
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		UPlayKitNPCClient* NPC = NPCs[Index];
+		FSaveRecord& Record = Records[Index];
+		if (!NPC || !Record.bPresent)
+		{
+			continue;
+		}
+
+		NPC->ConversationHistory = MoveTemp(Record.History);
+		++NPC->HistoryRevision;
+		NPC->CharacterDesign = MoveTemp(Record.CharacterDesign);
+		NPC->Memories = MoveTemp(Record.Memories);
+		NPC->PinnedMemories = MoveTemp(Record.PinnedMemories);
+		NPC->OnMemoriesReplaced();
+		++Restored;
+	}
+
+	return Restored;
+}
+
+bool FPlayKitNPCSaveFormat::IsBinarySave(TConstArrayView<uint8> Data)
+{
+	if (Data.Num() < HeaderSize)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	FMemory::Memcpy(&Magic, Data.GetData(), sizeof(Magic));
+	return INTEL_ORDER32(Magic) == SaveMagic;
+}
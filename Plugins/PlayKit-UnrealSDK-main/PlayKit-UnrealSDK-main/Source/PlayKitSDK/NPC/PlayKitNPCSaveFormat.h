@@ -0,0 +1,65 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NPC/PlayKitNPCHistory.h"
+
+class UPlayKitNPCClient;
+
+/**
+ * Binary save format for NPC conversation state (history, character design, memories and pins).
+ *
+ * Layout:
+ *   Header    magic "PKNH", version, compression, payload sizes (never compressed)
+ *   Payload   string table, then one record per NPC
+ *
+ * The string table holds character designs, memory names and memory values once each,
+ * so NPCs sharing a design (200 pets of one species) store it once. History content is
+ * written as length-prefixed UTF-8 straight from the NPC's arena, and read back the same way.
+ * The payload is compressed with Oodle when available, else zlib, and stored raw when that
+ * does not make it smaller.
+ *
+ * Used by UPlayKitNPCClient::SaveHistoryBinary/LoadHistoryBinary and SaveHistories/LoadHistories.
+ * JSON saves from SaveHistory stay loadable through LoadHistory.
+ */
+class PLAYKITSDK_API FPlayKitNPCSaveFormat
+{
+public:
+	enum class EVersion : uint16
+	{
+		Initial = 1,
+		PinnedMemories,		// Pinned memory names after the memories
+
+		// Add new versions above
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+
+	/** A copy of the state one NPC record holds, to save away from the NPC (e.g. on another thread) */
+	struct FNPCState
+	{
+		FString CharacterDesign;
+		TMap<FString, FString> Memories;
+		TSet<FString> PinnedMemories;
+		FPlayKitNPCHistory History;
+	};
+
+	/** Serialize NPCs into one blob. Null entries are saved as empty records */
+	static TArray<uint8> Save(TConstArrayView<const UPlayKitNPCClient*> NPCs, bool bCompress);
+
+	/** Serialize copied NPC states into one blob, in the same format. Safe on any thread */
+	static TArray<uint8> Save(TConstArrayView<const FNPCState*> States, bool bCompress);
+
+	/** Copy what Save writes for an NPC. Call on the game thread */
+	static FNPCState Capture(const UPlayKitNPCClient& NPC);
+
+	/**
+	 * Restore NPCs from a blob, record i into NPCs[i]. Nothing is changed if the blob is invalid.
+	 * @return Number of NPCs restored, or INDEX_NONE if the blob is not a valid save
+	 */
+	static int32 Load(TConstArrayView<uint8> Data, TConstArrayView<UPlayKitNPCClient*> NPCs);
+
+	/** True if Data starts with the binary format's header (as opposed to a JSON save) */
+	static bool IsBinarySave(TConstArrayView<uint8> Data);
+};
@@ -0,0 +1,127 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitPredictionTrailer.h"
+#include "Tool/PlayKitJsonView.h"
+
+namespace
+{
+	const TCHAR Marker[] = TEXT("<predictions>");
+	const int32 MarkerLen = UE_ARRAY_COUNT(Marker) - 1;
+}
+
+FString FPlayKitPredictionTrailer::BuildInstruction(int32 Count)
+{
+	return FString::Printf(
+		TEXT("After your reply, on a new line, write %s followed by a JSON array of exactly %d things the player might say next. ")
+		TEXT("Each is 1-2 sentences, natural for the player character, and they differ in tone and intent: a mix of questions, statements and actions. ")
+		TEXT("Write nothing after the array. Example: %s[\"...\", \"...\"]"),
+		Marker, Count, Marker);
+}
+
+TArray<FString> FPlayKitPredictionTrailer::ParseArray(FStringView Json)
+{
+	TArray<FString> Result;
+	if (Json.IsEmpty())
+	{
+		return Result;
+	}
+
+	FTCHARToUTF8 JsonUtf8(Json.GetData(), Json.Len());
+	FPlayKitJsonView::Parse(reinterpret_cast<const uint8*>(JsonUtf8.Get()), JsonUtf8.Length())
+		.ForEachElement([&Result](const FPlayKitJsonView& Element)
+		{
+			FString Value;
+			if (Element.TryGetString(Value))
+			{
+				Value.TrimStartAndEndInline();
+				if (!Value.IsEmpty())
+				{
+					Result.Add(MoveTemp(Value));
+				}
+			}
+			return true;
+		});
+	return Result;
+}
+
+void FPlayKitPredictionTrailer::Reset()
+{
+	Reply.Reset();
+	ShownLen = 0;
+	bInTrailer = false;
+	Predictions.Reset();
+}
+
+FString FPlayKitPredictionTrailer::Append(FStringView Chunk)
+{
+	if (bInTrailer)
+	{
+		Predictions.Append(Chunk);
+		return FString();
+	}
+
+	// Only the new text, and a marker straddling the previous chunk, need searching
+	const int32 SearchFrom = FMath::Max(0, Reply.Len() - (MarkerLen - 1));
+	Reply.Append(Chunk.GetData(), Chunk.Len());
+
+	int32 SafeEnd = Reply.Len();
+	const int32 MarkerPos = Reply.Find(Marker, ESearchCase::CaseSensitive, ESearchDir::FromStart, SearchFrom);
+	if (MarkerPos != INDEX_NONE)
+	{
+		bInTrailer = true;
+		Predictions.Append(FStringView(Reply).RightChop(MarkerPos + MarkerLen));
+		Reply.LeftInline(MarkerPos, EAllowShrinking::No);
+
+		// Held-back whitespace in front of the marker is dropped; what was shown ended on a visible character
+		Reply.TrimEndInline();
+		SafeEnd = Reply.Len();
+	}
+	else
+	{
+		// Hold back a tail that may be the start of the marker
+		const FStringView ReplyView(Reply);
+		for (int32 Len = FMath::Min(MarkerLen - 1, Reply.Len()); Len > 0; --Len)
+		{
+			if (ReplyView.Right(Len).Equals(FStringView(Marker, Len), ESearchCase::CaseSensitive))
+			{
+				SafeEnd -= Len;
+				break;
+			}
+		}
+
+		while (SafeEnd > ShownLen && FChar::IsWhitespace(Reply[SafeEnd - 1]))
+		{
+			--SafeEnd;
+		}
+	}
+
+	if (SafeEnd <= ShownLen)
+	{
+		return FString();
+	}
+
+	FString Shown = Reply.Mid(ShownLen, SafeEnd - ShownLen);
+	ShownLen = SafeEnd;
+	return Shown;
+}
+
+FString FPlayKitPredictionTrailer::Finish()
+{
+	if (bInTrailer || ShownLen >= Reply.Len())
+	{
+		return FString();
+	}
+
+	FString Shown = Reply.Mid(ShownLen);
+	ShownLen = Reply.Len();
+	return Shown;
+}
+
+TArray<FString> FPlayKitPredictionTrailer::GetPredictions() const
+{
+	if (!bInTrailer)
+	{
+		return TArray<FString>();
+	}
+	return ParseArray(Predictions.IsComplete() ? Predictions.GetCompletedJson() : Predictions.GetRepairedJson());
+}
@@ -0,0 +1,63 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tool/PlayKitPartialJson.h"
+
+/**
+ * Splits reply predictions off the end of an NPC reply, so one request yields both.
+ *
+ * The request asks the model (see BuildInstruction) to end its reply with
+ *   <predictions>["...", "...", "..."]
+ * Streamed text goes through Append, which returns only the part that is safe to show: the
+ * marker and everything after it are never returned, and a tail that could be the start of
+ * the marker (or whitespace in front of it) is held back until the next chunk decides.
+ * Text after the marker feeds an FPlayKitPartialJson, so the predictions are ready as soon as
+ * the array closes, before the stream ends.
+ *
+ * Usage:
+ *   OnStreamChunk.Broadcast(Trailer.Append(Delta));
+ *   ...
+ *   OnStreamChunk.Broadcast(Trailer.Finish());
+ *   const FString Reply = Trailer.GetReply();
+ *   const TArray<FString> Predictions = Trailer.GetPredictions();
+ */
+class PLAYKITSDK_API FPlayKitPredictionTrailer
+{
+public:
+	/** Instruction for the model, sent with the request */
+	static FString BuildInstruction(int32 Count);
+
+	/** Strings of a JSON array; anything else in it is skipped */
+	static TArray<FString> ParseArray(FStringView Json);
+
+	void Reset();
+
+	/** Append reply text. Returns the newly showable part, possibly empty */
+	FString Append(FStringView Chunk);
+
+	/** End of the reply. Returns whatever was held back, if the marker never came */
+	FString Finish();
+
+	/** The reply without the trailer */
+	const FString& GetReply() const { return Reply; }
+
+	/** True once the marker has arrived */
+	bool HasTrailer() const { return bInTrailer; }
+
+	/** True once the predictions array has closed */
+	bool IsComplete() const { return Predictions.IsComplete(); }
+
+	/** Predictions so far; from the closed-up array if it never finished */
+	TArray<FString> GetPredictions() const;
+
+private:
+	FString Reply;
+
+	/** Length of Reply already returned by Append */
+	int32 ShownLen = 0;
+
+	bool bInTrailer = false;
+	FPlayKitPartialJson Predictions;
+};
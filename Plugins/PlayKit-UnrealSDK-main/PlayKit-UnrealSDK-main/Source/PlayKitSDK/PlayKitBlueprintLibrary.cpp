@@ -1,6 +1,7 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitBlueprintLibrary.h"
+#include "PlayKitLog.h"
 #include "PlayKitSettings.h"
 #include "Client/PlayKitPlayerClient.h"
 #include "NPC/PlayKitNPCClient.h"
@@ -33,14 +34,14 @@ void UPlayKitBlueprintLibrary::SetupNPC(UPlayKitNPCClient* NPCClient, const FStr
 {
 	if (!NPCClient)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] NPCClient is null"));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] NPCClient is null"));
 		return;
 	}
 
 	UPlayKitSettings* Settings = UPlayKitSettings::Get();
 	if (!Settings)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[PlayKit] Settings not found. Please configure PlayKit in Project Settings."));
+		UE_LOG(LogPlayKit, Error, TEXT("[PlayKit] Settings not found. Please configure PlayKit in Project Settings."));
 		return;
 	}
 
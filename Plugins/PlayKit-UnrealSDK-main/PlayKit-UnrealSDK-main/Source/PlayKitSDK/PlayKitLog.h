@@ -0,0 +1,51 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * PlayKit diagnostics
+ *
+ * Logging:
+ * - LogPlayKit logs at Log by default. Per-request and per-chunk detail, including request
+ *   and response bodies, is Verbose and is not even formatted unless "Enable Debug Logging"
+ *   is on in the project settings (or "log LogPlayKit Verbose" was run).
+ *
+ * Unreal Insights:
+ * - Record with -trace=default,PlayKit. Game-thread work (building bodies, parsing, broadcasting)
+ *   shows up as PlayKit timers; each request gets a region from send to completion, plus one
+ *   that ends at its first response byte.
+ *
+ * Stats:
+ * - "stat PlayKit" shows the same game-thread costs, and the queued and in-flight request counts.
+ */
+
+PLAYKITSDK_API DECLARE_LOG_CATEGORY_EXTERN(LogPlayKit, Log, All);
+
+UE_TRACE_CHANNEL_EXTERN(PlayKitChannel, PLAYKITSDK_API);
+
+DECLARE_STATS_GROUP(TEXT("PlayKit"), STATGROUP_PlayKit, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Request Body"), STAT_PlayKit_BuildBody, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse Response"), STAT_PlayKit_ParseResponse, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse Stream Chunk"), STAT_PlayKit_ParseStreamChunk, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Broadcast"), STAT_PlayKit_Broadcast, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scheduler Pump"), STAT_PlayKit_SchedulerPump, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save History"), STAT_PlayKit_SaveHistory, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load History"), STAT_PlayKit_LoadHistory, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC LOD Update"), STAT_PlayKit_LODUpdate, STATGROUP_PlayKit, PLAYKITSDK_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests Queued"), STAT_PlayKit_RequestsQueued, STATGROUP_PlayKit, PLAYKITSDK_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests In Flight"), STAT_PlayKit_RequestsInFlight, STATGROUP_PlayKit, PLAYKITSDK_API);
+
+/** Cycle counter plus an Insights timer on the PlayKit channel for the rest of the scope */
+#define PLAYKIT_SCOPE(Stat, Name) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, PlayKitChannel)
+
+/** True while the PlayKit trace channel is recording; use to skip building region names */
+#define PLAYKIT_TRACE_ENABLED() UE_TRACE_CHANNELEXPR_IS_ENABLED(PlayKitChannel)
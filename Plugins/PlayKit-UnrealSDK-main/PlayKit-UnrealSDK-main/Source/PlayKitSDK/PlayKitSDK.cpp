@@ -1,12 +1,32 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitSDK.h"
+#include "PlayKitLog.h"
+#include "Bench/PlayKitBenchmarks.h"
 
 #define LOCTEXT_NAMESPACE "FPlayKitSDKModule"
 
+DEFINE_LOG_CATEGORY(LogPlayKit);
+
+UE_TRACE_CHANNEL_DEFINE(PlayKitChannel);
+
+DEFINE_STAT(STAT_PlayKit_BuildBody);
+DEFINE_STAT(STAT_PlayKit_ParseResponse);
+DEFINE_STAT(STAT_PlayKit_ParseStreamChunk);
+DEFINE_STAT(STAT_PlayKit_Broadcast);
+DEFINE_STAT(STAT_PlayKit_SchedulerPump);
+DEFINE_STAT(STAT_PlayKit_SaveHistory);
+DEFINE_STAT(STAT_PlayKit_LoadHistory);
+DEFINE_STAT(STAT_PlayKit_LODUpdate);
+DEFINE_STAT(STAT_PlayKit_RequestsQueued);
+DEFINE_STAT(STAT_PlayKit_RequestsInFlight);
+
 void FPlayKitSDKModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+#if !UE_BUILD_SHIPPING
+	FPlayKitBenchmarks::InstallAllocationCounter();
+#endif
 }
 
 void FPlayKitSDKModule::ShutdownModule()
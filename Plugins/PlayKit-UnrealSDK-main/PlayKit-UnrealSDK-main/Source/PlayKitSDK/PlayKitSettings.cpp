@@ -1,6 +1,7 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitSettings.h"
+#include "PlayKitLog.h"
 #include "Misc/ConfigCacheIni.h"
 
 #if WITH_EDITOR
@@ -24,6 +25,17 @@ UPlayKitSettings::UPlayKitSettings()
 	CustomBaseUrl = TEXT("https://api.playkit.ai");
 }
 
+void UPlayKitSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Config is loaded by now; the default object owns the log verbosity
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ApplyLogVerbosity();
+	}
+}
+
 UPlayKitSettings* UPlayKitSettings::Get()
 {
 	return GetMutableDefault<UPlayKitSettings>();
@@ -67,7 +79,7 @@ void UPlayKitSettings::SetDeveloperToken(const FString& Token)
 
 	DeveloperTokenStatus = Token.IsEmpty() ? TEXT("Not logged in") : TEXT("Logged in");
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKitSettings] Developer token updated"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKitSettings] Developer token updated"));
 #endif
 }
 
@@ -89,7 +101,7 @@ void UPlayKitSettings::SetPlayerToken(const FString& Token)
 	GConfig->SetString(TEXT("PlayKit"), *PlayerTokenKey, *Token, GGameUserSettingsIni);
 	GConfig->Flush(false, GGameUserSettingsIni);
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKitSettings] Player token updated"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKitSettings] Player token updated"));
 }
 
 void UPlayKitSettings::ClearPlayerToken()
@@ -97,6 +109,32 @@ void UPlayKitSettings::ClearPlayerToken()
 	SetPlayerToken(FString());
 }
 
+namespace
+{
+	/** LogPlayKit's verbosity before debug logging raised it; NoLogging while not raised */
+	ELogVerbosity::Type GVerbosityBeforeDebugLogging = ELogVerbosity::NoLogging;
+}
+
+void UPlayKitSettings::ApplyLogVerbosity() const
+{
+	// Only ever raise, so -LogCmds= and [Core.Log] keep control of the category otherwise
+	const ELogVerbosity::Type Current = LogPlayKit.GetVerbosity();
+	if (bEnableDebugLogging)
+	{
+		if (Current < ELogVerbosity::Verbose)
+		{
+			GVerbosityBeforeDebugLogging = Current;
+			LogPlayKit.SetVerbosity(ELogVerbosity::Verbose);
+		}
+	}
+	else if (GVerbosityBeforeDebugLogging != ELogVerbosity::NoLogging)
+	{
+		// Turned off in the editor: undo only what was raised here
+		LogPlayKit.SetVerbosity(GVerbosityBeforeDebugLogging);
+		GVerbosityBeforeDebugLogging = ELogVerbosity::NoLogging;
+	}
+}
+
 void UPlayKitSettings::SaveSettings()
 {
 	TryUpdateDefaultConfigFile();
@@ -110,7 +148,8 @@ void UPlayKitSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyCha
 	// Save config to DefaultGame.ini when properties change
 	SaveConfig();
 	TryUpdateDefaultConfigFile();
+	ApplyLogVerbosity();
 
-	UE_LOG(LogTemp, Log, TEXT("[PlayKitSettings] Settings saved"));
+	UE_LOG(LogPlayKit, Log, TEXT("[PlayKitSettings] Settings saved"));
 }
 #endif
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "PlayKitTypes.h"
 #include "PlayKitSettings.generated.h"
 
 /**
@@ -67,6 +68,63 @@ public:
 	UPROPERTY(config, EditAnywhere, Category="Context Management", meta=(DisplayName="Auto Compact Min Messages", ClampMin="5", ClampMax="100"))
 	int32 AutoCompactMinMessages = 10;
 
+	//========== Networking ==========//
+
+	/** Maximum number of PlayKit HTTP requests in flight at once, across all endpoints */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Max Concurrent Requests", ClampMin="1", ClampMax="32"))
+	int32 MaxConcurrentRequests = 8;
+
+	/** Maximum concurrent chat/NPC requests */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Max Concurrent Chat Requests", ClampMin="1", ClampMax="32"))
+	int32 MaxConcurrentChatRequests = 4;
+
+	/** Maximum concurrent image generation requests */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Max Concurrent Image Requests", ClampMin="1", ClampMax="16"))
+	int32 MaxConcurrentImageRequests = 2;
+
+	/** Maximum concurrent 3D generation requests (including status polls) */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Max Concurrent 3D Requests", ClampMin="1", ClampMax="16"))
+	int32 MaxConcurrent3DRequests = 2;
+
+	/** Maximum concurrent speech-to-text requests */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Max Concurrent Transcription Requests", ClampMin="1", ClampMax="16"))
+	int32 MaxConcurrentTranscriptionRequests = 2;
+
+	/**
+	 * Slots (globally and per endpoint) that only Interactive requests may use.
+	 * Keeps a burst of background work from delaying the reply the player is waiting on.
+	 */
+	UPROPERTY(config, EditAnywhere, Category="Networking", meta=(DisplayName="Reserved Interactive Slots", ClampMin="0", ClampMax="8"))
+	int32 ReservedInteractiveSlots = 1;
+
+	//========== Response Cache ==========//
+
+	/** Maximum number of responses kept in memory (least recently used are evicted first) */
+	UPROPERTY(config, EditAnywhere, Category="Response Cache", meta=(DisplayName="Max Memory Entries", ClampMin="1", ClampMax="100000"))
+	int32 ResponseCacheMaxEntries = 256;
+
+	/** Seconds a cached response stays valid (0 = never expires) */
+	UPROPERTY(config, EditAnywhere, Category="Response Cache", meta=(DisplayName="Time To Live", ClampMin="0"))
+	float ResponseCacheTTLSeconds = 86400.0f;
+
+	/** Also persist cached responses under Saved/PlayKit/Cache, so they survive restarts */
+	UPROPERTY(config, EditAnywhere, Category="Response Cache", meta=(DisplayName="Enable Disk Cache"))
+	bool bEnableDiskCache = false;
+
+	//========== Transport ==========//
+
+	/** Send requests live, or record them to / replay them from a cassette file. Overridden by -PlayKitTransport= */
+	UPROPERTY(config, EditAnywhere, Category="Transport", meta=(DisplayName="Mode"))
+	EPlayKitTransportMode TransportMode = EPlayKitTransportMode::Live;
+
+	/** Cassette file, relative to the project's Saved directory unless absolute. Overridden by -PlayKitCassette= */
+	UPROPERTY(config, EditAnywhere, Category="Transport", meta=(DisplayName="Cassette File"))
+	FString CassetteFile = TEXT("PlayKit/Cassettes/Default.json");
+
+	/** Multiplier on recorded delays during replay: 1 = original timing, 0 = as fast as possible. Overridden by -PlayKitReplayTimeScale= */
+	UPROPERTY(config, EditAnywhere, Category="Transport", meta=(DisplayName="Replay Time Scale", ClampMin="0"))
+	float ReplayTimeScale = 1.0f;
+
 	//========== Advanced ==========//
 
 	/** Override the default API base URL (leave empty to use default: https://api.playkit.ai) */
@@ -77,7 +135,7 @@ public:
 	UPROPERTY(config, EditAnywhere, Category="Advanced", meta=(DisplayName="Ignore Developer Token"))
 	bool bIgnoreDeveloperToken = false;
 
-	/** Enable verbose logging for debugging */
+	/** Log per-request detail and request/response bodies to LogPlayKit at Verbose. When off, that logging costs nothing */
 	UPROPERTY(config, EditAnywhere, Category="Advanced", meta=(DisplayName="Enable Debug Logging"))
 	bool bEnableDebugLogging = false;
 
@@ -113,10 +171,17 @@ public:
 	/** Clear the player token */
 	void ClearPlayerToken();
 
+	/** Raise LogPlayKit to Verbose while bEnableDebugLogging is set; otherwise leave the category's configured verbosity alone */
+	void ApplyLogVerbosity() const;
+
 	/** Save Config */
 	UFUNCTION(CallInEditor)
 	void SaveSettings();
 	
+	//========== UObject Interface ==========//
+
+	virtual void PostInitProperties() override;
+
 	//========== UDeveloperSettings Interface ==========//
 
 	virtual FName GetCategoryName() const override { return FName(TEXT("Plugins")); }
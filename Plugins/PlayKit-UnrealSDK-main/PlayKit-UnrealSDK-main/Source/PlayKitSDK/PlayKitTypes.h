@@ -64,6 +64,10 @@ struct PLAYKITSDK_API FPlayKitChatResponse
 	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
 	bool bSuccess = false;
 
+	/** Handle of the request this response belongs to (0 if not tied to a request) */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
+	int32 RequestId = 0;
+
 	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
 	FString Content;
 
@@ -102,6 +106,33 @@ struct PLAYKITSDK_API FPlayKitChatConfig
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit")
 	int32 MaxTokens = 0; // 0 = no limit
+
+	/** Skip the response cache for this call, even if the component has it enabled */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="PlayKit")
+	bool bBypassCache = false;
+};
+
+/**
+ * Result of a batch of chat generations
+ */
+USTRUCT(BlueprintType)
+struct PLAYKITSDK_API FPlayKitChatBatchResult
+{
+	GENERATED_BODY()
+
+	/** Handle returned by GenerateTextBatch */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
+	int32 BatchId = 0;
+
+	/** One response per input config, in input order. Failed items have bSuccess=false and an ErrorMessage */
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
+	TArray<FPlayKitChatResponse> Responses;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
+	int32 SucceededCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="PlayKit")
+	int32 FailedCount = 0;
 };
 
 //========== Image Types ==========//
@@ -272,6 +303,12 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatStreamChunk, const FString&,
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatStreamComplete, const FString&, FullContent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnChatError, const FString&, ErrorCode, const FString&, ErrorMessage);
 
+// Chat delegates carrying the request handle
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnChatRequestStreamChunk, int32, RequestId, const FString&, Chunk);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnChatRequestStreamComplete, int32, RequestId, const FString&, FullContent);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnChatRequestError, int32, RequestId, const FString&, ErrorCode, const FString&, ErrorMessage);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatBatchComplete, const FPlayKitChatBatchResult&, Result);
+
 // Image delegates
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnImageGenerated, FPlayKitGeneratedImage, Image);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnImagesGenerated, const TArray<FPlayKitGeneratedImage>&, Images);
@@ -466,3 +503,33 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlayKit3DProgress, const FString
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnPlayKit3DStatusChanged, const FString&, TaskId, EPlayKit3DTaskStatus, OldStatus, EPlayKit3DTaskStatus, NewStatus);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayKit3DCompleted, FPlayKit3DResponse, Response);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlayKit3DError, const FString&, ErrorCode, const FString&, ErrorMessage);
+
+//========== Transport Types ==========//
+
+/**
+ * Where PlayKit requests go (see UPlayKitTransport)
+ */
+UENUM(BlueprintType)
+enum class EPlayKitTransportMode : uint8
+{
+	/** Send requests to the server */
+	Live,
+	/** Send requests to the server and write every exchange to the cassette */
+	Record,
+	/** Serve requests from the cassette without touching the network */
+	Replay
+};
+
+//========== NPC Types ==========//
+
+/**
+ * Author of a message in an NPC conversation
+ */
+UENUM(BlueprintType)
+enum class ENPCMessageRole : uint8
+{
+	System UMETA(DisplayName = "System"),
+	User UMETA(DisplayName = "User"),
+	Assistant UMETA(DisplayName = "Assistant"),
+	Tool UMETA(DisplayName = "Tool")
+};
@@ -0,0 +1,586 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitRequestScheduler.h"
+#include "PlayKitLog.h"
+#include "PlayKitSettings.h"
+#include "Metrics/PlayKitMetrics.h"
+#include "Transport/PlayKitTransport.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+namespace
+{
+	const TCHAR* const FirstByteRegionSuffix = TEXT(" (awaiting first byte)");
+}
+
+void UPlayKitRequestScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	UE_LOG(LogPlayKit, Log, TEXT("[RequestScheduler] Initialized"));
+}
+
+void UPlayKitRequestScheduler::Deinitialize()
+{
+	// Queued requests were never sent; in-flight ones finish on their own and no longer report back here
+	DEC_DWORD_STAT_BY(STAT_PlayKit_RequestsQueued, GetQueuedRequestCount());
+	for (FPriorityQueue& Queue : Queues)
+	{
+		Queue.Owners.Empty();
+		Queue.NextOwner = 0;
+	}
+
+	DEC_DWORD_STAT_BY(STAT_PlayKit_RequestsInFlight, InFlight.Num());
+	for (FInFlightRequest& Entry : InFlight)
+	{
+		EndRequestTrace(Entry);
+	}
+	InFlight.Empty();
+	InFlightPerEndpoint.Empty();
+
+	Super::Deinitialize();
+}
+
+UPlayKitRequestScheduler* UPlayKitRequestScheduler::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UGameInstance* GameInstance = Cast<UGameInstance>(WorldContextObject);
+	if (!GameInstance)
+	{
+		if (const UGameInstanceSubsystem* Subsystem = Cast<UGameInstanceSubsystem>(WorldContextObject))
+		{
+			GameInstance = Subsystem->GetGameInstance();
+		}
+		else if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			GameInstance = World->GetGameInstance();
+		}
+	}
+
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitRequestScheduler>() : nullptr;
+}
+
+//========== Submission ==========//
+
+void UPlayKitRequestScheduler::Submit(const UObject* Owner, const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request,
+	EPlayKitRequestPriority Priority, EPlayKitEndpoint Endpoint, const FString& Model)
+{
+	if (UPlayKitRequestScheduler* Scheduler = Get(Owner))
+	{
+		Scheduler->Enqueue(Owner, Request, Priority, Endpoint, Model);
+		return;
+	}
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[RequestScheduler] No game instance for %s, sending directly"), *GetNameSafe(Owner));
+	Request->ProcessRequest();
+}
+
+void UPlayKitRequestScheduler::Cancel(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	if (!Request.IsValid())
+	{
+		return;
+	}
+
+	if (UPlayKitRequestScheduler* Scheduler = Get(Owner))
+	{
+		Scheduler->CancelRequest(Request);
+		return;
+	}
+
+	Request->CancelRequest();
+}
+
+void UPlayKitRequestScheduler::Enqueue(const UObject* Owner, const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request,
+	EPlayKitRequestPriority Priority, EPlayKitEndpoint Endpoint, const FString& Model)
+{
+	if (UPlayKitMetrics* Metrics = GetMetrics())
+	{
+		Metrics->BeginTrace(&Request.Get(), Endpoint, Model);
+	}
+
+	FPriorityQueue& Queue = Queues[static_cast<int32>(Priority)];
+	const FObjectKey OwnerKey(Owner);
+
+	FOwnerQueue* OwnerQueue = Queue.Owners.FindByPredicate([&OwnerKey](const FOwnerQueue& Entry)
+	{
+		return Entry.Owner == OwnerKey;
+	});
+	if (!OwnerQueue)
+	{
+		OwnerQueue = &Queue.Owners.AddDefaulted_GetRef();
+		OwnerQueue->Owner = OwnerKey;
+	}
+
+	FQueuedRequest& Queued = OwnerQueue->Requests.AddDefaulted_GetRef();
+	Queued.Request = Request;
+	Queued.Priority = Priority;
+	Queued.Endpoint = Endpoint;
+	Queued.Model = Model;
+	INC_DWORD_STAT(STAT_PlayKit_RequestsQueued);
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[RequestScheduler] Queued %s request from %s (priority %d)"),
+		*UEnum::GetValueAsString(Endpoint), *GetNameSafe(Owner), static_cast<int32>(Priority));
+
+	Pump();
+}
+
+void UPlayKitRequestScheduler::CancelRequest(const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	// Still queued: just forget it, it was never sent
+	for (FPriorityQueue& Queue : Queues)
+	{
+		for (int32 OwnerIndex = 0; OwnerIndex < Queue.Owners.Num(); ++OwnerIndex)
+		{
+			TArray<FQueuedRequest>& Requests = Queue.Owners[OwnerIndex].Requests;
+			const int32 Index = Requests.IndexOfByPredicate([&Request](const FQueuedRequest& Entry)
+			{
+				return Entry.Request == Request;
+			});
+			if (Index != INDEX_NONE)
+			{
+				if (UPlayKitMetrics* Metrics = GetMetrics())
+				{
+					Metrics->DiscardTrace(Request.Get());
+				}
+
+				Requests.RemoveAt(Index);
+				DEC_DWORD_STAT(STAT_PlayKit_RequestsQueued);
+				if (Requests.Num() == 0)
+				{
+					Queue.Owners.RemoveAt(OwnerIndex);
+					if (Queue.NextOwner > OwnerIndex)
+					{
+						Queue.NextOwner--;
+					}
+				}
+				return;
+			}
+		}
+	}
+
+	// In flight: free the slot first, in case the caller already unbound the completion delegate
+	const bool bWasInFlight = ReleaseSlot(Request.Get());
+	if (UPlayKitMetrics* Metrics = GetMetrics())
+	{
+		Metrics->DiscardTrace(Request.Get());
+	}
+	Request->CancelRequest();
+
+	if (bWasInFlight)
+	{
+		Pump();
+	}
+}
+
+void UPlayKitRequestScheduler::RebindHandlers(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request,
+	const FHttpRequestCompleteDelegate& OnComplete, const FHttpRequestProgressDelegate64& OnProgress)
+{
+	if (!Request.IsValid())
+	{
+		return;
+	}
+
+	UPlayKitRequestScheduler* Scheduler = Get(Owner);
+	if (Scheduler && Scheduler->RebindInFlight(Request.Get(), OnComplete, OnProgress))
+	{
+		return;
+	}
+
+	// Not sent by the scheduler yet (or sent directly): the request's delegates are still the client's own
+	if (Scheduler && Request->GetStatus() != EHttpRequestStatus::NotStarted)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[RequestScheduler] Rebinding a request the scheduler no longer tracks"));
+	}
+	Request->OnProcessRequestComplete() = OnComplete;
+	Request->OnRequestProgress64() = OnProgress;
+}
+
+bool UPlayKitRequestScheduler::RebindInFlight(const IHttpRequest* Request,
+	const FHttpRequestCompleteDelegate& OnComplete, const FHttpRequestProgressDelegate64& OnProgress)
+{
+	FInFlightRequest* Entry = InFlight.FindByPredicate([Request](const FInFlightRequest& Candidate)
+	{
+		return Candidate.Request.Get() == Request;
+	});
+	if (!Entry || !Entry->Handlers.IsValid())
+	{
+		return false;
+	}
+
+	Entry->Handlers->OnComplete = OnComplete;
+	Entry->Handlers->OnProgress = OnProgress;
+	return true;
+}
+
+//========== Dispatch ==========//
+
+void UPlayKitRequestScheduler::Pump()
+{
+	if (bIsPumping)
+	{
+		// A request completed synchronously inside Dispatch; the outer loop picks up the freed slot
+		return;
+	}
+
+	TGuardValue<bool> PumpGuard(bIsPumping, true);
+	PLAYKIT_SCOPE(STAT_PlayKit_SchedulerPump, "PlayKit::Scheduler::Pump");
+
+	ReclaimFinishedSlots();
+
+	// Always restart from the highest class, so an interactive request queued by a
+	// completion callback goes out before anything else
+	bool bDispatched = true;
+	while (bDispatched)
+	{
+		bDispatched = false;
+		for (int32 PriorityIndex = 0; PriorityIndex < UE_ARRAY_COUNT(Queues); ++PriorityIndex)
+		{
+			if (TryDispatchFrom(Queues[PriorityIndex], static_cast<EPlayKitRequestPriority>(PriorityIndex)))
+			{
+				bDispatched = true;
+				break;
+			}
+		}
+	}
+}
+
+bool UPlayKitRequestScheduler::TryDispatchFrom(FPriorityQueue& Queue, EPlayKitRequestPriority Priority)
+{
+	// Drop work whose owner is gone or that was cancelled directly on the request
+	UPlayKitMetrics* Metrics = GetMetrics();
+	for (int32 OwnerIndex = Queue.Owners.Num() - 1; OwnerIndex >= 0; --OwnerIndex)
+	{
+		FOwnerQueue& OwnerQueue = Queue.Owners[OwnerIndex];
+		const bool bOwnerAlive = OwnerQueue.Owner.ResolveObjectPtr() != nullptr;
+		OwnerQueue.Requests.RemoveAll([bOwnerAlive, Metrics](const FQueuedRequest& Entry)
+		{
+			const bool bStale = !bOwnerAlive || !Entry.Request.IsValid() || Entry.Request->GetStatus() != EHttpRequestStatus::NotStarted;
+			if (bStale)
+			{
+				DEC_DWORD_STAT(STAT_PlayKit_RequestsQueued);
+				if (Metrics && Entry.Request.IsValid())
+				{
+					Metrics->DiscardTrace(Entry.Request.Get());
+				}
+			}
+			return bStale;
+		});
+
+		if (OwnerQueue.Requests.Num() == 0)
+		{
+			Queue.Owners.RemoveAt(OwnerIndex);
+			if (Queue.NextOwner > OwnerIndex)
+			{
+				Queue.NextOwner--;
+			}
+		}
+	}
+
+	const int32 NumOwners = Queue.Owners.Num();
+	for (int32 Step = 0; Step < NumOwners; ++Step)
+	{
+		const int32 OwnerIndex = (Queue.NextOwner + Step) % NumOwners;
+		FOwnerQueue& OwnerQueue = Queue.Owners[OwnerIndex];
+
+		// Oldest request per endpoint first; a full endpoint does not block the owner's other endpoints
+		const int32 Candidate = OwnerQueue.Requests.IndexOfByPredicate([this, Priority](const FQueuedRequest& Entry)
+		{
+			return HasCapacity(Entry.Endpoint, Priority);
+		});
+		if (Candidate == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FQueuedRequest Queued = MoveTemp(OwnerQueue.Requests[Candidate]);
+		OwnerQueue.Requests.RemoveAt(Candidate);
+		DEC_DWORD_STAT(STAT_PlayKit_RequestsQueued);
+
+		// Next turn goes to the following owner
+		if (OwnerQueue.Requests.Num() == 0)
+		{
+			Queue.Owners.RemoveAt(OwnerIndex);
+			Queue.NextOwner = Queue.Owners.Num() > 0 ? OwnerIndex % Queue.Owners.Num() : 0;
+		}
+		else
+		{
+			Queue.NextOwner = (OwnerIndex + 1) % NumOwners;
+		}
+
+		Dispatch(MoveTemp(Queued));
+		return true;
+	}
+
+	return false;
+}
+
+bool UPlayKitRequestScheduler::HasCapacity(EPlayKitEndpoint Endpoint, EPlayKitRequestPriority Priority) const
+{
+	const UPlayKitSettings* Settings = UPlayKitSettings::Get();
+	const int32 GlobalLimit = Settings ? Settings->MaxConcurrentRequests : 8;
+	const int32 Reserved = (Priority == EPlayKitRequestPriority::Interactive || !Settings) ? 0 : Settings->ReservedInteractiveSlots;
+
+	// Non-interactive traffic never takes the reserved slots, but always keeps at least one
+	if (InFlight.Num() >= FMath::Max(1, GlobalLimit - Reserved))
+	{
+		return false;
+	}
+
+	const int32 EndpointLimit = GetEndpointLimit(Endpoint);
+	if (EndpointLimit == MAX_int32)
+	{
+		return true;
+	}
+
+	return InFlightPerEndpoint.FindRef(Endpoint) < FMath::Max(1, EndpointLimit - Reserved);
+}
+
+void UPlayKitRequestScheduler::Dispatch(FQueuedRequest&& Queued)
+{
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request = Queued.Request;
+
+	FInFlightRequest& Entry = InFlight.AddDefaulted_GetRef();
+	Entry.Request = Request;
+	Entry.Endpoint = Queued.Endpoint;
+	InFlightPerEndpoint.FindOrAdd(Queued.Endpoint)++;
+	INC_DWORD_STAT(STAT_PlayKit_RequestsInFlight);
+	BeginRequestTrace(Entry, Queued.Model);
+
+	// Wrap the client's completion delegate so the slot is freed before the client sees the result,
+	// and the sample is recorded after the client has reported its token counts.
+	// The client's delegates are held separately so RebindHandlers can swap them while in flight
+	TSharedRef<FClientHandlers> ClientHandlers = MakeShared<FClientHandlers>();
+	ClientHandlers->OnComplete = Request->OnProcessRequestComplete();
+	ClientHandlers->OnProgress = Request->OnRequestProgress64();
+	Entry.Handlers = ClientHandlers;
+
+	TWeakObjectPtr<UPlayKitRequestScheduler> WeakThis(this);
+	TWeakObjectPtr<UPlayKitMetrics> WeakMetrics(GetMetrics());
+	Request->OnProcessRequestComplete().BindLambda(
+		[WeakThis, WeakMetrics, ClientHandlers](FHttpRequestPtr CompletedRequest, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			if (UPlayKitRequestScheduler* Scheduler = WeakThis.Get())
+			{
+				Scheduler->ReleaseSlot(CompletedRequest.Get());
+			}
+
+			// Copied, in case the handler rebinds itself
+			const FHttpRequestCompleteDelegate ClientDelegate = ClientHandlers->OnComplete;
+			ClientDelegate.ExecuteIfBound(CompletedRequest, Response, bWasSuccessful);
+
+			if (UPlayKitMetrics* Metrics = WeakMetrics.Get())
+			{
+				Metrics->EndTrace(CompletedRequest.Get(), Response, bWasSuccessful);
+			}
+
+			if (UPlayKitRequestScheduler* Scheduler = WeakThis.Get())
+			{
+				Scheduler->Pump();
+			}
+		});
+
+	if (UPlayKitMetrics* Metrics = WeakMetrics.Get())
+	{
+		Metrics->MarkSent(Request.Get());
+	}
+
+	// Watch for the first response byte, then hand progress on to the client as before
+	Request->OnRequestProgress64().BindLambda(
+		[WeakThis, WeakMetrics, ClientHandlers](FHttpRequestPtr ProgressRequest, uint64 BytesSent, uint64 BytesReceived)
+		{
+			if (BytesReceived > 0)
+			{
+				if (UPlayKitMetrics* Metrics = WeakMetrics.Get())
+				{
+					Metrics->MarkFirstByte(ProgressRequest.Get());
+				}
+				if (UPlayKitRequestScheduler* Scheduler = WeakThis.Get())
+				{
+					Scheduler->NoteFirstByte(ProgressRequest.Get());
+				}
+			}
+			const FHttpRequestProgressDelegate64 ClientProgress = ClientHandlers->OnProgress;
+			ClientProgress.ExecuteIfBound(ProgressRequest, BytesSent, BytesReceived);
+		});
+
+	UE_LOG(LogPlayKit, Verbose, TEXT("[RequestScheduler] Sending %s request (priority %d, %d in flight)"),
+		*UEnum::GetValueAsString(Queued.Endpoint), static_cast<int32>(Queued.Priority), InFlight.Num());
+
+	// Last, so a recording sees exactly what the client and the wrappers above see
+	if (UPlayKitTransport* Transport = GetTransport())
+	{
+		Transport->NotifyRequestStarting(Request.ToSharedRef());
+	}
+
+	bool bStarted = false;
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("PlayKit::Scheduler::Send", PlayKitChannel);
+		bStarted = Request->ProcessRequest();
+	}
+
+	if (!bStarted)
+	{
+		ReleaseSlot(Request.Get());
+		if (UPlayKitMetrics* Metrics = WeakMetrics.Get())
+		{
+			Metrics->DiscardTrace(Request.Get());
+		}
+	}
+}
+
+bool UPlayKitRequestScheduler::ReleaseSlot(const IHttpRequest* Request)
+{
+	const int32 Index = InFlight.IndexOfByPredicate([Request](const FInFlightRequest& Entry)
+	{
+		return Entry.Request.Get() == Request;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	int32& EndpointCount = InFlightPerEndpoint.FindOrAdd(InFlight[Index].Endpoint);
+	EndpointCount = FMath::Max(0, EndpointCount - 1);
+	EndRequestTrace(InFlight[Index]);
+	InFlight.RemoveAtSwap(Index);
+	DEC_DWORD_STAT(STAT_PlayKit_RequestsInFlight);
+	return true;
+}
+
+void UPlayKitRequestScheduler::ReclaimFinishedSlots()
+{
+	for (int32 Index = InFlight.Num() - 1; Index >= 0; --Index)
+	{
+		const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request = InFlight[Index].Request;
+		if (!Request.IsValid() || EHttpRequestStatus::IsFinished(Request->GetStatus()))
+		{
+			// Last resort: the completion hook should have released this slot
+			if (Request.IsValid())
+			{
+				UE_LOG(LogPlayKit, Warning, TEXT("[RequestScheduler] Reclaiming the slot of a finished %s request that never reported completion"),
+					*UEnum::GetValueAsString(InFlight[Index].Endpoint));
+
+				if (UPlayKitMetrics* Metrics = GetMetrics())
+				{
+					Metrics->EndTrace(Request.Get(), Request->GetResponse(), Request->GetStatus() == EHttpRequestStatus::Succeeded);
+				}
+			}
+
+			int32& EndpointCount = InFlightPerEndpoint.FindOrAdd(InFlight[Index].Endpoint);
+			EndpointCount = FMath::Max(0, EndpointCount - 1);
+			EndRequestTrace(InFlight[Index]);
+			InFlight.RemoveAtSwap(Index);
+			DEC_DWORD_STAT(STAT_PlayKit_RequestsInFlight);
+		}
+	}
+}
+
+int32 UPlayKitRequestScheduler::GetEndpointLimit(EPlayKitEndpoint Endpoint) const
+{
+	const UPlayKitSettings* Settings = UPlayKitSettings::Get();
+	if (!Settings)
+	{
+		return MAX_int32;
+	}
+
+	switch (Endpoint)
+	{
+	case EPlayKitEndpoint::Chat:          return Settings->MaxConcurrentChatRequests;
+	case EPlayKitEndpoint::Image:         return Settings->MaxConcurrentImageRequests;
+	case EPlayKitEndpoint::Model3D:       return Settings->MaxConcurrent3DRequests;
+	case EPlayKitEndpoint::Transcription: return Settings->MaxConcurrentTranscriptionRequests;
+	default:                              return MAX_int32;
+	}
+}
+
+UPlayKitMetrics* UPlayKitRequestScheduler::GetMetrics() const
+{
+	const UGameInstance* GameInstance = GetGameInstance();
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitMetrics>() : nullptr;
+}
+
+UPlayKitTransport* UPlayKitRequestScheduler::GetTransport() const
+{
+	const UGameInstance* GameInstance = GetGameInstance();
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitTransport>() : nullptr;
+}
+
+//========== Tracing ==========//
+
+void UPlayKitRequestScheduler::BeginRequestTrace(FInFlightRequest& Entry, const FString& Model)
+{
+	if (!PLAYKIT_TRACE_ENABLED())
+	{
+		return;
+	}
+
+	// Regions are matched by name, so each request needs its own
+	Entry.TraceRegion = FString::Printf(TEXT("PlayKit %s %s #%u"),
+		*StaticEnum<EPlayKitEndpoint>()->GetNameStringByValue(static_cast<int64>(Entry.Endpoint)),
+		Model.IsEmpty() ? TEXT("-") : *Model, ++NextTraceId);
+	Entry.bAwaitingFirstByte = true;
+
+	TRACE_BEGIN_REGION(*Entry.TraceRegion);
+	TRACE_BEGIN_REGION(*(Entry.TraceRegion + FirstByteRegionSuffix));
+}
+
+void UPlayKitRequestScheduler::NoteFirstByte(const IHttpRequest* Request)
+{
+	FInFlightRequest* Entry = InFlight.FindByPredicate([Request](const FInFlightRequest& Candidate)
+	{
+		return Candidate.Request.Get() == Request;
+	});
+	if (Entry && Entry->bAwaitingFirstByte)
+	{
+		Entry->bAwaitingFirstByte = false;
+		TRACE_END_REGION(*(Entry->TraceRegion + FirstByteRegionSuffix));
+	}
+}
+
+void UPlayKitRequestScheduler::EndRequestTrace(FInFlightRequest& Entry)
+{
+	if (Entry.TraceRegion.IsEmpty())
+	{
+		return;
+	}
+
+	if (Entry.bAwaitingFirstByte)
+	{
+		Entry.bAwaitingFirstByte = false;
+		TRACE_END_REGION(*(Entry.TraceRegion + FirstByteRegionSuffix));
+	}
+	TRACE_END_REGION(*Entry.TraceRegion);
+	Entry.TraceRegion.Reset();
+}
+
+//========== Status ==========//
+
+int32 UPlayKitRequestScheduler::GetQueuedRequestCount() const
+{
+	int32 Count = 0;
+	for (int32 PriorityIndex = 0; PriorityIndex < UE_ARRAY_COUNT(Queues); ++PriorityIndex)
+	{
+		Count += GetQueuedRequestCountForPriority(static_cast<EPlayKitRequestPriority>(PriorityIndex));
+	}
+	return Count;
+}
+
+int32 UPlayKitRequestScheduler::GetQueuedRequestCountForPriority(EPlayKitRequestPriority Priority) const
+{
+	int32 Count = 0;
+	for (const FOwnerQueue& OwnerQueue : Queues[static_cast<int32>(Priority)].Owners)
+	{
+		Count += OwnerQueue.Requests.Num();
+	}
+	return Count;
+}
+
+int32 UPlayKitRequestScheduler::GetActiveRequestCountForEndpoint(EPlayKitEndpoint Endpoint) const
+{
+	return InFlightPerEndpoint.FindRef(Endpoint);
+}
@@ -0,0 +1,195 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/IHttpRequest.h"
+#include "UObject/ObjectKey.h"
+#include "PlayKitRequestScheduler.generated.h"
+
+/**
+ * Request priority classes, highest first.
+ * A queued request is always dispatched before any request of a lower class.
+ */
+UENUM(BlueprintType)
+enum class EPlayKitRequestPriority : uint8
+{
+	/** Dialogue the player is actively waiting on */
+	Interactive,
+	/** Reply predictions and other speculative work */
+	Prediction,
+	/** Housekeeping such as conversation compaction */
+	Background,
+	/** Large generations: images and 3D models */
+	Bulk
+};
+
+/**
+ * Endpoint groups with their own concurrency limit
+ */
+UENUM(BlueprintType)
+enum class EPlayKitEndpoint : uint8
+{
+	Chat,
+	Image,
+	Model3D,
+	Transcription,
+	/** Player/account API. Only bounded by the global limit */
+	Player
+};
+
+/**
+ * PlayKit Request Scheduler
+ * Single entry point for every PlayKit HTTP request.
+ *
+ * Features:
+ * - Priority classes (interactive dialogue > predictions > compaction > image/3D)
+ * - Global and per-endpoint concurrency limits (see UPlayKitSettings, Networking)
+ * - Slots reserved for Interactive requests, so background bursts never delay a reply
+ * - Round-robin between owners within a priority class, so one busy component cannot starve the others
+ * - Request lifecycle timing reported to UPlayKitMetrics, and as Insights regions on the PlayKit trace channel
+ *
+ * Usage (from a client):
+ * UPlayKitRequestScheduler::Submit(this, Request, EPlayKitRequestPriority::Interactive, EPlayKitEndpoint::Chat);
+ *
+ * Bind the request's delegates before submitting, and change them afterwards only through
+ * RebindHandlers. Requests that were cancelled while still queued are dropped when they
+ * reach the front of the queue.
+ */
+UCLASS()
+class PLAYKITSDK_API UPlayKitRequestScheduler : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Scheduler", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitRequestScheduler* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Queue a request for dispatch. Falls back to sending it immediately when no
+	 * game instance is reachable from the owner (e.g. editor utilities).
+	 * @param Owner The object issuing the request. Used for fair queuing and as world context
+	 * @param Request A fully configured request with its delegates bound
+	 * @param Priority Priority class
+	 * @param Endpoint Endpoint group whose concurrency limit applies
+	 * @param Model Model name the request's metrics are filed under
+	 */
+	static void Submit(const UObject* Owner, const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request,
+		EPlayKitRequestPriority Priority, EPlayKitEndpoint Endpoint, const FString& Model = FString());
+
+	/**
+	 * Cancel a request that was submitted through the scheduler.
+	 * Removes it from the queue if it has not been sent yet, otherwise frees its slot and cancels it.
+	 */
+	static void Cancel(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request);
+
+	/**
+	 * Replace the client's completion and progress handlers of a submitted request.
+	 * Binding the request's delegates directly after it was sent would drop the scheduler's own
+	 * hooks, leaving its slot taken and its metrics unrecorded; use this instead.
+	 */
+	static void RebindHandlers(const UObject* Owner, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request,
+		const FHttpRequestCompleteDelegate& OnComplete, const FHttpRequestProgressDelegate64& OnProgress);
+
+	//========== Status ==========//
+
+	/** Number of requests waiting for a slot */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Scheduler")
+	int32 GetQueuedRequestCount() const;
+
+	/** Number of requests waiting for a slot in a priority class */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Scheduler")
+	int32 GetQueuedRequestCountForPriority(EPlayKitRequestPriority Priority) const;
+
+	/** Number of requests in flight */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Scheduler")
+	int32 GetActiveRequestCount() const { return InFlight.Num(); }
+
+	/** Number of requests in flight for an endpoint group */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Scheduler")
+	int32 GetActiveRequestCountForEndpoint(EPlayKitEndpoint Endpoint) const;
+
+private:
+	struct FQueuedRequest
+	{
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+		EPlayKitEndpoint Endpoint = EPlayKitEndpoint::Chat;
+		EPlayKitRequestPriority Priority = EPlayKitRequestPriority::Interactive;
+		FString Model;
+	};
+
+	/** Requests from one owner, in submission order */
+	struct FOwnerQueue
+	{
+		FObjectKey Owner;
+		TArray<FQueuedRequest> Requests;
+	};
+
+	/** All owners with pending work in one priority class, served round-robin */
+	struct FPriorityQueue
+	{
+		TArray<FOwnerQueue> Owners;
+		int32 NextOwner = 0;
+	};
+
+	/** The client's own delegates, called by the scheduler's wrappers once the request is sent */
+	struct FClientHandlers
+	{
+		FHttpRequestCompleteDelegate OnComplete;
+		FHttpRequestProgressDelegate64 OnProgress;
+	};
+
+	struct FInFlightRequest
+	{
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+		EPlayKitEndpoint Endpoint = EPlayKitEndpoint::Chat;
+		TSharedPtr<FClientHandlers> Handlers;
+
+		/** Insights region open from send to completion. Empty when the PlayKit channel was off at send */
+		FString TraceRegion;
+		bool bAwaitingFirstByte = false;
+	};
+
+	void Enqueue(const UObject* Owner, const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request,
+		EPlayKitRequestPriority Priority, EPlayKitEndpoint Endpoint, const FString& Model);
+	void CancelRequest(const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request);
+	bool RebindInFlight(const IHttpRequest* Request, const FHttpRequestCompleteDelegate& OnComplete, const FHttpRequestProgressDelegate64& OnProgress);
+
+	/** Send as many queued requests as the limits allow */
+	void Pump();
+	bool TryDispatchFrom(FPriorityQueue& Queue, EPlayKitRequestPriority Priority);
+	bool HasCapacity(EPlayKitEndpoint Endpoint, EPlayKitRequestPriority Priority) const;
+	void Dispatch(FQueuedRequest&& Queued);
+
+	/** Free the slot of a finished or cancelled request. Returns false if it was not in flight */
+	bool ReleaseSlot(const IHttpRequest* Request);
+
+	/** Free slots whose requests finished without going through the completion hook (e.g. delegate unbound on cancel) */
+	void ReclaimFinishedSlots();
+
+	int32 GetEndpointLimit(EPlayKitEndpoint Endpoint) const;
+
+	//========== Tracing ==========//
+
+	void BeginRequestTrace(FInFlightRequest& Entry, const FString& Model);
+	void NoteFirstByte(const IHttpRequest* Request);
+	static void EndRequestTrace(FInFlightRequest& Entry);
+
+	class UPlayKitMetrics* GetMetrics() const;
+	class UPlayKitTransport* GetTransport() const;
+
+private:
+	FPriorityQueue Queues[4];
+
+	TArray<FInFlightRequest> InFlight;
+	TMap<EPlayKitEndpoint, int32> InFlightPerEndpoint;
+
+	bool bIsPumping = false;
+
+	uint32 NextTraceId = 0;
+};
@@ -1,6 +1,7 @@
 // Copyright PlayKit. All Rights Reserved.
 
 #include "PlayKitSchemaLibrary.h"
+#include "PlayKitLog.h"
 #include "Dom/JsonObject.h"
 #include "Dom/JsonValue.h"
 #include "Serialization/JsonSerializer.h"
@@ -15,7 +16,7 @@ UPlayKitSchemaLibrary::UPlayKitSchemaLibrary()
 void UPlayKitSchemaLibrary::AddSchema(const FSchemaEntry& Entry)
 {
 	Schemas.Add(Entry.Name, Entry);
-	UE_LOG(LogTemp, Log, TEXT("[SchemaLibrary] Added schema: %s"), *Entry.Name);
+	UE_LOG(LogPlayKit, Log, TEXT("[SchemaLibrary] Added schema: %s"), *Entry.Name);
 }
 
 void UPlayKitSchemaLibrary::AddSchemaFromJson(const FString& Name, const FString& Description, const FString& SchemaJson)
@@ -66,7 +67,7 @@ bool UPlayKitSchemaLibrary::RemoveSchema(const FString& Name)
 	int32 Removed = Schemas.Remove(Name);
 	if (Removed > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[SchemaLibrary] Removed schema: %s"), *Name);
+		UE_LOG(LogPlayKit, Log, TEXT("[SchemaLibrary] Removed schema: %s"), *Name);
 	}
 	return Removed > 0;
 }
@@ -74,7 +75,7 @@ bool UPlayKitSchemaLibrary::RemoveSchema(const FString& Name)
 void UPlayKitSchemaLibrary::Clear()
 {
 	Schemas.Empty();
-	UE_LOG(LogTemp, Log, TEXT("[SchemaLibrary] Cleared all schemas"));
+	UE_LOG(LogPlayKit, Log, TEXT("[SchemaLibrary] Cleared all schemas"));
 }
 
 //========== Serialization ==========//
@@ -118,7 +119,7 @@ bool UPlayKitSchemaLibrary::FromJson(const FString& JsonString)
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[SchemaLibrary] Loaded %d schemas from JSON"), Schemas.Num());
+	UE_LOG(LogPlayKit, Log, TEXT("[SchemaLibrary] Loaded %d schemas from JSON"), Schemas.Num());
 	return true;
 }
 
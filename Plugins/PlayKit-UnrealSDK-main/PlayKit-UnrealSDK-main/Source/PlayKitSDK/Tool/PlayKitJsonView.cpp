@@ -0,0 +1,541 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitJsonView.h"
+
+namespace
+{
+	bool IsJsonWhitespace(uint8 Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
+	}
+
+	bool IsScalarTerminator(uint8 Char)
+	{
+		return Char == ',' || Char == '}' || Char == ']' || IsJsonWhitespace(Char);
+	}
+
+	int32 HexValue(uint8 Char)
+	{
+		if (Char >= '0' && Char <= '9') return Char - '0';
+		if (Char >= 'a' && Char <= 'f') return Char - 'a' + 10;
+		if (Char >= 'A' && Char <= 'F') return Char - 'A' + 10;
+		return -1;
+	}
+
+	bool ReadHex4(const uint8* Chars, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			const int32 Digit = HexValue(Chars[Index]);
+			if (Digit < 0)
+			{
+				return false;
+			}
+			OutValue = (OutValue << 4) | static_cast<uint32>(Digit);
+		}
+		return true;
+	}
+
+	template <typename AllocatorType>
+	void AppendUtf8(TArray<ANSICHAR, AllocatorType>& Out, uint32 CodePoint)
+	{
+		if (CodePoint < 0x80)
+		{
+			Out.Add(static_cast<ANSICHAR>(CodePoint));
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out.Add(static_cast<ANSICHAR>(0xC0 | (CodePoint >> 6)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out.Add(static_cast<ANSICHAR>(0xE0 | (CodePoint >> 12)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add(static_cast<ANSICHAR>(0xF0 | (CodePoint >> 18)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+
+	FString Utf8ToString(const uint8* Chars, int32 Length)
+	{
+		if (Length <= 0)
+		{
+			return FString();
+		}
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Chars), Length);
+		return FString(Converter.Length(), Converter.Get());
+	}
+
+	/** Decode the body of a JSON string (between the quotes) */
+	FString DecodeJsonString(const uint8* Chars, int32 Length)
+	{
+		// Fast path: nothing to unescape, convert straight from the buffer
+		if (FMemory::Memchr(Chars, '\\', Length) == nullptr)
+		{
+			return Utf8ToString(Chars, Length);
+		}
+
+		TArray<ANSICHAR, TInlineAllocator<512>> Utf8;
+		Utf8.Reserve(Length);
+
+		for (int32 Index = 0; Index < Length; ++Index)
+		{
+			const uint8 Char = Chars[Index];
+			if (Char != '\\' || Index + 1 >= Length)
+			{
+				Utf8.Add(static_cast<ANSICHAR>(Char));
+				continue;
+			}
+
+			const uint8 Escaped = Chars[++Index];
+			switch (Escaped)
+			{
+			case 'n': Utf8.Add('\n'); break;
+			case 'r': Utf8.Add('\r'); break;
+			case 't': Utf8.Add('\t'); break;
+			case 'b': Utf8.Add('\b'); break;
+			case 'f': Utf8.Add('\f'); break;
+			case 'u':
+				{
+					uint32 CodePoint = 0;
+					if (Index + 4 >= Length || !ReadHex4(Chars + Index + 1, CodePoint))
+					{
+						Utf8.Add('?');
+						break;
+					}
+					Index += 4;
+
+					// Surrogate pair written as two escapes
+					if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF)
+					{
+						uint32 Low = 0;
+						if (Index + 6 < Length && Chars[Index + 1] == '\\' && Chars[Index + 2] == 'u'
+							&& ReadHex4(Chars + Index + 3, Low) && Low >= 0xDC00 && Low <= 0xDFFF)
+						{
+							CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+							Index += 6;
+						}
+						else
+						{
+							CodePoint = 0xFFFD;
+						}
+					}
+					else if (CodePoint >= 0xDC00 && CodePoint <= 0xDFFF)
+					{
+						CodePoint = 0xFFFD;
+					}
+
+					AppendUtf8(Utf8, CodePoint);
+					break;
+				}
+			default:
+				// \" \\ \/ and anything unknown: keep the character itself
+				Utf8.Add(static_cast<ANSICHAR>(Escaped));
+				break;
+			}
+		}
+
+		return Utf8ToString(reinterpret_cast<const uint8*>(Utf8.GetData()), Utf8.Num());
+	}
+}
+
+//========== Construction ==========//
+
+FPlayKitJsonView FPlayKitJsonView::Parse(const uint8* Data, int32 Length)
+{
+	if (!Data || Length <= 0)
+	{
+		return FPlayKitJsonView();
+	}
+
+	FPlayKitJsonView Root(Data, 0, Length);
+
+	// Skip a UTF-8 byte order mark
+	if (Length >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Root.Start = 3;
+	}
+
+	Root.Start = Root.SkipWhitespace(Root.Start);
+	return Root;
+}
+
+//========== Type ==========//
+
+FPlayKitJsonView::EType FPlayKitJsonView::GetType() const
+{
+	if (!Data || Start >= Limit)
+	{
+		return EType::Invalid;
+	}
+
+	switch (Data[Start])
+	{
+	case '{': return EType::Object;
+	case '[': return EType::Array;
+	case '"': return EType::String;
+	case 't':
+	case 'f': return EType::Bool;
+	case 'n': return EType::Null;
+	case '-':
+	case '0': case '1': case '2': case '3': case '4':
+	case '5': case '6': case '7': case '8': case '9':
+		return EType::Number;
+	default:
+		return EType::Invalid;
+	}
+}
+
+//========== Navigation ==========//
+
+FPlayKitJsonView FPlayKitJsonView::Find(const ANSICHAR* Key) const
+{
+	if (!IsObject() || !Key)
+	{
+		return FPlayKitJsonView();
+	}
+
+	const int32 KeyLength = FCStringAnsi::Strlen(Key);
+	int32 Pos = SkipWhitespace(Start + 1);
+
+	while (Pos < Limit && Data[Pos] == '"')
+	{
+		const int32 KeyEnd = SkipString(Pos);
+		if (KeyEnd == INDEX_NONE)
+		{
+			break;
+		}
+
+		// Key body is [Pos + 1, KeyEnd - 1)
+		const bool bMatch = (KeyEnd - Pos - 2) == KeyLength && FMemory::Memcmp(Data + Pos + 1, Key, KeyLength) == 0;
+
+		Pos = SkipWhitespace(KeyEnd);
+		if (Pos >= Limit || Data[Pos] != ':')
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+
+		if (bMatch)
+		{
+			return FPlayKitJsonView(Data, Pos, Limit);
+		}
+
+		Pos = SkipValue(Pos);
+		if (Pos == INDEX_NONE)
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos);
+		if (Pos >= Limit || Data[Pos] != ',')
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+
+	return FPlayKitJsonView();
+}
+
+FPlayKitJsonView FPlayKitJsonView::At(int32 Index) const
+{
+	if (!IsArray() || Index < 0)
+	{
+		return FPlayKitJsonView();
+	}
+
+	int32 Pos = SkipWhitespace(Start + 1);
+	for (int32 Current = 0; Pos < Limit && Data[Pos] != ']'; ++Current)
+	{
+		if (Current == Index)
+		{
+			return FPlayKitJsonView(Data, Pos, Limit);
+		}
+
+		Pos = SkipValue(Pos);
+		if (Pos == INDEX_NONE)
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos);
+		if (Pos >= Limit || Data[Pos] != ',')
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+
+	return FPlayKitJsonView();
+}
+
+int32 FPlayKitJsonView::Num() const
+{
+	int32 Count = 0;
+	if (IsArray())
+	{
+		ForEachElement([&Count](const FPlayKitJsonView&) { ++Count; return true; });
+	}
+	else if (IsObject())
+	{
+		ForEachMember([&Count](const FString&, const FPlayKitJsonView&) { ++Count; return true; });
+	}
+	return Count;
+}
+
+void FPlayKitJsonView::ForEachElement(TFunctionRef<bool(const FPlayKitJsonView& Element)> Visitor) const
+{
+	if (!IsArray())
+	{
+		return;
+	}
+
+	int32 Pos = SkipWhitespace(Start + 1);
+	while (Pos < Limit && Data[Pos] != ']')
+	{
+		if (!Visitor(FPlayKitJsonView(Data, Pos, Limit)))
+		{
+			return;
+		}
+
+		Pos = SkipValue(Pos);
+		if (Pos == INDEX_NONE)
+		{
+			return;
+		}
+		Pos = SkipWhitespace(Pos);
+		if (Pos >= Limit || Data[Pos] != ',')
+		{
+			return;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+}
+
+void FPlayKitJsonView::ForEachMember(TFunctionRef<bool(const FString& Key, const FPlayKitJsonView& Value)> Visitor) const
+{
+	if (!IsObject())
+	{
+		return;
+	}
+
+	int32 Pos = SkipWhitespace(Start + 1);
+	while (Pos < Limit && Data[Pos] == '"')
+	{
+		const int32 KeyEnd = SkipString(Pos);
+		if (KeyEnd == INDEX_NONE)
+		{
+			return;
+		}
+		const FString Key = DecodeJsonString(Data + Pos + 1, KeyEnd - Pos - 2);
+
+		Pos = SkipWhitespace(KeyEnd);
+		if (Pos >= Limit || Data[Pos] != ':')
+		{
+			return;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+
+		if (!Visitor(Key, FPlayKitJsonView(Data, Pos, Limit)))
+		{
+			return;
+		}
+
+		Pos = SkipValue(Pos);
+		if (Pos == INDEX_NONE)
+		{
+			return;
+		}
+		Pos = SkipWhitespace(Pos);
+		if (Pos >= Limit || Data[Pos] != ',')
+		{
+			return;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+}
+
+//========== Values ==========//
+
+FString FPlayKitJsonView::AsString() const
+{
+	FString Result;
+	TryGetString(Result);
+	return Result;
+}
+
+bool FPlayKitJsonView::TryGetString(FString& OutValue) const
+{
+	if (!IsString())
+	{
+		return false;
+	}
+
+	const int32 End = SkipString(Start);
+	if (End == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutValue = DecodeJsonString(Data + Start + 1, End - Start - 2);
+	return true;
+}
+
+bool FPlayKitJsonView::StringEquals(const ANSICHAR* Text) const
+{
+	if (!IsString() || !Text)
+	{
+		return false;
+	}
+
+	const int32 TextLength = FCStringAnsi::Strlen(Text);
+	return Start + TextLength + 1 < Limit
+		&& FMemory::Memcmp(Data + Start + 1, Text, TextLength) == 0
+		&& Data[Start + TextLength + 1] == '"';
+}
+
+double FPlayKitJsonView::AsNumber(double DefaultValue) const
+{
+	if (!IsNumber())
+	{
+		return DefaultValue;
+	}
+
+	ANSICHAR Buffer[64];
+	int32 Length = 0;
+	for (int32 Pos = Start; Pos < Limit && !IsScalarTerminator(Data[Pos]) && Length < UE_ARRAY_COUNT(Buffer) - 1; ++Pos)
+	{
+		Buffer[Length++] = static_cast<ANSICHAR>(Data[Pos]);
+	}
+	Buffer[Length] = '\0';
+
+	return FCStringAnsi::Atod(Buffer);
+}
+
+int32 FPlayKitJsonView::AsInt(int32 DefaultValue) const
+{
+	return IsNumber() ? static_cast<int32>(AsNumber(DefaultValue)) : DefaultValue;
+}
+
+bool FPlayKitJsonView::AsBool(bool bDefaultValue) const
+{
+	if (GetType() != EType::Bool)
+	{
+		return bDefaultValue;
+	}
+	return Data[Start] == 't';
+}
+
+FString FPlayKitJsonView::ToValueString() const
+{
+	switch (GetType())
+	{
+	case EType::String:
+		return AsString();
+	case EType::Invalid:
+	case EType::Null:
+		return FString();
+	default:
+		return GetRawJson();
+	}
+}
+
+FString FPlayKitJsonView::GetRawJson() const
+{
+	const int32 End = GetEnd();
+	if (End == INDEX_NONE)
+	{
+		return FString();
+	}
+	return Utf8ToString(Data + Start, End - Start);
+}
+
+//========== Scanning ==========//
+
+int32 FPlayKitJsonView::SkipWhitespace(int32 Pos) const
+{
+	while (Pos < Limit && IsJsonWhitespace(Data[Pos]))
+	{
+		++Pos;
+	}
+	return Pos;
+}
+
+int32 FPlayKitJsonView::SkipString(int32 Pos) const
+{
+	// Pos is on the opening quote
+	for (++Pos; Pos < Limit; ++Pos)
+	{
+		if (Data[Pos] == '\\')
+		{
+			++Pos;
+		}
+		else if (Data[Pos] == '"')
+		{
+			return Pos + 1;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FPlayKitJsonView::SkipValue(int32 Pos) const
+{
+	if (!Data || Pos >= Limit)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint8 First = Data[Pos];
+
+	if (First == '"')
+	{
+		return SkipString(Pos);
+	}
+
+	if (First == '{' || First == '[')
+	{
+		// Containers only need bracket depth; strings are skipped whole so brackets inside them are ignored
+		int32 Depth = 0;
+		while (Pos < Limit)
+		{
+			const uint8 Char = Data[Pos];
+			if (Char == '"')
+			{
+				Pos = SkipString(Pos);
+				if (Pos == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+				continue;
+			}
+
+			if (Char == '{' || Char == '[')
+			{
+				++Depth;
+			}
+			else if (Char == '}' || Char == ']')
+			{
+				if (--Depth == 0)
+				{
+					return Pos + 1;
+				}
+			}
+			++Pos;
+		}
+		return INDEX_NONE;
+	}
+
+	// Number or literal
+	while (Pos < Limit && !IsScalarTerminator(Data[Pos]))
+	{
+		++Pos;
+	}
+	return Pos;
+}
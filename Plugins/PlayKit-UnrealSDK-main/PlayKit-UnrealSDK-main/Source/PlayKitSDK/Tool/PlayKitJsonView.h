@@ -0,0 +1,114 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Lazy, read-only view of a JSON value inside a UTF-8 buffer.
+ *
+ * Nothing is parsed up front. Find/At scan forward from the value's first byte
+ * and skip over everything that is not asked for, so the cost of reading a
+ * response scales with the fields used, not with the payload size. Only the
+ * final AsString/AsNumber calls allocate or convert.
+ *
+ * Usage:
+ *   const FPlayKitJsonView Root = FPlayKitJsonView::Parse(Response->GetContent());
+ *   const FString Content = Root.Find("choices").At(0).Find("message").Find("content").AsString();
+ *
+ * A lookup that fails returns an invalid view, and every accessor on an invalid
+ * view returns its default, so chains need no intermediate checks.
+ *
+ * The view does not own the buffer: it must outlive every view made from it.
+ * The input is not validated beyond what the requested path touches.
+ */
+class PLAYKITSDK_API FPlayKitJsonView
+{
+public:
+	enum class EType : uint8
+	{
+		Invalid,
+		Object,
+		Array,
+		String,
+		Number,
+		Bool,
+		Null
+	};
+
+	FPlayKitJsonView() = default;
+
+	/** View the root value of a UTF-8 JSON document */
+	static FPlayKitJsonView Parse(const uint8* Data, int32 Length);
+	static FPlayKitJsonView Parse(const TArray<uint8>& Data) { return Parse(Data.GetData(), Data.Num()); }
+
+	//========== Type ==========//
+
+	EType GetType() const;
+	bool IsValid() const { return GetType() != EType::Invalid; }
+	bool IsObject() const { return GetType() == EType::Object; }
+	bool IsArray() const { return GetType() == EType::Array; }
+	bool IsString() const { return GetType() == EType::String; }
+	bool IsNumber() const { return GetType() == EType::Number; }
+	bool IsNull() const { return GetType() == EType::Null; }
+
+	//========== Navigation ==========//
+
+	/** Member of an object. Keys are matched byte for byte and must not contain escapes */
+	FPlayKitJsonView Find(const ANSICHAR* Key) const;
+
+	/** Element of an array */
+	FPlayKitJsonView At(int32 Index) const;
+
+	/** Number of elements in an array, or members in an object */
+	int32 Num() const;
+
+	/** Visit array elements in order. Return false from the visitor to stop */
+	void ForEachElement(TFunctionRef<bool(const FPlayKitJsonView& Element)> Visitor) const;
+
+	/** Visit object members in order. Return false from the visitor to stop */
+	void ForEachMember(TFunctionRef<bool(const FString& Key, const FPlayKitJsonView& Value)> Visitor) const;
+
+	//========== Values ==========//
+
+	/** Decoded string value, or empty if this is not a string */
+	FString AsString() const;
+
+	/** Read a string value. Returns false (and leaves OutValue alone) if this is not a string */
+	bool TryGetString(FString& OutValue) const;
+
+	/** True if this is a string equal to the given ASCII text. Does not allocate */
+	bool StringEquals(const ANSICHAR* Text) const;
+
+	double AsNumber(double DefaultValue = 0.0) const;
+	int32 AsInt(int32 DefaultValue = 0) const;
+	bool AsBool(bool bDefaultValue = false) const;
+
+	/**
+	 * Loose string form, like FJsonValue::AsString: strings are decoded, numbers and
+	 * booleans keep their literal text, objects and arrays return their raw JSON
+	 */
+	FString ToValueString() const;
+
+	/** Raw JSON text of this value, exactly as it appears in the buffer */
+	FString GetRawJson() const;
+
+private:
+	FPlayKitJsonView(const uint8* InData, int32 InStart, int32 InLimit)
+		: Data(InData), Start(InStart), Limit(InLimit)
+	{
+	}
+
+	/** Position just past the value starting at Pos, or INDEX_NONE if it is truncated */
+	int32 SkipValue(int32 Pos) const;
+	int32 SkipString(int32 Pos) const;
+	int32 SkipWhitespace(int32 Pos) const;
+
+	/** End of this value (exclusive), or INDEX_NONE */
+	int32 GetEnd() const { return SkipValue(Start); }
+
+private:
+	const uint8* Data = nullptr;
+	int32 Start = 0;
+	int32 Limit = 0;
+};
@@ -0,0 +1,319 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitJsonWriter.h"
+
+namespace
+{
+	const ANSICHAR HexDigits[] = "0123456789abcdef";
+}
+
+FPlayKitJsonWriter::FPlayKitJsonWriter(int32 InitialCapacity)
+{
+	Buffer.Reserve(InitialCapacity);
+}
+
+//========== Structure ==========//
+
+void FPlayKitJsonWriter::BeginObject()
+{
+	BeginValue();
+	Buffer.Add('{');
+	HasElements.Add(false);
+}
+
+void FPlayKitJsonWriter::EndObject()
+{
+	Buffer.Add('}');
+	HasElements.Pop(EAllowShrinking::No);
+}
+
+void FPlayKitJsonWriter::BeginArray()
+{
+	BeginValue();
+	Buffer.Add('[');
+	HasElements.Add(false);
+}
+
+void FPlayKitJsonWriter::EndArray()
+{
+	Buffer.Add(']');
+	HasElements.Pop(EAllowShrinking::No);
+}
+
+void FPlayKitJsonWriter::WriteKey(const ANSICHAR* Key)
+{
+	BeginValue();
+	Buffer.Add('"');
+	AppendAscii(Key, FCStringAnsi::Strlen(Key));
+	Buffer.Add('"');
+	Buffer.Add(':');
+	bAfterKey = true;
+}
+
+//========== Values ==========//
+
+void FPlayKitJsonWriter::WriteString(FStringView Value)
+{
+	BeginValue();
+	Buffer.Add('"');
+	AppendEscaped(Value);
+	Buffer.Add('"');
+}
+
+void FPlayKitJsonWriter::WriteString(FUtf8StringView Value)
+{
+	BeginValue();
+	Buffer.Add('"');
+	AppendEscaped(Value);
+	Buffer.Add('"');
+}
+
+void FPlayKitJsonWriter::WriteBool(bool bValue)
+{
+	BeginValue();
+	if (bValue)
+	{
+		AppendAscii("true", 4);
+	}
+	else
+	{
+		AppendAscii("false", 5);
+	}
+}
+
+void FPlayKitJsonWriter::WriteInt(int64 Value)
+{
+	BeginValue();
+	ANSICHAR Digits[24];
+	const int32 Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%lld", static_cast<long long>(Value));
+	AppendAscii(Digits, Length);
+}
+
+void FPlayKitJsonWriter::WriteNumber(double Value)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		// JSON has no NaN/Infinity
+		WriteNull();
+		return;
+	}
+
+	BeginValue();
+	ANSICHAR Digits[32];
+	const int32 Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%.17g", Value);
+	AppendAscii(Digits, Length);
+}
+
+void FPlayKitJsonWriter::WriteNumber(float Value)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		WriteNull();
+		return;
+	}
+
+	BeginValue();
+	ANSICHAR Digits[32];
+	const int32 Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%.7g", static_cast<double>(Value));
+	AppendAscii(Digits, Length);
+}
+
+void FPlayKitJsonWriter::WriteNull()
+{
+	BeginValue();
+	AppendAscii("null", 4);
+}
+
+void FPlayKitJsonWriter::WriteRawValue(FStringView Json)
+{
+	BeginValue();
+	FTCHARToUTF8 Utf8(Json.GetData(), Json.Len());
+	Buffer.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+void FPlayKitJsonWriter::WriteRawValue(const ANSICHAR* Utf8Json, int32 Length)
+{
+	BeginValue();
+	Buffer.Append(reinterpret_cast<const uint8*>(Utf8Json), Length);
+}
+
+void FPlayKitJsonWriter::WriteMessage(FStringView Role, FStringView Content, FStringView ToolCallId)
+{
+	BeginObject();
+	WriteStringField("role", Role);
+	WriteStringField("content", Content);
+	if (!ToolCallId.IsEmpty())
+	{
+		WriteStringField("tool_call_id", ToolCallId);
+	}
+	EndObject();
+}
+
+void FPlayKitJsonWriter::WriteMessage(FStringView Role, FUtf8StringView Content)
+{
+	BeginObject();
+	WriteStringField("role", Role);
+	WriteStringField("content", Content);
+	EndObject();
+}
+
+//========== Output ==========//
+
+TArray<uint8> FPlayKitJsonWriter::Finish()
+{
+	HasElements.Reset();
+	bAfterKey = false;
+	return MoveTemp(Buffer);
+}
+
+FString FPlayKitJsonWriter::ToString() const
+{
+	FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Buffer.GetData()), Buffer.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+//========== Internals ==========//
+
+void FPlayKitJsonWriter::BeginValue()
+{
+	if (bAfterKey)
+	{
+		bAfterKey = false;
+		return;
+	}
+
+	if (HasElements.Num() > 0)
+	{
+		if (HasElements.Last())
+		{
+			Buffer.Add(',');
+		}
+		HasElements.Last() = true;
+	}
+}
+
+void FPlayKitJsonWriter::AppendAscii(const ANSICHAR* Text, int32 Length)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(Text), Length);
+}
+
+void FPlayKitJsonWriter::AppendEscaped(FStringView Value)
+{
+	const TCHAR* Chars = Value.GetData();
+	const int32 Length = Value.Len();
+
+	// Mostly ASCII in practice; grow once up front
+	Buffer.Reserve(Buffer.Num() + Length + 16);
+
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		uint32 CodePoint = static_cast<uint32>(Chars[Index]);
+
+		if (CodePoint < 0x80)
+		{
+			switch (CodePoint)
+			{
+			case '"':  Buffer.Add('\\'); Buffer.Add('"');  break;
+			case '\\': Buffer.Add('\\'); Buffer.Add('\\'); break;
+			case '\n': Buffer.Add('\\'); Buffer.Add('n');  break;
+			case '\r': Buffer.Add('\\'); Buffer.Add('r');  break;
+			case '\t': Buffer.Add('\\'); Buffer.Add('t');  break;
+			case '\b': Buffer.Add('\\'); Buffer.Add('b');  break;
+			case '\f': Buffer.Add('\\'); Buffer.Add('f');  break;
+			default:
+				if (CodePoint < 0x20)
+				{
+					const uint8 Escape[6] = { '\\', 'u', '0', '0', (uint8)HexDigits[CodePoint >> 4], (uint8)HexDigits[CodePoint & 0xF] };
+					Buffer.Append(Escape, 6);
+				}
+				else
+				{
+					Buffer.Add(static_cast<uint8>(CodePoint));
+				}
+				break;
+			}
+			continue;
+		}
+
+		// Combine UTF-16 surrogate pairs; a lone surrogate becomes U+FFFD
+		if (sizeof(TCHAR) == 2 && CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+		{
+			const bool bHighSurrogate = CodePoint <= 0xDBFF;
+			const uint32 Next = (Index + 1 < Length) ? static_cast<uint32>(Chars[Index + 1]) : 0;
+			if (bHighSurrogate && Next >= 0xDC00 && Next <= 0xDFFF)
+			{
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Next - 0xDC00);
+				++Index;
+			}
+			else
+			{
+				CodePoint = 0xFFFD;
+			}
+		}
+		else if (CodePoint > 0x10FFFF)
+		{
+			CodePoint = 0xFFFD;
+		}
+
+		if (CodePoint < 0x800)
+		{
+			Buffer.Add(static_cast<uint8>(0xC0 | (CodePoint >> 6)));
+			Buffer.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Buffer.Add(static_cast<uint8>(0xE0 | (CodePoint >> 12)));
+			Buffer.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Buffer.Add(static_cast<uint8>(0xF0 | (CodePoint >> 18)));
+			Buffer.Add(static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Buffer.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+}
+
+void FPlayKitJsonWriter::AppendEscaped(FUtf8StringView Value)
+{
+	const uint8* Bytes = reinterpret_cast<const uint8*>(Value.GetData());
+	const int32 Length = Value.Len();
+
+	Buffer.Reserve(Buffer.Num() + Length + 16);
+
+	// Multi-byte sequences never contain ASCII bytes, so only quotes, backslashes and
+	// control characters need escaping; copy the runs between them in one go
+	int32 RunStart = 0;
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const uint8 Byte = Bytes[Index];
+		if (Byte >= 0x20 && Byte != '"' && Byte != '\\')
+		{
+			continue;
+		}
+
+		Buffer.Append(Bytes + RunStart, Index - RunStart);
+		RunStart = Index + 1;
+
+		switch (Byte)
+		{
+		case '"':  Buffer.Add('\\'); Buffer.Add('"');  break;
+		case '\\': Buffer.Add('\\'); Buffer.Add('\\'); break;
+		case '\n': Buffer.Add('\\'); Buffer.Add('n');  break;
+		case '\r': Buffer.Add('\\'); Buffer.Add('r');  break;
+		case '\t': Buffer.Add('\\'); Buffer.Add('t');  break;
+		case '\b': Buffer.Add('\\'); Buffer.Add('b');  break;
+		case '\f': Buffer.Add('\\'); Buffer.Add('f');  break;
+		default:
+		{
+			const uint8 Escape[6] = { '\\', 'u', '0', '0', (uint8)HexDigits[Byte >> 4], (uint8)HexDigits[Byte & 0xF] };
+			Buffer.Append(Escape, 6);
+			break;
+		}
+		}
+	}
+
+	Buffer.Append(Bytes + RunStart, Length - RunStart);
+}
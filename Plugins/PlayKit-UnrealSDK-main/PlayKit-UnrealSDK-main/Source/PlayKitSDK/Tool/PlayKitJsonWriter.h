@@ -0,0 +1,97 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Forward-only JSON writer that emits UTF-8 straight into a byte buffer.
+ *
+ * Request bodies are built without a FJsonObject tree and without an
+ * intermediate FString, and the buffer is handed to IHttpRequest::SetContent
+ * as-is. Strings are escaped and transcoded from TCHAR in a single pass.
+ *
+ * Usage:
+ *   FPlayKitJsonWriter Json;
+ *   Json.BeginObject();
+ *   Json.WriteStringField("model", Model);
+ *   Json.WriteKey("messages");
+ *   Json.BeginArray();
+ *   Json.WriteMessage(TEXT("user"), Prompt);
+ *   Json.EndArray();
+ *   Json.EndObject();
+ *   Request->SetContent(Json.Finish());
+ *
+ * Keys are expected to be ASCII literals and are written without escaping.
+ * The writer does not validate structure; callers must balance Begin/End.
+ */
+class PLAYKITSDK_API FPlayKitJsonWriter
+{
+public:
+	explicit FPlayKitJsonWriter(int32 InitialCapacity = 1024);
+
+	//========== Structure ==========//
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+
+	/** Write an object key. The next write is its value */
+	void WriteKey(const ANSICHAR* Key);
+
+	//========== Values ==========//
+
+	void WriteString(FStringView Value);
+	/** Write a string that is already UTF-8; it is only escaped, not transcoded */
+	void WriteString(FUtf8StringView Value);
+	void WriteBool(bool bValue);
+	void WriteInt(int64 Value);
+	void WriteNumber(double Value);
+	/** Floats are written with float precision, so 0.7f stays "0.7" */
+	void WriteNumber(float Value);
+	void WriteNull();
+
+	/** Write an already serialized JSON value (e.g. a schema) without re-encoding it */
+	void WriteRawValue(FStringView Json);
+	void WriteRawValue(const ANSICHAR* Utf8Json, int32 Length);
+
+	//========== Fields ==========//
+
+	void WriteStringField(const ANSICHAR* Key, FStringView Value) { WriteKey(Key); WriteString(Value); }
+	void WriteStringField(const ANSICHAR* Key, FUtf8StringView Value) { WriteKey(Key); WriteString(Value); }
+	void WriteBoolField(const ANSICHAR* Key, bool bValue) { WriteKey(Key); WriteBool(bValue); }
+	void WriteIntField(const ANSICHAR* Key, int64 Value) { WriteKey(Key); WriteInt(Value); }
+	void WriteNumberField(const ANSICHAR* Key, double Value) { WriteKey(Key); WriteNumber(Value); }
+	void WriteNumberField(const ANSICHAR* Key, float Value) { WriteKey(Key); WriteNumber(Value); }
+
+	/** Write a chat message object: {"role": ..., "content": ...[, "tool_call_id": ...]} */
+	void WriteMessage(FStringView Role, FStringView Content, FStringView ToolCallId = FStringView());
+	void WriteMessage(FStringView Role, FUtf8StringView Content);
+
+	//========== Output ==========//
+
+	/** The bytes written so far */
+	const TArray<uint8>& GetBuffer() const { return Buffer; }
+
+	/** Hand over the buffer. The writer is empty afterwards */
+	TArray<uint8> Finish();
+
+	/** Decode the buffer for logging. Allocates; keep out of hot paths */
+	FString ToString() const;
+
+private:
+	void BeginValue();
+	void AppendAscii(const ANSICHAR* Text, int32 Length);
+	void AppendEscaped(FStringView Value);
+	void AppendEscaped(FUtf8StringView Value);
+
+private:
+	TArray<uint8> Buffer;
+
+	// One entry per open container: true once it holds at least one element
+	TArray<bool, TInlineAllocator<16>> HasElements;
+
+	// The last token was a key, so the next value needs no comma
+	bool bAfterKey = false;
+};
@@ -0,0 +1,292 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitPartialJson.h"
+
+namespace
+{
+	bool IsScalarChar(TCHAR C)
+	{
+		return FChar::IsAlnum(C) || C == TEXT('-') || C == TEXT('+') || C == TEXT('.');
+	}
+
+	int32 HexValue(TCHAR C)
+	{
+		if (C >= TEXT('0') && C <= TEXT('9')) return C - TEXT('0');
+		if (C >= TEXT('a') && C <= TEXT('f')) return C - TEXT('a') + 10;
+		if (C >= TEXT('A') && C <= TEXT('F')) return C - TEXT('A') + 10;
+		return INDEX_NONE;
+	}
+}
+
+FString FPlayKitPartialJsonField::GetValueString() const
+{
+	if (RawJson.Len() >= 2 && RawJson[0] == TEXT('"'))
+	{
+		return FPlayKitPartialJson::DecodeString(RawJson);
+	}
+	return RawJson;
+}
+
+void FPlayKitPartialJson::Append(FStringView Chunk)
+{
+	if (Chunk.IsEmpty() || bComplete)
+	{
+		return;
+	}
+
+	Buffer.Append(Chunk.GetData(), Chunk.Len());
+	Scan();
+}
+
+void FPlayKitPartialJson::Reset()
+{
+	*this = FPlayKitPartialJson();
+}
+
+void FPlayKitPartialJson::ConsumeCompletedFields(TArray<FPlayKitPartialJsonField>& OutFields)
+{
+	OutFields.Append(MoveTemp(CompletedFields));
+	CompletedFields.Reset();
+}
+
+FString FPlayKitPartialJson::GetCompletedJson() const
+{
+	return bComplete ? Buffer.Mid(RootStart, RootEnd - RootStart) : FString();
+}
+
+FString FPlayKitPartialJson::GetRepairedJson() const
+{
+	if (!HasStarted())
+	{
+		return FString();
+	}
+
+	if (bComplete)
+	{
+		return GetCompletedJson();
+	}
+
+	FString Out;
+	if (bInString && !bStringIsKey)
+	{
+		// Keep the partial string value, minus an escape sequence that is cut in half
+		const int32 End = EscapeRemaining > 0 ? EscapeStart : Buffer.Len();
+		Out.Reserve(End - RootStart + Stack.Num() + 1);
+		Out.Append(*Buffer + RootStart, End - RootStart);
+		Out.AppendChar(TEXT('"'));
+	}
+	else
+	{
+		// Drop a dangling comma, key or unfinished number/literal
+		Out.Reserve(SafeEnd - RootStart + Stack.Num());
+		Out.Append(*Buffer + RootStart, SafeEnd - RootStart);
+	}
+
+	for (int32 Index = Stack.Num() - 1; Index >= 0; --Index)
+	{
+		Out.AppendChar(Stack[Index].Open == TEXT('{') ? TEXT('}') : TEXT(']'));
+	}
+	return Out;
+}
+
+//========== Scanning ==========//
+
+void FPlayKitPartialJson::Scan()
+{
+	const TCHAR* Chars = *Buffer;
+	const int32 Length = Buffer.Len();
+
+	for (; ScanPos < Length && !bComplete; ++ScanPos)
+	{
+		const int32 Index = ScanPos;
+		const TCHAR C = Chars[Index];
+
+		if (RootStart == INDEX_NONE)
+		{
+			// Skip preamble such as a markdown fence
+			if (C == TEXT('{') || C == TEXT('['))
+			{
+				RootStart = Index;
+				Stack.Add({ C, C == TEXT('{') });
+				SafeEnd = Index + 1;
+			}
+			continue;
+		}
+
+		if (bInString)
+		{
+			if (EscapeRemaining > 0)
+			{
+				EscapeRemaining = (Index == EscapeStart + 1 && C == TEXT('u')) ? 4 : EscapeRemaining - 1;
+			}
+			else if (C == TEXT('\\'))
+			{
+				EscapeStart = Index;
+				EscapeRemaining = 1;
+			}
+			else if (C == TEXT('"'))
+			{
+				bInString = false;
+				if (!bStringIsKey)
+				{
+					EndValue(Index + 1);
+				}
+				else if (IsInRootObject())
+				{
+					CurrentKey = DecodeString(FStringView(Chars + StringStart, Index + 1 - StringStart));
+				}
+			}
+			continue;
+		}
+
+		if (ScalarStart != INDEX_NONE)
+		{
+			if (IsScalarChar(C))
+			{
+				continue;
+			}
+			ScalarStart = INDEX_NONE;
+			EndValue(Index);
+			// Fall through to handle the delimiter
+		}
+
+		FFrame& Top = Stack.Last();
+		switch (C)
+		{
+		case TEXT('"'):
+			bInString = true;
+			StringStart = Index;
+			bStringIsKey = Top.Open == TEXT('{') && Top.bExpectKey;
+			if (!bStringIsKey)
+			{
+				BeginValue(Index);
+			}
+			break;
+
+		case TEXT(':'):
+			Top.bExpectKey = false;
+			break;
+
+		case TEXT(','):
+			if (Top.Open == TEXT('{'))
+			{
+				Top.bExpectKey = true;
+			}
+			break;
+
+		case TEXT('{'):
+		case TEXT('['):
+			BeginValue(Index);
+			Stack.Add({ C, C == TEXT('{') });
+			SafeEnd = Index + 1;
+			break;
+
+		case TEXT('}'):
+		case TEXT(']'):
+			Stack.Pop(EAllowShrinking::No);
+			if (Stack.Num() == 0)
+			{
+				RootEnd = Index + 1;
+				SafeEnd = RootEnd;
+				bComplete = true;
+			}
+			else
+			{
+				EndValue(Index + 1);
+			}
+			break;
+
+		default:
+			if (!FChar::IsWhitespace(C))
+			{
+				BeginValue(Index);
+				ScalarStart = Index;
+			}
+			break;
+		}
+	}
+}
+
+void FPlayKitPartialJson::BeginValue(int32 Position)
+{
+	if (IsInRootObject())
+	{
+		ValueStart = Position;
+	}
+}
+
+void FPlayKitPartialJson::EndValue(int32 End)
+{
+	SafeEnd = End;
+
+	if (IsInRootObject() && ValueStart != INDEX_NONE)
+	{
+		FPlayKitPartialJsonField& Field = CompletedFields.AddDefaulted_GetRef();
+		Field.Key = CurrentKey;
+		Field.RawJson = Buffer.Mid(ValueStart, End - ValueStart);
+		ValueStart = INDEX_NONE;
+	}
+}
+
+//========== Strings ==========//
+
+FString FPlayKitPartialJson::DecodeString(FStringView Quoted)
+{
+	if (Quoted.Len() >= 2 && Quoted[0] == TEXT('"') && Quoted[Quoted.Len() - 1] == TEXT('"'))
+	{
+		Quoted = Quoted.Mid(1, Quoted.Len() - 2);
+	}
+
+	int32 Backslash = INDEX_NONE;
+	if (!Quoted.FindChar(TEXT('\\'), Backslash))
+	{
+		return FString(Quoted);
+	}
+
+	FString Out;
+	Out.Reserve(Quoted.Len());
+	Out.Append(Quoted.GetData(), Backslash);
+
+	for (int32 Index = Backslash; Index < Quoted.Len(); ++Index)
+	{
+		const TCHAR C = Quoted[Index];
+		if (C != TEXT('\\') || Index + 1 >= Quoted.Len())
+		{
+			Out.AppendChar(C);
+			continue;
+		}
+
+		const TCHAR Escaped = Quoted[++Index];
+		switch (Escaped)
+		{
+		case TEXT('n'): Out.AppendChar(TEXT('\n')); break;
+		case TEXT('r'): Out.AppendChar(TEXT('\r')); break;
+		case TEXT('t'): Out.AppendChar(TEXT('\t')); break;
+		case TEXT('b'): Out.AppendChar(TEXT('\b')); break;
+		case TEXT('f'): Out.AppendChar(TEXT('\f')); break;
+		case TEXT('u'):
+			{
+				uint32 CodeUnit = 0;
+				int32 Digit = 0;
+				for (; Digit < 4 && Index + 1 < Quoted.Len(); ++Digit)
+				{
+					const int32 Value = HexValue(Quoted[Index + 1]);
+					if (Value == INDEX_NONE)
+					{
+						break;
+					}
+					CodeUnit = (CodeUnit << 4) | Value;
+					++Index;
+				}
+				// Surrogate pairs pass through as two UTF-16 code units
+				Out.AppendChar(Digit == 4 ? static_cast<TCHAR>(CodeUnit) : static_cast<TCHAR>(0xFFFD));
+				break;
+			}
+		default:
+			// \" \\ \/
+			Out.AppendChar(Escaped);
+			break;
+		}
+	}
+	return Out;
+}
@@ -0,0 +1,108 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A top-level field of a streamed object, completed
+ */
+struct PLAYKITSDK_API FPlayKitPartialJsonField
+{
+	FString Key;
+
+	/** The field's value as raw JSON text */
+	FString RawJson;
+
+	/** Loose string form: strings are unquoted and unescaped, anything else stays raw JSON */
+	FString GetValueString() const;
+};
+
+/**
+ * Tolerant, incremental JSON parser for structured output that arrives in pieces.
+ *
+ * Text is appended as it streams in and is scanned once; state carries over
+ * between Append calls, so each chunk costs only its own length. The parser
+ * reports every top-level field of the root object as soon as its value is
+ * closed, and can produce a repaired snapshot of the document so far, with
+ * the open string, arrays and objects closed and any dangling key or
+ * unfinished literal dropped.
+ *
+ * Usage:
+ *   Parser.Append(Delta);
+ *   TArray<FPlayKitPartialJsonField> Fields;
+ *   Parser.ConsumeCompletedFields(Fields);   // e.g. "npc_text" while "options" is still generating
+ *   const FString Snapshot = Parser.GetRepairedJson();
+ *
+ * Anything before the first '{' or '[' (such as a ```json fence) and after the
+ * root value is closed is ignored. Input is not otherwise validated.
+ */
+class PLAYKITSDK_API FPlayKitPartialJson
+{
+public:
+	/** Append more text and scan it */
+	void Append(FStringView Chunk);
+
+	/** Start over with an empty document */
+	void Reset();
+
+	/** True once the root value has been closed */
+	bool IsComplete() const { return bComplete; }
+
+	/** True once the root value has started */
+	bool HasStarted() const { return RootStart != INDEX_NONE; }
+
+	/** Move out the top-level fields completed since the last call, in document order */
+	void ConsumeCompletedFields(TArray<FPlayKitPartialJsonField>& OutFields);
+
+	/** The document so far, closed up into valid JSON. Empty if nothing has started */
+	FString GetRepairedJson() const;
+
+	/** The root value once complete, otherwise empty */
+	FString GetCompletedJson() const;
+
+	/** Unquote and unescape a JSON string literal */
+	static FString DecodeString(FStringView Quoted);
+
+private:
+	void Scan();
+	void BeginValue(int32 Position);
+	void EndValue(int32 End);
+	bool IsInRootObject() const { return Stack.Num() == 1 && Stack[0].Open == TEXT('{'); }
+
+private:
+	struct FFrame
+	{
+		TCHAR Open;
+		bool bExpectKey;
+	};
+
+	FString Buffer;
+	int32 ScanPos = 0;
+
+	int32 RootStart = INDEX_NONE;
+	int32 RootEnd = INDEX_NONE;
+	bool bComplete = false;
+
+	// Open containers, innermost last
+	TArray<FFrame, TInlineAllocator<16>> Stack;
+
+	// String in progress
+	bool bInString = false;
+	bool bStringIsKey = false;
+	int32 StringStart = INDEX_NONE;
+	int32 EscapeStart = INDEX_NONE;
+	int32 EscapeRemaining = 0;
+
+	// Number or literal in progress; its end is only known at the next delimiter
+	int32 ScalarStart = INDEX_NONE;
+
+	// Length of the longest prefix that is valid once the open containers are closed
+	int32 SafeEnd = 0;
+
+	// Root-object field being read
+	FString CurrentKey;
+	int32 ValueStart = INDEX_NONE;
+
+	TArray<FPlayKitPartialJsonField> CompletedFields;
+};
@@ -0,0 +1,196 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitSSEDecoder.h"
+
+namespace
+{
+	bool LineStartsWith(const uint8* Line, int32 LineLength, const ANSICHAR* Prefix, int32 PrefixLength)
+	{
+		return LineLength >= PrefixLength && FMemory::Memcmp(Line, Prefix, PrefixLength) == 0;
+	}
+}
+
+//========== FPlayKitSSEEvent ==========//
+
+FString FPlayKitSSEEvent::GetDataAsString() const
+{
+	if (Data.Num() == 0)
+	{
+		return FString();
+	}
+
+	FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data.GetData()), Data.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+bool FPlayKitSSEEvent::IsDone() const
+{
+	return Data.Num() == 6 && FMemory::Memcmp(Data.GetData(), "[DONE]", 6) == 0;
+}
+
+//========== FPlayKitSSEDecoder ==========//
+
+void FPlayKitSSEDecoder::ConsumeResponse(const TArray<uint8>& Content, TArray<FPlayKitSSEEvent>& OutEvents)
+{
+	const int64 Available = Content.Num();
+	if (Available <= ConsumedBytes)
+	{
+		return;
+	}
+
+	Feed(Content.GetData() + ConsumedBytes, static_cast<int32>(Available - ConsumedBytes), OutEvents);
+}
+
+void FPlayKitSSEDecoder::Feed(const uint8* Bytes, int32 NumBytes, TArray<FPlayKitSSEEvent>& OutEvents)
+{
+	if (!Bytes || NumBytes <= 0)
+	{
+		return;
+	}
+
+	int32 Cursor = 0;
+
+	// Skip the UTF-8 byte order mark at the very start of the stream
+	if (ConsumedBytes == 0 && NumBytes >= 3 && Bytes[0] == 0xEF && Bytes[1] == 0xBB && Bytes[2] == 0xBF)
+	{
+		Cursor = 3;
+	}
+
+	ConsumedBytes += NumBytes;
+
+	if (bSkipNextLineFeed && Cursor < NumBytes)
+	{
+		if (Bytes[Cursor] == '\n')
+		{
+			Cursor++;
+		}
+		bSkipNextLineFeed = false;
+	}
+
+	while (Cursor < NumBytes)
+	{
+		// Find the next line terminator (CRLF, LF or CR)
+		int32 LineEnd = Cursor;
+		while (LineEnd < NumBytes && Bytes[LineEnd] != '\n' && Bytes[LineEnd] != '\r')
+		{
+			LineEnd++;
+		}
+
+		if (LineEnd == NumBytes)
+		{
+			// Incomplete line - keep it until the rest arrives
+			PendingLine.Append(Bytes + Cursor, NumBytes - Cursor);
+			break;
+		}
+
+		if (PendingLine.Num() > 0)
+		{
+			PendingLine.Append(Bytes + Cursor, LineEnd - Cursor);
+			ProcessLine(PendingLine.GetData(), PendingLine.Num(), OutEvents);
+			PendingLine.Reset();
+		}
+		else
+		{
+			ProcessLine(Bytes + Cursor, LineEnd - Cursor, OutEvents);
+		}
+
+		Cursor = LineEnd + 1;
+		if (Bytes[LineEnd] == '\r')
+		{
+			if (Cursor < NumBytes)
+			{
+				if (Bytes[Cursor] == '\n')
+				{
+					Cursor++;
+				}
+			}
+			else
+			{
+				bSkipNextLineFeed = true;
+			}
+		}
+	}
+}
+
+void FPlayKitSSEDecoder::Finish(TArray<FPlayKitSSEEvent>& OutEvents)
+{
+	if (PendingLine.Num() > 0)
+	{
+		ProcessLine(PendingLine.GetData(), PendingLine.Num(), OutEvents);
+		PendingLine.Reset();
+	}
+
+	DispatchEvent(OutEvents);
+}
+
+void FPlayKitSSEDecoder::Reset()
+{
+	PendingLine.Reset();
+	PendingData.Reset();
+	PendingEventType.Empty();
+	bHasPendingData = false;
+	bSkipNextLineFeed = false;
+	ConsumedBytes = 0;
+}
+
+void FPlayKitSSEDecoder::ProcessLine(const uint8* Line, int32 LineLength, TArray<FPlayKitSSEEvent>& OutEvents)
+{
+	// Blank line terminates the current event
+	if (LineLength == 0)
+	{
+		DispatchEvent(OutEvents);
+		return;
+	}
+
+	// Comment line (often used as keep-alive)
+	if (Line[0] == ':')
+	{
+		return;
+	}
+
+	// Split "field: value" - one optional space after the colon is part of the separator
+	int32 Colon = 0;
+	while (Colon < LineLength && Line[Colon] != ':')
+	{
+		Colon++;
+	}
+
+	const int32 FieldLength = Colon;
+	int32 ValueStart = FMath::Min(Colon + 1, LineLength);
+	if (ValueStart < LineLength && Line[ValueStart] == ' ')
+	{
+		ValueStart++;
+	}
+	const uint8* Value = Line + ValueStart;
+	const int32 ValueLength = LineLength - ValueStart;
+
+	if (FieldLength == 4 && LineStartsWith(Line, LineLength, "data", 4))
+	{
+		if (bHasPendingData)
+		{
+			PendingData.Add('\n');
+		}
+		PendingData.Append(Value, ValueLength);
+		bHasPendingData = true;
+	}
+	else if (FieldLength == 5 && LineStartsWith(Line, LineLength, "event", 5))
+	{
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Value), ValueLength);
+		PendingEventType = FString(Converter.Length(), Converter.Get());
+	}
+	// "id" and "retry" are not used by the PlayKit API
+}
+
+void FPlayKitSSEDecoder::DispatchEvent(TArray<FPlayKitSSEEvent>& OutEvents)
+{
+	if (bHasPendingData)
+	{
+		FPlayKitSSEEvent& Event = OutEvents.AddDefaulted_GetRef();
+		Event.EventType = MoveTemp(PendingEventType);
+		Event.Data = MoveTemp(PendingData);
+	}
+
+	PendingData.Reset();
+	PendingEventType.Empty();
+	bHasPendingData = false;
+}
@@ -0,0 +1,79 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A single decoded Server-Sent Event
+ */
+struct PLAYKITSDK_API FPlayKitSSEEvent
+{
+	/** Value of the "event:" field (empty for the default "message" event) */
+	FString EventType;
+
+	/** Payload as raw UTF-8 bytes. Multiple "data:" lines are joined with '\n' */
+	TArray<uint8> Data;
+
+	/** Convert the payload to a string */
+	FString GetDataAsString() const;
+
+	/** True for the OpenAI-style "[DONE]" terminator */
+	bool IsDone() const;
+};
+
+/**
+ * Incremental Server-Sent Events decoder.
+ *
+ * Consumes raw response bytes as they arrive and emits only complete events.
+ * Partial lines are kept between calls, so an event split across two progress
+ * ticks is never dropped. Lines are only converted once complete, and line
+ * terminators are ASCII, so multi-byte UTF-8 sequences are never cut in half.
+ *
+ * Usage (from an HTTP progress callback):
+ *   TArray<FPlayKitSSEEvent> Events;
+ *   Decoder.ConsumeResponse(Response->GetContent(), Events);
+ *
+ * Each byte is scanned exactly once, so cost per tick is proportional to the
+ * new data only, no matter how long the stream gets.
+ */
+class PLAYKITSDK_API FPlayKitSSEDecoder
+{
+public:
+	/**
+	 * Decode the bytes of a growing response body that have not been seen yet.
+	 * @param Content The full body received so far
+	 * @param OutEvents Completed events are appended here
+	 */
+	void ConsumeResponse(const TArray<uint8>& Content, TArray<FPlayKitSSEEvent>& OutEvents);
+
+	/** Decode a chunk of new bytes */
+	void Feed(const uint8* Bytes, int32 NumBytes, TArray<FPlayKitSSEEvent>& OutEvents);
+
+	/** Flush a trailing event that was not terminated by a blank line (call once the stream ends) */
+	void Finish(TArray<FPlayKitSSEEvent>& OutEvents);
+
+	/** Reset all state so the decoder can be reused for a new stream */
+	void Reset();
+
+	/** Number of response bytes consumed so far */
+	int64 GetBytesConsumed() const { return ConsumedBytes; }
+
+private:
+	void ProcessLine(const uint8* Line, int32 LineLength, TArray<FPlayKitSSEEvent>& OutEvents);
+	void DispatchEvent(TArray<FPlayKitSSEEvent>& OutEvents);
+
+private:
+	// Bytes of a line whose terminator has not arrived yet
+	TArray<uint8> PendingLine;
+
+	// Event being assembled
+	TArray<uint8> PendingData;
+	FString PendingEventType;
+	bool bHasPendingData = false;
+
+	// A chunk ended on '\r'; skip a leading '\n' in the next chunk
+	bool bSkipNextLineFeed = false;
+
+	int64 ConsumedBytes = 0;
+};
@@ -0,0 +1,74 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitTokenEstimator.h"
+
+namespace PlayKitTokenEstimator
+{
+	template <typename CharType>
+	int32 EstimateTokens(TStringView<CharType> Text)
+	{
+		int32 Tokens = 0;
+		int32 LetterRun = 0;
+		int32 DigitRun = 0;
+
+		auto FlushRuns = [&Tokens, &LetterRun, &DigitRun]()
+		{
+			Tokens += FMath::DivideAndRoundUp(LetterRun, 5) + FMath::DivideAndRoundUp(DigitRun, 3);
+			LetterRun = 0;
+			DigitRun = 0;
+		};
+
+		for (const CharType Char : Text)
+		{
+			const uint32 Code = static_cast<uint32>(Char);
+			if ((Code >= 'a' && Code <= 'z') || (Code >= 'A' && Code <= 'Z'))
+			{
+				if (DigitRun > 0)
+				{
+					FlushRuns();
+				}
+				++LetterRun;
+			}
+			else if (Code >= '0' && Code <= '9')
+			{
+				if (LetterRun > 0)
+				{
+					FlushRuns();
+				}
+				++DigitRun;
+			}
+			else
+			{
+				// UTF-8 continuation bytes belong to the character their lead byte already counted
+				if constexpr (sizeof(CharType) == 1)
+				{
+					if ((Code & 0xC0) == 0x80)
+					{
+						continue;
+					}
+				}
+
+				FlushRuns();
+
+				// Spaces merge into the next word; other whitespace, symbols and non-ASCII stand alone
+				if (Code != ' ')
+				{
+					++Tokens;
+				}
+			}
+		}
+
+		FlushRuns();
+		return Tokens;
+	}
+}
+
+int32 FPlayKitTokenEstimator::EstimateTokens(FStringView Text)
+{
+	return PlayKitTokenEstimator::EstimateTokens(Text);
+}
+
+int32 FPlayKitTokenEstimator::EstimateTokens(FUtf8StringView Text)
+{
+	return PlayKitTokenEstimator::EstimateTokens(Text);
+}
@@ -0,0 +1,33 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fast local token count estimate for prompt budgeting.
+ *
+ * Approximates a BPE tokenizer of the cl100k/o200k family in one pass without a vocabulary:
+ * - a run of ASCII letters is one token per started 5 characters ("the", "wanders" = 1, "unbelievable" = 3)
+ * - digits go in groups of up to 3
+ * - each other ASCII symbol is one token; spaces attach to the following word and are free
+ * - each non-ASCII character is one token (CJK text tokenizes close to that)
+ *
+ * Typically within 10-15% of the real count for English prose, and erring high on code and
+ * unusual text, which is the safe side for a budget. Use the server's usage numbers where exact
+ * counts matter.
+ */
+class PLAYKITSDK_API FPlayKitTokenEstimator
+{
+public:
+	/** Tokens a chat message costs beyond its content (role and delimiters) */
+	static constexpr int32 MessageOverhead = 4;
+
+	/** Estimated tokens in a piece of text */
+	static int32 EstimateTokens(FStringView Text);
+	static int32 EstimateTokens(FUtf8StringView Text);
+
+	/** Estimated tokens one chat message adds to a request */
+	static int32 EstimateMessageTokens(FStringView Content) { return EstimateTokens(Content) + MessageOverhead; }
+	static int32 EstimateMessageTokens(FUtf8StringView Content) { return EstimateTokens(Content) + MessageOverhead; }
+};
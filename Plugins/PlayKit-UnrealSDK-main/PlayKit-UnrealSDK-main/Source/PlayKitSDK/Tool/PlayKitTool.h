@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "PlayKitLog.h"
 #include "Engine/Texture2D.h"
 #include "Misc/Base64.h"
 #include "ImageUtils.h"
@@ -27,7 +28,7 @@ public:
 	{
 		if (!JsonObject.IsValid())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("JsonObjectToString: Invalid JSON object"));
+			UE_LOG(LogPlayKit, Warning, TEXT("JsonObjectToString: Invalid JSON object"));
 			return FString();
 		}
 
@@ -57,7 +58,7 @@ public:
 		{
 			if (bLogErrors)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("StringToJsonObject: Input string is empty"));
+				UE_LOG(LogPlayKit, Warning, TEXT("StringToJsonObject: Input string is empty"));
 			}
 			return false;
 		}
@@ -72,7 +73,7 @@ public:
 		{
 			if (bLogErrors)
 			{
-				UE_LOG(LogTemp, Error, TEXT("StringToJsonObject: Failed to parse JSON string: %s"), *JsonString);
+				UE_LOG(LogPlayKit, Error, TEXT("StringToJsonObject: Failed to parse JSON string: %s"), *JsonString);
 			}
 			return false;
 		}
@@ -89,7 +90,7 @@ public:
 		// Decode Base64 string to binary data
 		if (!FBase64::Decode(Base64String, RawData))
 		{
-			UE_LOG(LogTemp, Error, TEXT("Failed to decode Base64 string"));
+			UE_LOG(LogPlayKit, Error, TEXT("Failed to decode Base64 string"));
 			return nullptr;
 		}
 
@@ -98,7 +99,7 @@ public:
 
 		if (!Texture2D)
 		{
-			UE_LOG(LogTemp, Error, TEXT("Failed to create texture from binary data"));
+			UE_LOG(LogPlayKit, Error, TEXT("Failed to create texture from binary data"));
 		}
 
 		return Texture2D;
@@ -0,0 +1,651 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#include "PlayKitTransport.h"
+#include "PlayKitLog.h"
+#include "PlayKitSettings.h"
+#include "Tool/PlayKitJsonWriter.h"
+#include "Tool/PlayKitJsonView.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Containers/Ticker.h"
+#include "Misc/Base64.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+
+namespace
+{
+	const int32 CassetteVersion = 1;
+
+	FString BytesToText(const TArray<uint8>& Bytes)
+	{
+		FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+		return FString(Text.Length(), Text.Get());
+	}
+
+	void AppendText(TArray<uint8>& Out, const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text, Text.Len());
+		Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	/** True if Text converts back to exactly Bytes, i.e. the bytes were valid UTF-8 */
+	bool RoundTrips(const TArray<uint8>& Bytes, const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text, Text.Len());
+		return Utf8.Length() == Bytes.Num() && FMemory::Memcmp(Utf8.Get(), Bytes.GetData(), Bytes.Num()) == 0;
+	}
+
+	/**
+	 * Response served from a cassette. Its content grows as the recorded chunks come due
+	 */
+	class FPlayKitReplayResponse final : public IHttpResponse
+	{
+	public:
+		FPlayKitReplayResponse(const FString& InUrl, const FPlayKitCassetteEntry& Entry)
+			: Url(InUrl)
+			, ResponseCode(Entry.ResponseCode)
+			, ContentType(Entry.ContentType)
+		{
+			Content.Reserve(Entry.ResponseBody.Num());
+		}
+
+		//~ IHttpBase
+		virtual const FString& GetURL() const override { return Url; }
+		virtual FString GetURLParameter(const FString& ParameterName) const override { return FString(); }
+		virtual FString GetHeader(const FString& HeaderName) const override
+		{
+			return HeaderName.Equals(TEXT("Content-Type"), ESearchCase::IgnoreCase) ? ContentType : FString();
+		}
+		virtual TArray<FString> GetAllHeaders() const override { return { TEXT("Content-Type: ") + ContentType }; }
+		virtual FString GetContentType() const override { return ContentType; }
+		virtual uint64 GetContentLength() const override { return Content.Num(); }
+		virtual const FString& GetEffectiveURL() const override { return Url; }
+		virtual EHttpRequestStatus::Type GetStatus() const override { return Status; }
+		virtual EHttpFailureReason GetFailureReason() const override { return EHttpFailureReason::None; }
+
+		//~ IHttpResponse
+		virtual int32 GetResponseCode() const override { return ResponseCode; }
+		virtual FString GetContentAsString() const override { return BytesToText(Content); }
+		virtual const TArray<uint8>& GetContent() const override { return Content; }
+
+		TArray<uint8> Content;
+		EHttpRequestStatus::Type Status = EHttpRequestStatus::Processing;
+
+	private:
+		FString Url;
+		int32 ResponseCode;
+		FString ContentType;
+	};
+
+	/**
+	 * Request answered from a cassette on the core ticker, so it completes asynchronously like a live one.
+	 * Every recorded chunk is delivered as its own progress event, so stream parsing sees the recorded chunking
+	 * even when several chunks come due in one tick.
+	 */
+	class FPlayKitReplayRequest final : public IHttpRequest
+	{
+	public:
+		explicit FPlayKitReplayRequest(UPlayKitTransport* InTransport)
+			: Transport(InTransport)
+		{
+		}
+
+		//~ IHttpBase
+		virtual const FString& GetURL() const override { return Url; }
+		virtual FString GetURLParameter(const FString& ParameterName) const override { return FString(); }
+		virtual FString GetHeader(const FString& HeaderName) const override { return Headers.FindRef(HeaderName); }
+		virtual TArray<FString> GetAllHeaders() const override
+		{
+			TArray<FString> Result;
+			for (const TPair<FString, FString>& Header : Headers)
+			{
+				Result.Add(Header.Key + TEXT(": ") + Header.Value);
+			}
+			return Result;
+		}
+		virtual FString GetContentType() const override { return GetHeader(TEXT("Content-Type")); }
+		virtual uint64 GetContentLength() const override { return Content.Num(); }
+		virtual const FString& GetEffectiveURL() const override { return Url; }
+		virtual EHttpRequestStatus::Type GetStatus() const override { return Status; }
+		virtual EHttpFailureReason GetFailureReason() const override { return FailureReason; }
+
+		//~ IHttpRequest
+		virtual const TArray<uint8>& GetContent() const override { return Content; }
+		virtual FString GetVerb() const override { return Verb; }
+		virtual void SetVerb(const FString& InVerb) override { Verb = InVerb.ToUpper(); }
+		virtual void SetURL(const FString& InUrl) override { Url = InUrl; }
+		virtual void SetOption(const FName Option, const FString& OptionValue) override { Options.Add(Option, OptionValue); }
+		virtual FString GetOption(const FName Option) const override { return Options.FindRef(Option); }
+		virtual void SetContent(const TArray<uint8>& ContentPayload) override { Content = ContentPayload; }
+		virtual void SetContent(TArray<uint8>&& ContentPayload) override { Content = MoveTemp(ContentPayload); }
+		virtual void SetContentAsString(const FString& ContentString) override
+		{
+			Content.Reset();
+			AppendText(Content, ContentString);
+		}
+		virtual bool SetContentAsStreamedFile(const FString& Filename) override { return FFileHelper::LoadFileToArray(Content, *Filename); }
+		virtual bool SetContentFromStream(TSharedRef<FArchive, ESPMode::ThreadSafe> Stream) override
+		{
+			Content.SetNumUninitialized(Stream->TotalSize());
+			Stream->Serialize(Content.GetData(), Content.Num());
+			return !Stream->IsError();
+		}
+		virtual bool SetResponseBodyReceiveStream(TSharedRef<FArchive> Stream) override { return false; }
+		virtual void SetHeader(const FString& HeaderName, const FString& HeaderValue) override { Headers.Add(HeaderName, HeaderValue); }
+		virtual void AppendToHeader(const FString& HeaderName, const FString& AdditionalHeaderValue) override
+		{
+			FString& Value = Headers.FindOrAdd(HeaderName);
+			Value = Value.IsEmpty() ? AdditionalHeaderValue : Value + TEXT(", ") + AdditionalHeaderValue;
+		}
+		virtual void SetTimeout(float InTimeoutSecs) override { Timeout = InTimeoutSecs; }
+		virtual void ClearTimeout() override { Timeout.Reset(); }
+		virtual void ResetTimeoutStatus() override {}
+		virtual TOptional<float> GetTimeout() const override { return Timeout; }
+		virtual void SetActivityTimeout(float InTimeoutSecs) override {}
+
+		virtual bool ProcessRequest() override
+		{
+			if (Status == EHttpRequestStatus::Processing)
+			{
+				return false;
+			}
+
+			UPlayKitTransport* Owner = Transport.Get();
+			Entry = Owner ? Owner->FindReplayEntry(Verb, Url, Content) : nullptr;
+			TimeScale = Owner ? Owner->GetReplayTimeScale() : 1.0f;
+			Response = Entry.IsValid() ? MakeShared<FPlayKitReplayResponse>(Url, *Entry) : nullptr;
+
+			Status = EHttpRequestStatus::Processing;
+			FailureReason = EHttpFailureReason::None;
+			StartTime = FPlatformTime::Seconds();
+			NextChunk = 0;
+			bStatusCodeSent = false;
+
+			// The ticker keeps the request alive until it is done, as the HTTP manager does for live requests
+			TSharedRef<FPlayKitReplayRequest, ESPMode::ThreadSafe> Self = StaticCastSharedRef<FPlayKitReplayRequest>(AsShared());
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Self](float DeltaTime)
+			{
+				return Self->Advance();
+			}));
+			return true;
+		}
+
+		virtual FHttpRequestCompleteDelegate& OnProcessRequestComplete() override { return CompleteDelegate; }
+		virtual FHttpRequestProgressDelegate64& OnRequestProgress64() override { return ProgressDelegate; }
+		virtual FHttpRequestStatusCodeReceivedDelegate& OnStatusCodeReceived() override { return StatusCodeDelegate; }
+		virtual FHttpRequestWillRetryDelegate& OnRequestWillRetry() override { return WillRetryDelegate; }
+		virtual FHttpRequestHeaderReceivedDelegate& OnHeaderReceived() override { return HeaderReceivedDelegate; }
+
+		virtual void CancelRequest() override
+		{
+			if (Status == EHttpRequestStatus::Processing)
+			{
+				Finish(false, EHttpFailureReason::Cancelled);
+			}
+		}
+
+		virtual const FHttpResponsePtr GetResponse() const override { return Response; }
+		virtual void Tick(float DeltaSeconds) override {}
+		virtual float GetElapsedTime() const override
+		{
+			return Status == EHttpRequestStatus::Processing ? static_cast<float>(FPlatformTime::Seconds() - StartTime) : ElapsedTime;
+		}
+		virtual void SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy InThreadPolicy) override { ThreadPolicy = InThreadPolicy; }
+		virtual EHttpRequestDelegateThreadPolicy GetDelegateThreadPolicy() const override { return ThreadPolicy; }
+
+	private:
+		/** Deliver whatever has come due. Returns false once the request is finished */
+		bool Advance()
+		{
+			if (Status != EHttpRequestStatus::Processing)
+			{
+				return false;
+			}
+
+			if (!Entry.IsValid())
+			{
+				Finish(false, EHttpFailureReason::ConnectionError);
+				return false;
+			}
+
+			// Delegates may drop the last outside reference
+			TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Self = AsShared();
+
+			if (!bStatusCodeSent)
+			{
+				bStatusCodeSent = true;
+				StatusCodeDelegate.ExecuteIfBound(Self, Entry->ResponseCode);
+			}
+
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+			const TArray<uint8>& Body = Entry->ResponseBody;
+
+			while (NextChunk < Entry->Chunks.Num() && Entry->Chunks[NextChunk].Key * TimeScale <= Elapsed)
+			{
+				const int32 End = FMath::Min(Entry->Chunks[NextChunk].Value, Body.Num());
+				const int32 Start = Response->Content.Num();
+				++NextChunk;
+
+				if (End > Start)
+				{
+					Response->Content.Append(Body.GetData() + Start, End - Start);
+					ProgressDelegate.ExecuteIfBound(Self, Content.Num(), Response->Content.Num());
+					if (Status != EHttpRequestStatus::Processing)
+					{
+						// Cancelled from the callback
+						return false;
+					}
+				}
+			}
+
+			if (NextChunk < Entry->Chunks.Num() || Entry->Duration * TimeScale > Elapsed)
+			{
+				return true;
+			}
+
+			if (Response->Content.Num() < Body.Num())
+			{
+				Response->Content.Append(Body.GetData() + Response->Content.Num(), Body.Num() - Response->Content.Num());
+			}
+			Finish(true, EHttpFailureReason::None);
+			return false;
+		}
+
+		void Finish(bool bSucceeded, EHttpFailureReason Reason)
+		{
+			Status = bSucceeded ? EHttpRequestStatus::Succeeded : EHttpRequestStatus::Failed;
+			FailureReason = Reason;
+			ElapsedTime = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+			if (Response.IsValid())
+			{
+				Response->Status = Status;
+			}
+
+			CompleteDelegate.ExecuteIfBound(AsShared(), bSucceeded ? Response : nullptr, bSucceeded);
+		}
+
+	private:
+		TWeakObjectPtr<UPlayKitTransport> Transport;
+
+		FString Verb = TEXT("GET");
+		FString Url;
+		TMap<FString, FString> Headers;
+		TMap<FName, FString> Options;
+		TArray<uint8> Content;
+		TOptional<float> Timeout;
+		EHttpRequestDelegateThreadPolicy ThreadPolicy = EHttpRequestDelegateThreadPolicy::CompleteOnGameThread;
+
+		EHttpRequestStatus::Type Status = EHttpRequestStatus::NotStarted;
+		EHttpFailureReason FailureReason = EHttpFailureReason::None;
+		double StartTime = 0.0;
+		float ElapsedTime = 0.0f;
+
+		TSharedPtr<const FPlayKitCassetteEntry> Entry;
+		TSharedPtr<FPlayKitReplayResponse, ESPMode::ThreadSafe> Response;
+		float TimeScale = 1.0f;
+		int32 NextChunk = 0;
+		bool bStatusCodeSent = false;
+
+		FHttpRequestCompleteDelegate CompleteDelegate;
+		FHttpRequestProgressDelegate64 ProgressDelegate;
+		FHttpRequestStatusCodeReceivedDelegate StatusCodeDelegate;
+		FHttpRequestWillRetryDelegate WillRetryDelegate;
+		FHttpRequestHeaderReceivedDelegate HeaderReceivedDelegate;
+	};
+}
+
+void UPlayKitTransport::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UPlayKitSettings* Settings = UPlayKitSettings::Get();
+	Mode = Settings ? Settings->TransportMode : EPlayKitTransportMode::Live;
+	ReplayTimeScale = Settings ? Settings->ReplayTimeScale : 1.0f;
+	FString CassetteFile = Settings ? Settings->CassetteFile : FString();
+
+	// The command line wins, so CI can replay without touching config
+	FString ModeName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("PlayKitTransport="), ModeName))
+	{
+		const int64 Value = StaticEnum<EPlayKitTransportMode>()->GetValueByNameString(ModeName);
+		if (Value != INDEX_NONE)
+		{
+			Mode = static_cast<EPlayKitTransportMode>(Value);
+		}
+		else
+		{
+			UE_LOG(LogPlayKit, Warning, TEXT("[Transport] Unknown transport mode '%s', expected Live, Record or Replay"), *ModeName);
+		}
+	}
+	FParse::Value(FCommandLine::Get(), TEXT("PlayKitCassette="), CassetteFile);
+	FParse::Value(FCommandLine::Get(), TEXT("PlayKitReplayTimeScale="), ReplayTimeScale);
+	ReplayTimeScale = FMath::Max(0.0f, ReplayTimeScale);
+
+	if (CassetteFile.IsEmpty())
+	{
+		CassetteFile = TEXT("PlayKit/Cassettes/Default.json");
+	}
+	CassettePath = FPaths::ConvertRelativePathToFull(FPaths::IsRelative(CassetteFile)
+		? FPaths::ProjectSavedDir() / CassetteFile
+		: CassetteFile);
+
+	if (Mode == EPlayKitTransportMode::Live)
+	{
+		return;
+	}
+
+	if (Mode == EPlayKitTransportMode::Replay && !LoadCassette())
+	{
+		UE_LOG(LogPlayKit, Error, TEXT("[Transport] Could not load cassette %s; every request will fail"), *CassettePath);
+	}
+
+	UE_LOG(LogPlayKit, Log, TEXT("[Transport] %s mode, cassette %s"),
+		*StaticEnum<EPlayKitTransportMode>()->GetNameStringByValue(static_cast<int64>(Mode)), *CassettePath);
+}
+
+void UPlayKitTransport::Deinitialize()
+{
+	if (Mode == EPlayKitTransportMode::Record && bCassetteDirty)
+	{
+		SaveCassette();
+	}
+
+	Entries.Empty();
+	EntriesByRequest.Empty();
+	EntriesByPath.Empty();
+	ReplayCursors.Empty();
+
+	Super::Deinitialize();
+}
+
+UPlayKitTransport* UPlayKitTransport::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UGameInstance* GameInstance = Cast<UGameInstance>(WorldContextObject);
+	if (!GameInstance)
+	{
+		if (const UGameInstanceSubsystem* Subsystem = Cast<UGameInstanceSubsystem>(WorldContextObject))
+		{
+			GameInstance = Subsystem->GetGameInstance();
+		}
+		else if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			GameInstance = World->GetGameInstance();
+		}
+	}
+
+	return GameInstance ? GameInstance->GetSubsystem<UPlayKitTransport>() : nullptr;
+}
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UPlayKitTransport::CreateRequest(const UObject* WorldContextObject)
+{
+	UPlayKitTransport* Transport = Get(WorldContextObject);
+	if (Transport && Transport->Mode == EPlayKitTransportMode::Replay)
+	{
+		return MakeShared<FPlayKitReplayRequest>(Transport);
+	}
+
+	return FHttpModule::Get().CreateRequest();
+}
+
+//========== Recording ==========//
+
+void UPlayKitTransport::NotifyRequestStarting(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	if (Mode != EPlayKitTransportMode::Record)
+	{
+		return;
+	}
+
+	TSharedRef<FPlayKitCassetteEntry> Entry = MakeShared<FPlayKitCassetteEntry>();
+	Entry->Verb = Request->GetVerb();
+	Entry->Path = MakePath(Request->GetURL());
+	Entry->RequestHash = HashBody(Request->GetContent());
+	Entry->RequestBody = BytesToText(Request->GetContent());
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Note when each part of the response arrives, then pass progress on as before
+	FHttpRequestProgressDelegate64 InnerProgress = Request->OnRequestProgress64();
+	Request->OnRequestProgress64().BindLambda(
+		[Entry, StartTime, InnerProgress](FHttpRequestPtr ProgressRequest, uint64 BytesSent, uint64 BytesReceived)
+		{
+			const FHttpResponsePtr Response = ProgressRequest.IsValid() ? ProgressRequest->GetResponse() : nullptr;
+			const int32 Received = Response.IsValid() ? Response->GetContent().Num() : 0;
+			if (Received > (Entry->Chunks.Num() > 0 ? Entry->Chunks.Last().Value : 0))
+			{
+				Entry->Chunks.Emplace(FPlatformTime::Seconds() - StartTime, Received);
+			}
+			InnerProgress.ExecuteIfBound(ProgressRequest, BytesSent, BytesReceived);
+		});
+
+	FHttpRequestCompleteDelegate InnerComplete = Request->OnProcessRequestComplete();
+	TWeakObjectPtr<UPlayKitTransport> WeakThis(this);
+	Request->OnProcessRequestComplete().BindLambda(
+		[WeakThis, Entry, StartTime, InnerComplete](FHttpRequestPtr CompletedRequest, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			// Cancelled and failed requests have no exchange to replay
+			UPlayKitTransport* Transport = WeakThis.Get();
+			if (Transport && bWasSuccessful && Response.IsValid())
+			{
+				Entry->Duration = FPlatformTime::Seconds() - StartTime;
+				Entry->ResponseCode = Response->GetResponseCode();
+				Entry->ContentType = Response->GetContentType();
+				Entry->ResponseBody = Response->GetContent();
+				if (Entry->Chunks.Num() == 0 || Entry->Chunks.Last().Value < Entry->ResponseBody.Num())
+				{
+					Entry->Chunks.Emplace(Entry->Duration, Entry->ResponseBody.Num());
+				}
+				Transport->AddEntry(Entry);
+			}
+
+			InnerComplete.ExecuteIfBound(CompletedRequest, Response, bWasSuccessful);
+		});
+}
+
+//========== Replay ==========//
+
+TSharedPtr<const FPlayKitCassetteEntry> UPlayKitTransport::FindReplayEntry(const FString& Verb, const FString& Url, const TArray<uint8>& Body)
+{
+	const FString PathKey = Verb + TEXT(" ") + MakePath(Url);
+
+	if (TSharedPtr<const FPlayKitCassetteEntry> Exact = TakeNext(PathKey + TEXT(" ") + HashBody(Body), EntriesByRequest))
+	{
+		return Exact;
+	}
+
+	if (TSharedPtr<const FPlayKitCassetteEntry> SamePath = TakeNext(PathKey, EntriesByPath))
+	{
+		UE_LOG(LogPlayKit, Verbose, TEXT("[Transport] No exchange recorded for this body of %s, replaying the next one for the path"), *PathKey);
+		return SamePath;
+	}
+
+	UE_LOG(LogPlayKit, Warning, TEXT("[Transport] No exchange recorded for %s"), *PathKey);
+	return nullptr;
+}
+
+TSharedPtr<const FPlayKitCassetteEntry> UPlayKitTransport::TakeNext(const FString& BucketKey, const TMap<FString, TArray<int32>>& Buckets)
+{
+	const TArray<int32>* Indices = Buckets.Find(BucketKey);
+	if (!Indices || Indices->Num() == 0)
+	{
+		return nullptr;
+	}
+
+	int32& Cursor = ReplayCursors.FindOrAdd(BucketKey);
+	const int32 Index = (*Indices)[Cursor];
+	Cursor = (Cursor + 1) % Indices->Num();
+	return Entries[Index];
+}
+
+//========== Cassette ==========//
+
+void UPlayKitTransport::AddEntry(const TSharedRef<const FPlayKitCassetteEntry>& Entry)
+{
+	const int32 Index = Entries.Add(Entry);
+	const FString PathKey = Entry->Verb + TEXT(" ") + Entry->Path;
+	EntriesByPath.FindOrAdd(PathKey).Add(Index);
+	EntriesByRequest.FindOrAdd(PathKey + TEXT(" ") + Entry->RequestHash).Add(Index);
+	bCassetteDirty = true;
+}
+
+bool UPlayKitTransport::SaveCassette()
+{
+	if (Mode != EPlayKitTransportMode::Record)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[Transport] SaveCassette is only available in Record mode"));
+		return false;
+	}
+
+	int32 SizeHint = 64;
+	for (const TSharedRef<const FPlayKitCassetteEntry>& Entry : Entries)
+	{
+		SizeHint += Entry->RequestBody.Len() + Entry->ResponseBody.Num() + Entry->Chunks.Num() * 24 + 256;
+	}
+
+	FPlayKitJsonWriter Json(SizeHint);
+	Json.BeginObject();
+	Json.WriteIntField("version", CassetteVersion);
+	Json.WriteKey("interactions");
+	Json.BeginArray();
+	for (const TSharedRef<const FPlayKitCassetteEntry>& Entry : Entries)
+	{
+		Json.BeginObject();
+		Json.WriteStringField("verb", Entry->Verb);
+		Json.WriteStringField("path", Entry->Path);
+		Json.WriteStringField("requestHash", Entry->RequestHash);
+		Json.WriteStringField("requestBody", Entry->RequestBody);
+		Json.WriteIntField("status", Entry->ResponseCode);
+		Json.WriteStringField("contentType", Entry->ContentType);
+
+		// Text bodies stay readable; anything that is not valid UTF-8 is kept exact as base64
+		const FString BodyText = BytesToText(Entry->ResponseBody);
+		if (RoundTrips(Entry->ResponseBody, BodyText))
+		{
+			Json.WriteStringField("body", BodyText);
+		}
+		else
+		{
+			Json.WriteStringField("bodyBase64", FBase64::Encode(Entry->ResponseBody));
+		}
+
+		// [seconds after send, body bytes received by then]
+		Json.WriteKey("chunks");
+		Json.BeginArray();
+		for (const TPair<double, int32>& Chunk : Entry->Chunks)
+		{
+			Json.BeginArray();
+			Json.WriteNumber(Chunk.Key);
+			Json.WriteInt(Chunk.Value);
+			Json.EndArray();
+		}
+		Json.EndArray();
+
+		Json.WriteNumberField("duration", Entry->Duration);
+		Json.EndObject();
+	}
+	Json.EndArray();
+	Json.EndObject();
+
+	if (!FFileHelper::SaveArrayToFile(Json.GetBuffer(), *CassettePath))
+	{
+		UE_LOG(LogPlayKit, Error, TEXT("[Transport] Failed to write cassette %s"), *CassettePath);
+		return false;
+	}
+
+	bCassetteDirty = false;
+	UE_LOG(LogPlayKit, Log, TEXT("[Transport] Saved %d exchanges to %s"), Entries.Num(), *CassettePath);
+	return true;
+}
+
+bool UPlayKitTransport::LoadCassette()
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *CassettePath))
+	{
+		return false;
+	}
+
+	const FPlayKitJsonView Root = FPlayKitJsonView::Parse(FileData);
+	const FPlayKitJsonView Interactions = Root.Find("interactions");
+	if (!Interactions.IsArray())
+	{
+		return false;
+	}
+
+	const int32 Version = Root.Find("version").AsInt();
+	if (Version != CassetteVersion)
+	{
+		UE_LOG(LogPlayKit, Warning, TEXT("[Transport] Cassette %s has version %d, expected %d"), *CassettePath, Version, CassetteVersion);
+	}
+
+	Interactions.ForEachElement([this](const FPlayKitJsonView& Item)
+	{
+		TSharedRef<FPlayKitCassetteEntry> Entry = MakeShared<FPlayKitCassetteEntry>();
+		Entry->Verb = Item.Find("verb").AsString();
+		Entry->Path = Item.Find("path").AsString();
+		Entry->RequestBody = Item.Find("requestBody").AsString();
+		Entry->RequestHash = Item.Find("requestHash").AsString();
+		if (Entry->RequestHash.IsEmpty())
+		{
+			// Hand-written cassettes may leave the hash out
+			TArray<uint8> RequestBytes;
+			AppendText(RequestBytes, Entry->RequestBody);
+			Entry->RequestHash = HashBody(RequestBytes);
+		}
+
+		Entry->ResponseCode = Item.Find("status").AsInt();
+		Entry->ContentType = Item.Find("contentType").AsString();
+
+		FString BodyText;
+		if (Item.Find("body").TryGetString(BodyText))
+		{
+			AppendText(Entry->ResponseBody, BodyText);
+		}
+		else
+		{
+			FBase64::Decode(Item.Find("bodyBase64").AsString(), Entry->ResponseBody);
+		}
+
+		Item.Find("chunks").ForEachElement([&Entry](const FPlayKitJsonView& Chunk)
+		{
+			Entry->Chunks.Emplace(Chunk.At(0).AsNumber(), Chunk.At(1).AsInt());
+			return true;
+		});
+		Entry->Duration = Item.Find("duration").AsNumber();
+
+		AddEntry(Entry);
+		return true;
+	});
+
+	bCassetteDirty = false;
+	UE_LOG(LogPlayKit, Log, TEXT("[Transport] Loaded %d exchanges from %s"), Entries.Num(), *CassettePath);
+	return true;
+}
+
+FString UPlayKitTransport::MakePath(const FString& Url)
+{
+	const int32 SchemeEnd = Url.Find(TEXT("://"));
+	if (SchemeEnd == INDEX_NONE)
+	{
+		return Url;
+	}
+
+	const int32 PathStart = Url.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, SchemeEnd + 3);
+	return PathStart == INDEX_NONE ? FString(TEXT("/")) : Url.Mid(PathStart);
+}
+
+FString UPlayKitTransport::HashBody(const TArray<uint8>& Body)
+{
+	FSHAHash Hash;
+	FSHA1::HashBuffer(Body.GetData(), Body.Num(), Hash.Hash);
+	return Hash.ToString();
+}
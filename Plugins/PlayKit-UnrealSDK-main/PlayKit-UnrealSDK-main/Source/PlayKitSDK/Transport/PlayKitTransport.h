@@ -0,0 +1,126 @@
+// Copyright PlayKit. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/IHttpRequest.h"
+#include "PlayKitTypes.h"
+#include "PlayKitTransport.generated.h"
+
+/**
+ * One recorded request/response exchange
+ */
+struct PLAYKITSDK_API FPlayKitCassetteEntry
+{
+	FString Verb;
+
+	/** URL without scheme and host, so a cassette replays against any base URL */
+	FString Path;
+
+	/** SHA-1 of the request body */
+	FString RequestHash;
+
+	/** Request body as text, for reading and diffing cassettes. Replay matches on the hash */
+	FString RequestBody;
+
+	int32 ResponseCode = 0;
+	FString ContentType;
+	TArray<uint8> ResponseBody;
+
+	/** Arrival of the response: (seconds after send, body bytes received by then), in order */
+	TArray<TPair<double, int32>> Chunks;
+
+	/** Seconds from send to completion */
+	double Duration = 0.0;
+};
+
+/**
+ * PlayKit Transport
+ * Creates the HTTP requests of every PlayKit client, and can record them to or replay them from a cassette file.
+ *
+ * Modes:
+ * - Live: plain FHttpModule requests
+ * - Record: live requests; each completed exchange, including when each part of a streamed
+ *   response arrived, is written to the cassette when the game instance shuts down (or on SaveCassette)
+ * - Replay: requests never reach the network. Each one is answered from the cassette with the
+ *   recorded chunking and timing, scaled by the replay time scale (0 = as fast as possible)
+ *
+ * Replay matches a request on verb, path and body; if the body differs (e.g. a prompt with a
+ * timestamp), the next exchange recorded for the same verb and path is used instead. Exchanges
+ * are served round-robin, so one recording can drive any number of iterations.
+ *
+ * Configure in Project Settings > PlayKit SDK > Transport, or on the command line, which wins:
+ *   -PlayKitTransport=Replay -PlayKitCassette=Bench/Chat.json -PlayKitReplayTimeScale=0
+ *
+ * Authorization headers are never written to the cassette.
+ */
+UCLASS()
+class PLAYKITSDK_API UPlayKitTransport : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Get the subsystem instance */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Transport", meta=(WorldContext="WorldContextObject"))
+	static UPlayKitTransport* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Create a request for the current mode. Use instead of FHttpModule::Get().CreateRequest().
+	 * Falls back to a live request when no game instance is reachable from the context object.
+	 */
+	static TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateRequest(const UObject* WorldContextObject);
+
+	/** Called by the scheduler right before a request is sent. Starts recording it in Record mode */
+	void NotifyRequestStarting(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request);
+
+	/** The recorded exchange to answer a request with, or null if the cassette has none for it */
+	TSharedPtr<const FPlayKitCassetteEntry> FindReplayEntry(const FString& Verb, const FString& Url, const TArray<uint8>& Body);
+
+	//========== Status ==========//
+
+	UFUNCTION(BlueprintPure, Category="PlayKit|Transport")
+	EPlayKitTransportMode GetMode() const { return Mode; }
+
+	/** Absolute path of the cassette file */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Transport")
+	FString GetCassettePath() const { return CassettePath; }
+
+	/** Exchanges loaded (Replay) or recorded so far (Record) */
+	UFUNCTION(BlueprintPure, Category="PlayKit|Transport")
+	int32 GetCassetteEntryCount() const { return Entries.Num(); }
+
+	/** Multiplier on recorded delays during replay */
+	float GetReplayTimeScale() const { return ReplayTimeScale; }
+
+	/** Write the recorded exchanges now. Only valid in Record mode */
+	UFUNCTION(BlueprintCallable, Category="PlayKit|Transport")
+	bool SaveCassette();
+
+private:
+	bool LoadCassette();
+	void AddEntry(const TSharedRef<const FPlayKitCassetteEntry>& Entry);
+
+	/** Serve the entries of one bucket round-robin */
+	TSharedPtr<const FPlayKitCassetteEntry> TakeNext(const FString& BucketKey, const TMap<FString, TArray<int32>>& Buckets);
+
+	static FString MakePath(const FString& Url);
+	static FString HashBody(const TArray<uint8>& Body);
+
+private:
+	EPlayKitTransportMode Mode = EPlayKitTransportMode::Live;
+	FString CassettePath;
+	float ReplayTimeScale = 1.0f;
+
+	TArray<TSharedRef<const FPlayKitCassetteEntry>> Entries;
+
+	// Entry indices by "verb path hash" and by "verb path"
+	TMap<FString, TArray<int32>> EntriesByRequest;
+	TMap<FString, TArray<int32>> EntriesByPath;
+	TMap<FString, int32> ReplayCursors;
+
+	bool bCassetteDirty = false;
+};